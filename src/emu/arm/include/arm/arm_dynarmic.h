@@ -24,8 +24,10 @@
 #include <dynarmic/A32/a32.h>
 #include <dynarmic/A32/config.h>
 
+#include <array>
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 namespace eka2l1 {
     class kernel_system;
@@ -46,11 +48,31 @@ namespace eka2l1 {
         class arm_dynarmic : public arm_interface {
             friend class arm_dynarmic_callback;
 
+            /**
+             * \brief Local pages of an address space, by page index.
+             * 
+             * Dynarmic bakes the page table address into the code it generates, so all address spaces
+             * share one page table and one code cache. Global mappings live in the table directly.
+             * Local ones are recorded here, and swapped in and out of the table on address space change.
+             */
+            using local_page_map = std::map<std::uint32_t, std::uint8_t *>;
+
             arm_unicorn fallback_jit;
 
             std::unique_ptr<Dynarmic::A32::Jit> jit;
             std::unique_ptr<arm_dynarmic_callback> cb;
 
+            std::unordered_map<std::int32_t, local_page_map> local_pages;
+            std::int32_t current_addr_space;
+
+            /**
+             * \brief Put local pages of an address space in the page table, or take them out.
+             * 
+             * Code translated from pages taken out is invalidated, since the next address space
+             * may map something else at the same addresses.
+             */
+            void swap_local_pages(const local_page_map &pages, const bool load);
+
             disasm *asmdis;
             timing_system *timing;
             manager_system *mngr;
@@ -141,6 +163,18 @@ namespace eka2l1 {
             bool should_clear_old_memory_map() const override {
                 return false;
             }
+
+            bool has_addr_space_tables() const override {
+                return true;
+            }
+
+            void map_backing_mem_to_addr_space(const std::int32_t id, address vaddr, size_t size, uint8_t *ptr, prot protection) override;
+
+            void unmap_memory_from_addr_space(const std::int32_t id, address addr, size_t size) override;
+
+            void set_current_addr_space(const std::int32_t id) override;
+
+            void free_addr_space(const std::int32_t id) override;
         };
     }
 }
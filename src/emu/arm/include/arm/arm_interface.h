@@ -117,6 +117,45 @@ namespace eka2l1 {
                 return true;
             }
 
+            /*! \brief Check if the CPU keeps track of the mappings of each address space.
+             *
+             * If it does, memory can be mapped to an address space that is not the current one,
+             * and switching address space does not need the MMU to remap local chunks.
+            */
+            virtual bool has_addr_space_tables() const {
+                return false;
+            }
+
+            /*! \brief Map host memory to guest address in an address space.
+             *
+             * \param id  The address space. 0 means memory visible to all address spaces.
+            */
+            virtual void map_backing_mem_to_addr_space(const std::int32_t id, address vaddr, size_t size, uint8_t *ptr, prot protection) {
+                map_backing_mem(vaddr, size, ptr, protection);
+            }
+
+            /*! \brief Unmap guest memory from an address space.
+             *
+             * \param id  The address space. 0 means memory visible to all address spaces.
+            */
+            virtual void unmap_memory_from_addr_space(const std::int32_t id, address addr, size_t size) {
+                unmap_memory(addr, size);
+            }
+
+            /*! \brief Make the mappings of an address space current.
+             *
+             * Does nothing if the CPU doesn't track address spaces.
+            */
+            virtual void set_current_addr_space(const std::int32_t id) {
+            }
+
+            /*! \brief Forget the mappings of an address space that is no longer used.
+             *
+             * The ID may be handed out again later, it then starts with no local mappings.
+            */
+            virtual void free_addr_space(const std::int32_t id) {
+            }
+
             virtual std::uint32_t get_num_instruction_executed() = 0;
         };
     }
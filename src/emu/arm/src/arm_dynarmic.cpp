@@ -386,7 +386,9 @@ namespace eka2l1 {
             , mngr(mngr)
             , fallback_jit(kern, sys, conf, mngr, mem, asmdis, lmngr, stub)
             , cb(std::make_unique<arm_dynarmic_callback>(*this))
+            , current_addr_space(0)
             , debugger(debugger) {
+            page_dyn.fill(nullptr);
             jit = make_jit(cb, &page_dyn);
         }
 
@@ -511,26 +513,129 @@ namespace eka2l1 {
         void arm_dynarmic::page_table_changed() {
         }
 
-        void arm_dynarmic::map_backing_mem(address vaddr, size_t size, uint8_t *ptr, prot protection) {
-            const std::uint32_t psize = mem->get_page_size();
+        static void fill_dyn_pages(std::uint8_t **pages, const std::uint32_t psize, address vaddr, size_t size, uint8_t *ptr) {
             const std::uint32_t pstart = vaddr / psize;
 
             for (std::size_t i = 0; i < size / psize; i++) {
-                page_dyn[pstart + i] = ptr + i * psize;
+                pages[pstart + i] = ptr ? (ptr + i * psize) : nullptr;
             }
+        }
+
+        void arm_dynarmic::map_backing_mem(address vaddr, size_t size, uint8_t *ptr, prot protection) {
+            fill_dyn_pages(page_dyn.data(), mem->get_page_size(), vaddr, size, ptr);
 
             // fallback_jit.map_backing_mem(vaddr, size, ptr, protection);
         }
 
         void arm_dynarmic::unmap_memory(address addr, size_t size) {
+            fill_dyn_pages(page_dyn.data(), mem->get_page_size(), addr, size, nullptr);
+
+            // fallback_jit.unmap_memory(addr, size);
+        }
+
+        void arm_dynarmic::swap_local_pages(const local_page_map &pages, const bool load) {
             const std::uint32_t psize = mem->get_page_size();
-            const std::uint32_t pstart = addr / psize;
+
+            std::uint32_t run_start = 0;
+            std::uint32_t run_count = 0;
+
+            for (const auto &[page, ptr] : pages) {
+                page_dyn[page] = load ? ptr : nullptr;
+
+                if (load) {
+                    continue;
+                }
+
+                // Invalidate contiguous pages together
+                if (run_count && (run_start + run_count == page)) {
+                    run_count++;
+                    continue;
+                }
+
+                if (run_count) {
+                    jit->InvalidateCacheRange(run_start * psize, run_count * psize);
+                }
+
+                run_start = page;
+                run_count = 1;
+            }
+
+            if (run_count) {
+                jit->InvalidateCacheRange(run_start * psize, run_count * psize);
+            }
+        }
+
+        void arm_dynarmic::map_backing_mem_to_addr_space(const std::int32_t id, address vaddr, size_t size, uint8_t *ptr, prot protection) {
+            if (id == 0) {
+                // Global memory, the same in every address space
+                map_backing_mem(vaddr, size, ptr, protection);
+                return;
+            }
+
+            const std::uint32_t psize = mem->get_page_size();
+            const std::uint32_t pstart = vaddr / psize;
+
+            local_page_map &pages = local_pages[id];
 
             for (std::size_t i = 0; i < size / psize; i++) {
-                page_dyn[pstart + i] = nullptr;
+                if (ptr) {
+                    pages[static_cast<std::uint32_t>(pstart + i)] = ptr + i * psize;
+                } else {
+                    pages.erase(static_cast<std::uint32_t>(pstart + i));
+                }
             }
 
-            // fallback_jit.unmap_memory(addr, size);
+            if (id == current_addr_space) {
+                fill_dyn_pages(page_dyn.data(), psize, vaddr, size, ptr);
+            }
+        }
+
+        void arm_dynarmic::unmap_memory_from_addr_space(const std::int32_t id, address addr, size_t size) {
+            if ((id != 0) && (local_pages.find(id) == local_pages.end())) {
+                // Already freed, don't bring it back just to unmap
+                return;
+            }
+
+            map_backing_mem_to_addr_space(id, addr, size, nullptr, prot::none);
+        }
+
+        void arm_dynarmic::set_current_addr_space(const std::int32_t id) {
+            if (id == current_addr_space) {
+                return;
+            }
+
+            auto old_ite = local_pages.find(current_addr_space);
+
+            if (old_ite != local_pages.end()) {
+                swap_local_pages(old_ite->second, false);
+            }
+
+            auto new_ite = local_pages.find(id);
+
+            if (new_ite != local_pages.end()) {
+                swap_local_pages(new_ite->second, true);
+            }
+
+            current_addr_space = id;
+        }
+
+        void arm_dynarmic::free_addr_space(const std::int32_t id) {
+            if (id == 0) {
+                return;
+            }
+
+            auto ite = local_pages.find(id);
+
+            if (ite == local_pages.end()) {
+                return;
+            }
+
+            if (current_addr_space == id) {
+                swap_local_pages(ite->second, false);
+                current_addr_space = 0;
+            }
+
+            local_pages.erase(ite);
         }
 
         void arm_dynarmic::clear_instruction_cache() {
@@ -331,6 +331,7 @@ namespace eka2l1 {
 
         /**
          * \brief Count the number of leading zero bits.
+         * \returns 32 if the value is zero.
          */
         int count_leading_zero(const std::uint32_t v);
 
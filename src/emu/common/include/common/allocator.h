@@ -26,6 +26,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace eka2l1::common {
@@ -79,6 +80,100 @@ namespace eka2l1::common {
         }
     };
 
+    struct allocator_stats {
+        std::size_t free_bytes = 0;
+        std::size_t used_bytes = 0;
+        std::size_t free_blocks = 0;
+        std::size_t used_blocks = 0;
+        std::size_t largest_free_block = 0;
+
+        /*! \brief Get how scattered the free space is.
+         *
+         * \returns 0 when all free space is one block, close to 1 when it is cut
+         *          into many small ones.
+        */
+        double fragmentation() const {
+            if (free_bytes == 0) {
+                return 0.0;
+            }
+
+            return 1.0 - static_cast<double>(largest_free_block) / static_cast<double>(free_bytes);
+        }
+    };
+
+    /**
+     * \brief Two-level segregated fit allocator over a growable space.
+     *
+     * Free blocks are binned by size class, picked through two bitmaps, so allocate
+     * and free take constant time no matter how many blocks are alive. A freed block
+     * is merged with its free neighbours right away.
+     *
+     * Block headers live on the host side: the space only ever holds user data, which
+     * matters when the space is memory the guest can see.
+     */
+    class tlsf_allocator : public space_based_allocator {
+    public:
+        enum {
+            ALIGN_SIZE_LOG2 = 3,
+            ALIGN_SIZE = 1 << ALIGN_SIZE_LOG2,
+            SL_INDEX_COUNT_LOG2 = 5,
+            SL_INDEX_COUNT = 1 << SL_INDEX_COUNT_LOG2,
+            FL_INDEX_SHIFT = SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2,
+            FL_INDEX_MAX = 31,
+            FL_INDEX_COUNT = FL_INDEX_MAX - FL_INDEX_SHIFT + 1,
+            SMALL_BLOCK_SIZE = 1 << FL_INDEX_SHIFT
+        };
+
+    private:
+        struct block_node {
+            std::uint32_t offset;
+            std::uint32_t size;
+            std::uint32_t prev_phys;
+            std::uint32_t next_phys;
+            std::uint32_t prev_free;
+            std::uint32_t next_free;
+            bool free;
+        };
+
+        std::vector<block_node> nodes_;
+        std::vector<std::uint32_t> spare_nodes_;
+        std::unordered_map<std::uint32_t, std::uint32_t> used_;    ///< Offset to node of allocated blocks.
+
+        std::uint32_t fl_bitmap_;
+        std::uint32_t sl_bitmap_[FL_INDEX_COUNT];
+        std::uint32_t free_heads_[FL_INDEX_COUNT][SL_INDEX_COUNT];
+        std::uint32_t tail_;                ///< The block at the end of the space.
+
+        std::size_t free_bytes_;
+        std::size_t free_blocks_;
+        std::size_t used_bytes_;
+
+        mutable std::mutex lock_;
+
+        std::uint32_t new_node();
+        void recycle_node(const std::uint32_t idx);
+
+        void insert_free(const std::uint32_t idx);
+        void remove_free(const std::uint32_t idx);
+        void merge_next(const std::uint32_t idx);
+
+        std::uint32_t find_free(const std::uint32_t search_size);
+        void add_space(const std::size_t new_max_size);
+        bool grow(const std::uint32_t search_size);
+
+    public:
+        explicit tlsf_allocator(std::uint8_t *sptr, const std::size_t initial_max_size);
+
+        void *allocate(std::size_t bytes) override;
+        bool free(const void *ptr) override;
+
+        virtual bool expand(std::size_t target) override {
+            return false;
+        }
+
+        allocator_stats get_stats() const;
+    };
+
     struct bitmap_allocator {
         std::vector<std::uint32_t> words_;
 
@@ -102,6 +102,14 @@ namespace eka2l1::common {
         bool expect(const std::uint8_t *dat, const std::size_t s);
         void absorb_impl(std::uint8_t *dat, const std::size_t s);
 
+        /**
+         * @brief Pass over some bytes without copying them.
+         * 
+         * @returns In read mode, where the bytes are in the buffer. Null in other modes, or if
+         *          the buffer is too short.
+         */
+        std::uint8_t *skip(const std::size_t s);
+
         template <typename T>
         std::enable_if_t<std::is_integral_v<T>> absorb(T &dat) {
             absorb_impl(reinterpret_cast<std::uint8_t *>(&dat), sizeof(T));
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace eka2l1::common {
+    /**
+     * \brief Cap the rate of a loop to a number of frames per second.
+     * 
+     * Frames are due at fixed points in time, so a frame that took a bit longer is made up
+     * by the next one. When the loop falls more than a frame behind, the schedule restarts
+     * from now instead of running a burst of frames to catch up.
+     */
+    class frame_pacer {
+        using clock = std::chrono::steady_clock;
+
+        clock::duration frame_time_;
+        clock::time_point next_frame_;
+
+        bool started_;
+
+    public:
+        /**
+         * \brief Create a pacer.
+         * \param fps Target frames per second. Zero for no cap.
+         */
+        explicit frame_pacer(const std::uint32_t fps);
+
+        void set_fps(const std::uint32_t fps);
+
+        /**
+         * \brief Wait until the next frame is due.
+         * \returns True if the caller had to wait.
+         */
+        bool wait();
+    };
+}
@@ -215,4 +215,71 @@ namespace eka2l1 {
             abort_ = false;
         }
     };
+
+    /**
+     * \brief A lock-free queue with many producers and a single consumer.
+     *
+     * Producers link their node onto an atomic list head. The consumer detaches the whole list
+     * in one exchange, then walks it in the order the values were pushed.
+     */
+    template <typename T>
+    class mpsc_queue {
+        struct node {
+            T value;
+            node *next;
+        };
+
+        std::atomic<node *> head_;
+
+    public:
+        explicit mpsc_queue()
+            : head_(nullptr) {
+        }
+
+        mpsc_queue(const mpsc_queue &) = delete;
+        mpsc_queue &operator=(const mpsc_queue &) = delete;
+
+        ~mpsc_queue() {
+            consume_all([](T &) {});
+        }
+
+        void push(const T &val) {
+            node *new_node = new node{ val, head_.load(std::memory_order_relaxed) };
+
+            while (!head_.compare_exchange_weak(new_node->next, new_node, std::memory_order_release,
+                std::memory_order_relaxed)) {
+            }
+        }
+
+        bool empty() const {
+            return head_.load(std::memory_order_acquire) == nullptr;
+        }
+
+        /**
+         * \brief Pop everything currently in the queue. Must only be called from the consumer.
+         *
+         * \param func Function called with each value, in push order.
+         */
+        template <typename F>
+        void consume_all(F func) {
+            node *list = head_.exchange(nullptr, std::memory_order_acquire);
+            node *ordered = nullptr;
+
+            // The list is linked newest first, reverse it to get back the push order
+            while (list) {
+                node *next = list->next;
+                list->next = ordered;
+                ordered = list;
+                list = next;
+            }
+
+            while (ordered) {
+                node *next = ordered->next;
+                func(ordered->value);
+
+                delete ordered;
+                ordered = next;
+            }
+        }
+    };
 }
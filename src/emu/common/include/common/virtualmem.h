@@ -98,9 +98,13 @@ namespace eka2l1::common {
     /**
      * \brief Unmap a file mapped to memory
      *
+     * \param ptr  The pointer returned by map_file.
+     * \param size The size of the mapped region. Required on POSIX, where the view
+     *             can't be released without it. Use 0 if unknown.
+     *
      * \returns True on success.
     */
-    bool unmap_file(void *ptr);
+    bool unmap_file(void *ptr, const std::size_t size = 0);
 
     /**
      * \brief Returns true if the platform doesn't allow write and executable memory at the same time.
@@ -22,9 +22,69 @@
 
 #include <common/algorithm.h>
 
+#include <string>
+#include <string_view>
+
 namespace eka2l1::common {
     /**
      * \brief Convert a wildcard string to regex 
      */
     std::string wildcard_to_regex_string(std::string regexstr);
+
+    /**
+     * \brief Match a string against a wildcard pattern, without going through regex.
+     * 
+     * A '*' in the pattern matches any sequence of characters, including an empty one, and
+     * a '?' matches exactly one character.
+     * 
+     * \param str            The string to match.
+     * \param pattern        The wildcard pattern.
+     * \param case_sensitive If false, both strings are lowercased character by character while comparing.
+     * 
+     * \returns True if the whole string matches the pattern.
+     */
+    bool match_wildcard(const std::string &str, const std::string &pattern, const bool case_sensitive);
+    bool match_wildcard(const std::u16string &str, const std::u16string &pattern, const bool case_sensitive);
+
+    /**
+     * \brief Check if a pattern contains any wildcard character.
+     */
+    template <typename T>
+    bool has_wildcard(const std::basic_string<T> &pattern) {
+        return pattern.find_first_of(std::basic_string<T>{ static_cast<T>('*'), static_cast<T>('?') })
+            != std::basic_string<T>::npos;
+    }
+
+    /**
+     * \brief A wildcard pattern prepared for matching many strings.
+     * 
+     * The pattern is case-folded once, and common shapes of pattern ("*", "abc", "abc*",
+     * "*.abc") are matched without walking the generic wildcard loop. Matching never
+     * allocates.
+     */
+    class wildcard_matcher {
+        enum class pattern_kind {
+            everything,         ///< "*"
+            literal,            ///< No wildcard at all.
+            prefix,             ///< Literal followed by a single trailing star.
+            suffix,             ///< Single leading star followed by a literal.
+            generic
+        };
+
+        std::string pattern;        ///< Case-folded if matching is case-insensitive.
+        std::string fixed;          ///< The literal part, for all kinds but generic.
+
+        pattern_kind kind;
+        bool case_sensitive;
+
+        bool equal_fixed(const std::string_view str) const;
+
+    public:
+        explicit wildcard_matcher(const std::string &pattern, const bool case_sensitive = false);
+
+        /**
+         * \brief Check if the whole string matches the pattern.
+         */
+        bool match(const std::string_view str) const;
+    };
 }
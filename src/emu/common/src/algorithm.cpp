@@ -165,16 +165,17 @@ namespace eka2l1 {
         }
         
         int count_leading_zero(const std::uint32_t v) {
+            if (v == 0) {
+                return 32;
+            }
+
         #if defined(__GNUC__) || defined(__clang__)
             return __builtin_clz(v);
         #elif defined(_MSC_VER)
             DWORD lz = 0;
             _BitScanReverse(&lz, v);
 
-            if (lz != 0)
-                return static_cast<int>(31 - lz);
-
-            return 32;
+            return static_cast<int>(31 - lz);
         #endif 
         }
 
@@ -112,6 +112,340 @@ namespace eka2l1::common {
         return true;
     }
 
+    static constexpr std::uint32_t TLSF_NODE_NONE = 0xFFFFFFFF;
+    static constexpr std::uint32_t TLSF_MAX_BLOCK_SIZE = 1U << (tlsf_allocator::FL_INDEX_MAX - 1);
+
+    static int tlsf_fls(const std::uint32_t v) {
+        return find_most_significant_bit_one(v) - 1;
+    }
+
+    static int tlsf_ffs(const std::uint32_t v) {
+        return find_most_significant_bit_one(v & (~v + 1)) - 1;
+    }
+
+    static void tlsf_mapping(const std::uint32_t size, int &fl, int &sl) {
+        if (size < tlsf_allocator::SMALL_BLOCK_SIZE) {
+            fl = 0;
+            sl = static_cast<int>(size / (tlsf_allocator::SMALL_BLOCK_SIZE / tlsf_allocator::SL_INDEX_COUNT));
+            return;
+        }
+
+        fl = tlsf_fls(size);
+        sl = static_cast<int>(size >> (fl - tlsf_allocator::SL_INDEX_COUNT_LOG2)) ^ tlsf_allocator::SL_INDEX_COUNT;
+        fl -= tlsf_allocator::FL_INDEX_SHIFT - 1;
+    }
+
+    // Round the size up to the next size class, so that any block in the class found fits.
+    static std::uint32_t tlsf_search_size(const std::uint32_t size) {
+        if (size < tlsf_allocator::SMALL_BLOCK_SIZE) {
+            return size;
+        }
+
+        return size + (1U << (tlsf_fls(size) - tlsf_allocator::SL_INDEX_COUNT_LOG2)) - 1;
+    }
+
+    tlsf_allocator::tlsf_allocator(std::uint8_t *sptr, const std::size_t initial_max_size)
+        : space_based_allocator(sptr, 0)
+        , fl_bitmap_(0)
+        , tail_(TLSF_NODE_NONE)
+        , free_bytes_(0)
+        , free_blocks_(0)
+        , used_bytes_(0) {
+        std::fill(sl_bitmap_, sl_bitmap_ + FL_INDEX_COUNT, 0);
+        std::fill(&free_heads_[0][0], &free_heads_[0][0] + FL_INDEX_COUNT * SL_INDEX_COUNT, TLSF_NODE_NONE);
+
+        add_space(initial_max_size);
+    }
+
+    std::uint32_t tlsf_allocator::new_node() {
+        if (!spare_nodes_.empty()) {
+            const std::uint32_t idx = spare_nodes_.back();
+            spare_nodes_.pop_back();
+
+            return idx;
+        }
+
+        nodes_.emplace_back();
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+
+    void tlsf_allocator::recycle_node(const std::uint32_t idx) {
+        spare_nodes_.push_back(idx);
+    }
+
+    void tlsf_allocator::insert_free(const std::uint32_t idx) {
+        block_node &node = nodes_[idx];
+
+        int fl = 0;
+        int sl = 0;
+        tlsf_mapping(node.size, fl, sl);
+
+        const std::uint32_t head = free_heads_[fl][sl];
+
+        node.free = true;
+        node.prev_free = TLSF_NODE_NONE;
+        node.next_free = head;
+
+        if (head != TLSF_NODE_NONE) {
+            nodes_[head].prev_free = idx;
+        }
+
+        free_heads_[fl][sl] = idx;
+        fl_bitmap_ |= (1U << fl);
+        sl_bitmap_[fl] |= (1U << sl);
+
+        free_bytes_ += node.size;
+        free_blocks_++;
+    }
+
+    void tlsf_allocator::remove_free(const std::uint32_t idx) {
+        block_node &node = nodes_[idx];
+
+        int fl = 0;
+        int sl = 0;
+        tlsf_mapping(node.size, fl, sl);
+
+        if (node.prev_free != TLSF_NODE_NONE) {
+            nodes_[node.prev_free].next_free = node.next_free;
+        } else {
+            free_heads_[fl][sl] = node.next_free;
+        }
+
+        if (node.next_free != TLSF_NODE_NONE) {
+            nodes_[node.next_free].prev_free = node.prev_free;
+        }
+
+        if (free_heads_[fl][sl] == TLSF_NODE_NONE) {
+            sl_bitmap_[fl] &= ~(1U << sl);
+
+            if (sl_bitmap_[fl] == 0) {
+                fl_bitmap_ &= ~(1U << fl);
+            }
+        }
+
+        node.free = false;
+
+        free_bytes_ -= node.size;
+        free_blocks_--;
+    }
+
+    void tlsf_allocator::merge_next(const std::uint32_t idx) {
+        const std::uint32_t next = nodes_[idx].next_phys;
+        const std::uint32_t after = nodes_[next].next_phys;
+
+        nodes_[idx].size += nodes_[next].size;
+        nodes_[idx].next_phys = after;
+
+        if (after != TLSF_NODE_NONE) {
+            nodes_[after].prev_phys = idx;
+        } else {
+            tail_ = idx;
+        }
+
+        recycle_node(next);
+    }
+
+    std::uint32_t tlsf_allocator::find_free(const std::uint32_t search_size) {
+        int fl = 0;
+        int sl = 0;
+        tlsf_mapping(search_size, fl, sl);
+
+        if (fl >= FL_INDEX_COUNT) {
+            return TLSF_NODE_NONE;
+        }
+
+        std::uint32_t sl_map = sl_bitmap_[fl] & (~0U << sl);
+
+        if (!sl_map) {
+            // Nothing left in this class, take the smallest class above
+            const std::uint32_t fl_map = (fl + 1 < 32) ? (fl_bitmap_ & (~0U << (fl + 1))) : 0;
+
+            if (!fl_map) {
+                return TLSF_NODE_NONE;
+            }
+
+            fl = tlsf_ffs(fl_map);
+            sl_map = sl_bitmap_[fl];
+        }
+
+        return free_heads_[fl][tlsf_ffs(sl_map)];
+    }
+
+    void tlsf_allocator::add_space(const std::size_t new_max_size) {
+        const std::uint32_t space_end = (tail_ == TLSF_NODE_NONE) ? 0 : (nodes_[tail_].offset + nodes_[tail_].size);
+        const std::uint32_t new_end = static_cast<std::uint32_t>(common::min<std::size_t>(new_max_size,
+                                          TLSF_MAX_BLOCK_SIZE) & ~static_cast<std::size_t>(ALIGN_SIZE - 1));
+
+        max_size = new_max_size;
+
+        if (new_end <= space_end) {
+            return;
+        }
+
+        if ((tail_ != TLSF_NODE_NONE) && nodes_[tail_].free) {
+            // Extend the free block at the end
+            remove_free(tail_);
+            nodes_[tail_].size += new_end - space_end;
+            insert_free(tail_);
+
+            return;
+        }
+
+        const std::uint32_t idx = new_node();
+        block_node &node = nodes_[idx];
+
+        node.offset = space_end;
+        node.size = new_end - space_end;
+        node.prev_phys = tail_;
+        node.next_phys = TLSF_NODE_NONE;
+
+        if (tail_ != TLSF_NODE_NONE) {
+            nodes_[tail_].next_phys = idx;
+        }
+
+        tail_ = idx;
+        insert_free(idx);
+    }
+
+    bool tlsf_allocator::grow(const std::uint32_t search_size) {
+        std::size_t needed = search_size;
+
+        if ((tail_ != TLSF_NODE_NONE) && nodes_[tail_].free) {
+            needed -= common::min<std::size_t>(needed, nodes_[tail_].size);
+        }
+
+        // Over-commit to keep the number of expands low, but settle for just what is needed
+        // if the space can't stretch that much.
+        std::size_t target = common::max(max_size * 2, max_size + needed);
+
+        if (!expand(target)) {
+            target = max_size + needed;
+
+            if (!expand(target)) {
+                return false;
+            }
+        }
+
+        add_space(target);
+        return true;
+    }
+
+    void *tlsf_allocator::allocate(std::size_t bytes) {
+        if (bytes >= TLSF_MAX_BLOCK_SIZE) {
+            return nullptr;
+        }
+
+        const std::uint32_t size = common::max<std::uint32_t>(ALIGN_SIZE,
+            static_cast<std::uint32_t>((bytes + ALIGN_SIZE - 1) & ~static_cast<std::size_t>(ALIGN_SIZE - 1)));
+        const std::uint32_t search_size = tlsf_search_size(size);
+
+        const std::lock_guard<std::mutex> guard(lock_);
+
+        std::uint32_t idx = find_free(search_size);
+
+        if (idx == TLSF_NODE_NONE) {
+            if (!grow(search_size)) {
+                return nullptr;
+            }
+
+            idx = find_free(search_size);
+
+            if (idx == TLSF_NODE_NONE) {
+                return nullptr;
+            }
+        }
+
+        remove_free(idx);
+
+        if (nodes_[idx].size - size >= ALIGN_SIZE) {
+            // Give the rest back as a new free block
+            const std::uint32_t rest = new_node();
+            const std::uint32_t next = nodes_[idx].next_phys;
+
+            nodes_[rest].offset = nodes_[idx].offset + size;
+            nodes_[rest].size = nodes_[idx].size - size;
+            nodes_[rest].prev_phys = idx;
+            nodes_[rest].next_phys = next;
+
+            if (next != TLSF_NODE_NONE) {
+                nodes_[next].prev_phys = rest;
+            } else {
+                tail_ = rest;
+            }
+
+            nodes_[idx].size = size;
+            nodes_[idx].next_phys = rest;
+
+            insert_free(rest);
+        }
+
+        used_.emplace(nodes_[idx].offset, idx);
+        used_bytes_ += nodes_[idx].size;
+
+        return ptr + nodes_[idx].offset;
+    }
+
+    bool tlsf_allocator::free(const void *tptr) {
+        const std::uint8_t *to_free = reinterpret_cast<const std::uint8_t *>(tptr);
+
+        if ((to_free < ptr) || (to_free >= ptr + max_size)) {
+            return false;
+        }
+
+        const std::lock_guard<std::mutex> guard(lock_);
+
+        auto ite = used_.find(static_cast<std::uint32_t>(to_free - ptr));
+
+        if (ite == used_.end()) {
+            return false;
+        }
+
+        std::uint32_t idx = ite->second;
+        used_.erase(ite);
+        used_bytes_ -= nodes_[idx].size;
+
+        const std::uint32_t prev = nodes_[idx].prev_phys;
+
+        if ((prev != TLSF_NODE_NONE) && nodes_[prev].free) {
+            remove_free(prev);
+            merge_next(prev);
+
+            idx = prev;
+        }
+
+        const std::uint32_t next = nodes_[idx].next_phys;
+
+        if ((next != TLSF_NODE_NONE) && nodes_[next].free) {
+            remove_free(next);
+            merge_next(idx);
+        }
+
+        insert_free(idx);
+        return true;
+    }
+
+    allocator_stats tlsf_allocator::get_stats() const {
+        const std::lock_guard<std::mutex> guard(lock_);
+
+        allocator_stats stats;
+        stats.free_bytes = free_bytes_;
+        stats.free_blocks = free_blocks_;
+        stats.used_bytes = used_bytes_;
+        stats.used_blocks = used_.size();
+
+        if (fl_bitmap_) {
+            // The biggest block sits in the highest non-empty class
+            const int fl = tlsf_fls(fl_bitmap_);
+            const int sl = tlsf_fls(sl_bitmap_[fl]);
+
+            for (std::uint32_t idx = free_heads_[fl][sl]; idx != TLSF_NODE_NONE; idx = nodes_[idx].next_free) {
+                stats.largest_free_block = common::max<std::size_t>(stats.largest_free_block, nodes_[idx].size);
+            }
+        }
+
+        return stats;
+    }
+
     bitmap_allocator::bitmap_allocator(const std::size_t total_bits)
         : words_((total_bits >> 5) + ((total_bits % 32 != 0) ? 1 : 0), 0xFFFFFFFF) {
     }
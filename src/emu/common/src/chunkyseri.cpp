@@ -52,6 +52,17 @@ namespace eka2l1::common {
         buf += s;
     }
 
+    std::uint8_t *chunkyseri::skip(const std::size_t s) {
+        if (buf + s > end && mode != SERI_MODE_MEASURE) {
+            return nullptr;
+        }
+
+        std::uint8_t *skipped = (mode == SERI_MODE_READ) ? buf : nullptr;
+        buf += s;
+
+        return skipped;
+    }
+
     bool chunkyseri::expect(const std::uint8_t *dat, const std::size_t s) {
         switch (mode) {
         case SERI_MODE_MEASURE:
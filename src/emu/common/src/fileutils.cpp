@@ -223,6 +223,8 @@ namespace eka2l1::common {
         if (detail) {
             entry.size = (fdata_win32->nFileSizeLow | (__int64)fdata_win32->nFileSizeHigh << 32);
             entry.type = get_file_type_from_attrib_platform_specific(fdata_win32->dwFileAttributes);
+            entry.last_write = convert_microsecs_win32_1601_epoch_to_1ad(
+                static_cast<std::uint64_t>(fdata_win32->ftLastWriteTime.dwLowDateTime) | (static_cast<std::uint64_t>(fdata_win32->ftLastWriteTime.dwHighDateTime) << 32));
         }
 
         do {
@@ -234,8 +236,18 @@ namespace eka2l1::common {
         entry.name = d->d_name;
 
         if (detail) {
-            entry.size = file_size(dir_name + "/" + entry.name);
-            entry.type = get_file_type(dir_name + "/" + entry.name);
+            // Stat once for all details
+            struct stat st;
+
+            if (stat((dir_name + "/" + entry.name).c_str(), &st) == -1) {
+                entry.size = 0;
+                entry.type = FILE_INVALID;
+                entry.last_write = 0;
+            } else {
+                entry.size = static_cast<std::size_t>(st.st_size);
+                entry.type = get_file_type_from_attrib_platform_specific(st.st_mode);
+                entry.last_write = convert_microsecs_epoch_to_1ad(static_cast<std::uint64_t>(st.st_mtime));
+            }
         }
 
         do {
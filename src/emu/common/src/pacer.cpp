@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <common/pacer.h>
+
+#include <thread>
+
+namespace eka2l1::common {
+    frame_pacer::frame_pacer(const std::uint32_t fps)
+        : started_(false) {
+        set_fps(fps);
+    }
+
+    void frame_pacer::set_fps(const std::uint32_t fps) {
+        frame_time_ = fps ? std::chrono::duration_cast<clock::duration>(std::chrono::seconds(1)) / fps
+            : clock::duration::zero();
+        started_ = false;
+    }
+
+    bool frame_pacer::wait() {
+        if (frame_time_ == clock::duration::zero()) {
+            return false;
+        }
+
+        const clock::time_point now = clock::now();
+
+        if (!started_) {
+            started_ = true;
+            next_frame_ = now + frame_time_;
+
+            return false;
+        }
+
+        if (now >= next_frame_) {
+            // Late. Restart the schedule if a whole frame was missed, else keep the cadence.
+            next_frame_ = (now - next_frame_ >= frame_time_) ? (now + frame_time_) : (next_frame_ + frame_time_);
+            return false;
+        }
+
+        std::this_thread::sleep_until(next_frame_);
+        next_frame_ += frame_time_;
+
+        return true;
+    }
+}
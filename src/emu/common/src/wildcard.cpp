@@ -21,6 +21,9 @@
 #include <common/algorithm.h>
 #include <common/wildcard.h>
 
+#include <cctype>
+#include <cwctype>
+
 namespace eka2l1::common {
     std::string wildcard_to_regex_string(std::string regexstr) {
         regexstr = replace_all(regexstr, "\\", "\\\\");
@@ -30,4 +33,128 @@ namespace eka2l1::common {
 
         return regexstr;
     }
+
+    static char fold_char(const char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    static char16_t fold_char(const char16_t c) {
+        return static_cast<char16_t>(std::towlower(c));
+    }
+
+    template <typename T>
+    static bool match_wildcard_impl(const std::basic_string_view<T> str, const std::basic_string_view<T> pattern, const bool case_sensitive) {
+        std::size_t s = 0;
+        std::size_t p = 0;
+
+        // Position after the last star seen, and the string position it was tried against.
+        // On mismatch, let that star swallow one more character and retry from there.
+        std::size_t star_p = std::basic_string_view<T>::npos;
+        std::size_t star_s = 0;
+
+        auto char_equal = [case_sensitive](const T lhs, const T rhs) {
+            return (lhs == rhs) || (!case_sensitive && (fold_char(lhs) == fold_char(rhs)));
+        };
+
+        while (s < str.length()) {
+            if (p < pattern.length() && pattern[p] == static_cast<T>('*')) {
+                star_p = ++p;
+                star_s = s;
+            } else if (p < pattern.length() && (pattern[p] == static_cast<T>('?') || char_equal(pattern[p], str[s]))) {
+                p++;
+                s++;
+            } else if (star_p != std::basic_string_view<T>::npos) {
+                p = star_p;
+                s = ++star_s;
+            } else {
+                return false;
+            }
+        }
+
+        while (p < pattern.length() && pattern[p] == static_cast<T>('*')) {
+            p++;
+        }
+
+        return p == pattern.length();
+    }
+
+    bool match_wildcard(const std::string &str, const std::string &pattern, const bool case_sensitive) {
+        return match_wildcard_impl<char>(str, pattern, case_sensitive);
+    }
+
+    bool match_wildcard(const std::u16string &str, const std::u16string &pattern, const bool case_sensitive) {
+        return match_wildcard_impl<char16_t>(str, pattern, case_sensitive);
+    }
+
+    wildcard_matcher::wildcard_matcher(const std::string &pattern, const bool case_sensitive)
+        : pattern(pattern)
+        , kind(pattern_kind::generic)
+        , case_sensitive(case_sensitive) {
+        if (!case_sensitive) {
+            for (char &c : this->pattern) {
+                c = fold_char(c);
+            }
+        }
+
+        const std::string &folded = this->pattern;
+        const std::size_t first_wildcard = folded.find_first_of("*?");
+
+        if (first_wildcard == std::string::npos) {
+            kind = pattern_kind::literal;
+            fixed = folded;
+
+            return;
+        }
+
+        // Only patterns with a single star at either end get a fast path
+        if ((folded.find('?') != std::string::npos) || (folded.find('*', first_wildcard + 1) != std::string::npos)) {
+            return;
+        }
+
+        if (folded.length() == 1) {
+            kind = pattern_kind::everything;
+        } else if (first_wildcard == folded.length() - 1) {
+            kind = pattern_kind::prefix;
+            fixed = folded.substr(0, first_wildcard);
+        } else if (first_wildcard == 0) {
+            kind = pattern_kind::suffix;
+            fixed = folded.substr(1);
+        }
+    }
+
+    bool wildcard_matcher::equal_fixed(const std::string_view str) const {
+        if (str.length() != fixed.length()) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < str.length(); i++) {
+            if ((case_sensitive ? str[i] : fold_char(str[i])) != fixed[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool wildcard_matcher::match(const std::string_view str) const {
+        switch (kind) {
+        case pattern_kind::everything:
+            return true;
+
+        case pattern_kind::literal:
+            return equal_fixed(str);
+
+        case pattern_kind::prefix:
+            return (str.length() >= fixed.length()) && equal_fixed(str.substr(0, fixed.length()));
+
+        case pattern_kind::suffix:
+            return (str.length() >= fixed.length()) && equal_fixed(str.substr(str.length() - fixed.length()));
+
+        default:
+            break;
+        }
+
+        // The pattern is already folded, folding it again while comparing is harmless
+        return match_wildcard_impl<char>(str, pattern, case_sensitive);
+    }
 }
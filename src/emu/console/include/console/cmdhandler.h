@@ -33,6 +33,9 @@ bool help_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std
 bool rpkg_unpack_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std::string *err);
 bool list_app_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std::string *err);
 bool list_devices_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std::string *err);
+bool headless_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std::string *err);
+bool load_state_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std::string *err);
+bool save_state_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std::string *err);
 
 #if ENABLE_SCRIPTING
 bool python_docgen_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std::string *err);
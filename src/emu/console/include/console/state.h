@@ -25,6 +25,7 @@
 #include <mutex>
 #include <thread>
 #include <queue>
+#include <string>
 
 #include <common/queue.h>
 #include <common/sync.h>
@@ -71,6 +72,12 @@ namespace eka2l1::desktop {
 
         bool first_time;
 
+        bool headless;                      ///< Run without a window or GPU, as fast as possible.
+        std::uint32_t headless_seconds;     ///< Stop a headless run after this many host seconds. Zero to run until the guest exits.
+
+        std::string load_state_path;        ///< State file to restore once the apps are launched. Empty for none.
+        std::string save_state_path;        ///< State file to write when the emulation stops. Empty for none.
+
         common::semaphore graphics_sema;
 
         manager::config_state conf;
@@ -81,5 +88,12 @@ namespace eka2l1::desktop {
 
         void stage_one();
         void stage_two();
+
+        /**
+         * \brief Create the audio driver.
+         * 
+         * Done after the command line is parsed, since a headless run always uses the null backend.
+         */
+        void init_audio();
     };
 }
\ No newline at end of file
@@ -49,6 +49,16 @@ namespace eka2l1::desktop {
      */
     void os_thread(emulator &state);
 
+    /**
+     * \brief Entry to a headless run of the emulator.
+     *
+     * The OS is emulated on the calling thread as fast as possible, with null graphics and audio
+     * drivers. Throughput is printed every second.
+     *
+     * \param state State of the emulator.
+     */
+    int headless_entry(emulator &state);
+
     /**
      * \brief Entry to emulator.
      *
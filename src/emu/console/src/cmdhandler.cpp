@@ -35,6 +35,10 @@
 #include <epoc/services/applist/applist.h>
 #include <epoc/kernel.h>
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
 using namespace eka2l1;
 
 bool app_install_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std::string *err) {
@@ -244,6 +248,46 @@ bool list_devices_option_handler(eka2l1::common::arg_parser *parser, void *userd
     return false;
 }
 
+bool headless_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std::string *err) {
+    desktop::emulator *emu = reinterpret_cast<desktop::emulator *>(userdata);
+    emu->headless = true;
+
+    // An optional time limit, in seconds
+    const char *seconds = parser->peek_token();
+
+    if (seconds && (std::strlen(seconds) > 0) && std::all_of(seconds, seconds + std::strlen(seconds), ::isdigit)) {
+        emu->headless_seconds = common::pystr(parser->next_token()).as_int<std::uint32_t>();
+    }
+
+    return true;
+}
+
+bool load_state_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std::string *err) {
+    desktop::emulator *emu = reinterpret_cast<desktop::emulator *>(userdata);
+    const char *path = parser->next_token();
+
+    if (!path) {
+        *err = "Request to load a state, but path not given";
+        return false;
+    }
+
+    emu->load_state_path = path;
+    return true;
+}
+
+bool save_state_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std::string *err) {
+    desktop::emulator *emu = reinterpret_cast<desktop::emulator *>(userdata);
+    const char *path = parser->next_token();
+
+    if (!path) {
+        *err = "Request to save a state, but path not given";
+        return false;
+    }
+
+    emu->save_state_path = path;
+    return true;
+}
+
 #if ENABLE_SCRIPTING
 bool python_docgen_option_handler(eka2l1::common::arg_parser *parser, void *userdata, std::string *err) {
     try {
@@ -107,7 +107,18 @@ int main(int argc, char **argv) {
             app_specifier_option_handler);
 
         parser.add("--install, --i", "Install a SIS.", app_install_option_handler);
+        parser.add("--headless", "Run without a window or GPU, as fast as possible, and print throughput.\n"
+                                 "\t\t\t  An optional number of seconds stops the run after that long.\n"
+                                 "\n"
+                                 "\t\t\t  Some example:\n"
+                                 "\t\t\t    eka2l1 --headless 60 --run Bounce\n",
+            headless_option_handler);
         parser.add("--remove, --r", "Remove an package.", package_remove_option_handler);
+        parser.add("--loadstate", "Restore a state file after the apps given with --run are launched.\n"
+                                  "\t\t\t  The state must come from the same apps on the same device.\n"
+                                  "\t\t\t  Experimental: only guest memory, threads and the clock are restored.",
+            load_state_option_handler);
+        parser.add("--savestate", "Write a state file when the emulation stops.", save_state_option_handler);
 
 #if ENABLE_SCRIPTING
         parser.add("--gendocs", "Generate Python documentation", python_docgen_option_handler);
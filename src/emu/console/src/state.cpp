@@ -46,6 +46,10 @@ namespace eka2l1::desktop {
         symsys->init();
 
         first_time = true;
+        headless = false;
+        headless_seconds = 0;
+        load_state_path.clear();
+        save_state_path.clear();
         launch_requests.max_pending_count_ = 100;
 
         // Make debugger. Go watch Case Closed.
@@ -92,11 +96,19 @@ namespace eka2l1::desktop {
             symsys->mount(drive_z, drive_media::rom,
                 eka2l1::add_path(conf.storage, "/drives/z/"), io_attrib::internal | io_attrib::write_protected);
 
-            // Create audio driver
-            audio_driver = drivers::make_audio_driver(drivers::audio_driver_backend::cubeb);
-            symsys->set_audio_driver(audio_driver.get());
-
             stage_two_inited = true;
         }
     }
+
+    void emulator::init_audio() {
+        if (audio_driver) {
+            return;
+        }
+
+        const drivers::audio_driver_backend audio_backend = (headless || (conf.audio_backend == "null")) ?
+            drivers::audio_driver_backend::null : drivers::audio_driver_backend::cubeb;
+
+        audio_driver = drivers::make_audio_driver(audio_backend, conf.audio_dump_path);
+        symsys->set_audio_driver(audio_driver.get());
+    }
 }
\ No newline at end of file
@@ -18,6 +18,7 @@
  */
 
 #include <common/configure.h>
+#include <common/pacer.h>
 #include <common/version.h>
 #include <common/cvt.h>
 #include <common/log.h>
@@ -32,13 +33,23 @@
 #include <debugger/logger.h>
 #include <debugger/renderer/renderer.h>
 
+#include <drivers/audio/mixer.h>
+#include <drivers/audio/backend/null/audio_null.h>
 #include <drivers/graphics/emu_window.h>
 #include <drivers/graphics/graphics.h>
 #include <drivers/input/common.h>
 
+#include <epoc/kernel.h>
 #include <epoc/services/window/window.h>
+#include <epoc/timing.h>
 #include <e32keys.h>
 
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
 void set_mouse_down(void *userdata, const int button, const bool op) {
     eka2l1::desktop::emulator *emu = reinterpret_cast<eka2l1::desktop::emulator *>(userdata);
 
@@ -326,6 +337,9 @@ namespace eka2l1::desktop {
 
         state.deb_renderer->init(state.graphics_driver.get(), cmd_builder.get(), state.debugger.get());
 
+        // The UI only paces itself, the OS thread runs on its own
+        common::frame_pacer pacer(static_cast<std::uint32_t>(std::max(state.conf.ui_fps_limit, 0)));
+
         while (!state.should_ui_quit) {
             const vec2 nws = state.window->window_size();
             const vec2 nwsb = state.window->window_fb_size();
@@ -369,6 +383,8 @@ namespace eka2l1::desktop {
             // Recreate the list and builder
             cmd_list = state.graphics_driver->new_command_list();
             cmd_builder = state.graphics_driver->new_command_builder(cmd_list.get());
+
+            pacer.wait();
         }
 
         result = ui_thread_deinitialization(state);
@@ -412,6 +428,29 @@ namespace eka2l1::desktop {
         state.graphics_sema.notify(2);
     }
 
+    static bool restore_requested_state(emulator &state) {
+        if (state.load_state_path.empty()) {
+            return true;
+        }
+
+        if (!state.symsys->load_state(state.load_state_path)) {
+            std::cout << "Failed to restore state from " << state.load_state_path << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    static void save_requested_state(emulator &state) {
+        if (state.save_state_path.empty()) {
+            return;
+        }
+
+        if (!state.symsys->save_state(state.save_state_path)) {
+            std::cout << "Failed to save state to " << state.save_state_path << std::endl;
+        }
+    }
+
     void os_thread(emulator &state) {
         eka2l1::common::set_thread_name(os_thread_name);
 
@@ -420,6 +459,10 @@ namespace eka2l1::desktop {
         //_set_se_translator(seh_handler_translator_func);
 #endif
 
+        if (!restore_requested_state(state)) {
+            state.should_emu_quit = true;
+        }
+
         // TODO: Multi core. Currently it's single core.
         while (!state.should_emu_quit) {
             try {
@@ -437,11 +480,176 @@ namespace eka2l1::desktop {
             }
         }
 
+        save_requested_state(state);
+        state.symsys.reset();
+    }
+
+    static void print_throughput(const system_stats &from, const system_stats &to, const double seconds) {
+        if (seconds <= 0.0) {
+            return;
+        }
+
+        const double mips = static_cast<double>(to.instructions - from.instructions) / seconds / 1000000.0;
+        const double fps = static_cast<double>(to.frames - from.frames) / seconds;
+        const double ipc = static_cast<double>(to.ipc_messages - from.ipc_messages) / seconds;
+
+        std::cout << std::fixed << std::setprecision(2) << "Guest: " << mips << " MIPS, " << fps << " frames/s, "
+                  << ipc << " IPC messages/s" << std::endl;
+    }
+
+    // The busiest servers, and the opcodes that keep them busy
+    static void print_ipc_throughput(kernel_system *kern, const double seconds) {
+        static constexpr std::size_t MAX_SERVERS_SHOWN = 5;
+        static constexpr std::size_t MAX_OPCODES_SHOWN = 3;
+
+        if (seconds <= 0.0) {
+            return;
+        }
+
+        std::vector<service::server *> servers;
+
+        for (auto &obj : kern->get_server_list()) {
+            service::server *svr = reinterpret_cast<service::server *>(obj.get());
+
+            if (svr->get_total_delivered() != 0) {
+                servers.push_back(svr);
+            }
+        }
+
+        std::sort(servers.begin(), servers.end(), [](service::server *lhs, service::server *rhs) {
+            return lhs->get_total_delivered() > rhs->get_total_delivered();
+        });
+
+        if (servers.size() > MAX_SERVERS_SHOWN) {
+            servers.resize(MAX_SERVERS_SHOWN);
+        }
+
+        for (service::server *svr : servers) {
+            const auto &per_opcode = svr->get_opcode_delivered();
+            std::vector<std::pair<int, std::uint64_t>> opcodes(per_opcode.begin(), per_opcode.end());
+
+            std::sort(opcodes.begin(), opcodes.end(), [](const auto &lhs, const auto &rhs) {
+                return lhs.second > rhs.second;
+            });
+
+            if (opcodes.size() > MAX_OPCODES_SHOWN) {
+                opcodes.resize(MAX_OPCODES_SHOWN);
+            }
+
+            std::cout << std::fixed << std::setprecision(2) << "  " << svr->name() << ": "
+                      << static_cast<double>(svr->get_total_delivered()) / seconds << " messages/s";
+
+            for (const auto &[opcode, count] : opcodes) {
+                std::cout << ", opcode " << opcode << ": " << static_cast<double>(count) / seconds << "/s";
+            }
+
+            std::cout << std::endl;
+        }
+    }
+
+    int headless_entry(emulator &state) {
+        eka2l1::common::set_thread_name(os_thread_name);
+
+        state.graphics_driver = drivers::create_graphics_driver(drivers::graphic_api::null);
+        state.symsys->set_graphics_driver(state.graphics_driver.get());
+
+        // Nothing plays audio in real time. It is rendered as guest time passes, so a dump of it
+        // is the same between runs.
+        drivers::null_audio_driver *null_audio = nullptr;
+
+        if (drivers::audio_mixer *mixer = dynamic_cast<drivers::audio_mixer *>(state.audio_driver.get())) {
+            null_audio = dynamic_cast<drivers::null_audio_driver *>(mixer->backend());
+        }
+
+        // Launch what the command line asked for
+        while (std::optional<std::u16string> launch = state.launch_requests.pop(1)) {
+            state.symsys->load(launch.value(), u"");
+        }
+
+        if (!restore_requested_state(state)) {
+            state.symsys.reset();
+            state.graphics_driver.reset();
+
+            return -1;
+        }
+
+        using clock = std::chrono::steady_clock;
+
+        // Reading the clock every loop costs more than a short loop itself
+        static constexpr std::uint32_t LOOPS_PER_CHECK = 256;
+
+        timing_system *timing = state.symsys->get_timing_system();
+        std::uint64_t audio_frames_rendered = 0;
+        std::uint32_t loops = 0;
+
+        const clock::time_point start = clock::now();
+        clock::time_point last_report = start;
+
+        const system_stats start_stats = state.symsys->get_stats();
+        system_stats last_stats = start_stats;
+
+        while (!state.should_emu_quit) {
+            try {
+                if (state.symsys->loop() == 0) {
+                    break;
+                }
+            } catch (std::exception &exc) {
+                std::cout << "Main loop exited with exception: " << exc.what() << std::endl;
+                break;
+            }
+
+            if (++loops % LOOPS_PER_CHECK != 0) {
+                continue;
+            }
+
+            if (null_audio) {
+                const std::uint64_t audio_frames_due = timing->get_global_time_us() * null_audio->native_sample_rate() / 1000000;
+
+                if (audio_frames_due > audio_frames_rendered) {
+                    null_audio->render(nullptr, static_cast<std::size_t>(audio_frames_due - audio_frames_rendered));
+                    audio_frames_rendered = audio_frames_due;
+                }
+            }
+
+            const clock::time_point now = clock::now();
+
+            if (now - last_report >= std::chrono::seconds(1)) {
+                const system_stats stats = state.symsys->get_stats();
+                print_throughput(last_stats, stats, std::chrono::duration<double>(now - last_report).count());
+
+                last_stats = stats;
+                last_report = now;
+            }
+
+            if (state.headless_seconds && (now - start >= std::chrono::seconds(state.headless_seconds))) {
+                break;
+            }
+        }
+
+        const double total_seconds = std::chrono::duration<double>(clock::now() - start).count();
+        const system_stats end_stats = state.symsys->get_stats();
+
+        std::cout << "Headless run finished after " << std::fixed << std::setprecision(2) << total_seconds
+                  << " seconds, " << end_stats.frames - start_stats.frames << " frames, "
+                  << end_stats.ipc_messages - start_stats.ipc_messages << " IPC messages" << std::endl;
+
+        print_throughput(start_stats, end_stats, total_seconds);
+        print_ipc_throughput(state.symsys->get_kernel_system(), total_seconds);
+
+        save_requested_state(state);
         state.symsys.reset();
+        state.graphics_driver.reset();
+
+        return 0;
     }
 
     int emulator_entry(emulator &state) {
         state.stage_two();
+        state.init_audio();
+
+        if (state.headless) {
+            return headless_entry(state);
+        }
 
         // First, initialize the graphics driver. This is needed for all graphics operations on the emulator.
         std::thread graphics_thread_obj(graphics_driver_thread, std::ref(state));
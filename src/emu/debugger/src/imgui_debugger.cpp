@@ -513,7 +513,9 @@ namespace eka2l1 {
 
         ImGui::Checkbox("Symbian API", &conf->log_passed);
         ImGui::SameLine(col2);
-        ImGui::Checkbox("System calls", &conf->log_svc);
+        if (ImGui::Checkbox("System calls", &conf->log_svc)) {
+            sys->get_lib_manager()->set_svc_logging(conf->log_svc);
+        }
 
         ImGui::NewLine();
         ImGui::Text("System");
@@ -23,6 +23,7 @@
 #include <drivers/audio/stream.h>
 
 #include <cstdint>
+#include <string>
 
 namespace eka2l1::drivers {
     class audio_driver: public driver {
@@ -49,8 +50,20 @@ namespace eka2l1::drivers {
     };
 
     enum class audio_driver_backend {
-        cubeb
+        cubeb,
+        null
     };
 
-    std::unique_ptr<audio_driver> make_audio_driver(const audio_driver_backend backend);
+    /**
+     * \brief Create an audio driver.
+     * 
+     * The backend is put behind a mixer, so all streams created on the returned driver
+     * share one output stream of the backend.
+     * 
+     * \param backend       The backend to output to.
+     * \param dump_path     Host path of a WAV file to dump the output to. Only used by the null backend.
+     * 
+     * \returns The driver on success.
+     */
+    std::unique_ptr<audio_driver> make_audio_driver(const audio_driver_backend backend, const std::string &dump_path = "");
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <drivers/audio/audio.h>
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace eka2l1::drivers {
+    class null_audio_driver;
+
+    struct null_audio_output_stream: public audio_output_stream {
+    private:
+        friend class null_audio_driver;
+
+        null_audio_driver *driver_;
+        data_callback callback_;
+        bool playing_;
+        float volume_;
+
+    public:
+        explicit null_audio_output_stream(null_audio_driver *driver, data_callback callback);
+        ~null_audio_output_stream() override;
+
+        bool start() override;
+        bool stop() override;
+
+        bool is_playing() override;
+
+        bool set_volume(const float volume) override;
+    };
+
+    /**
+     * \brief An audio driver without a device.
+     * 
+     * Nothing is played in real time. Streams only advance when render is called, so the
+     * output only depends on how many frames were asked for. The output can be dumped to
+     * a WAV file to be compared between runs.
+     */
+    class null_audio_driver: public audio_driver {
+        friend struct null_audio_output_stream;
+
+        std::uint32_t sample_rate_;
+
+        std::mutex lock_;
+        std::vector<null_audio_output_stream *> streams_;
+
+        std::vector<std::int32_t> mix_buffer_;
+        std::vector<std::int16_t> stream_buffer_;
+        std::vector<std::int16_t> output_buffer_;
+
+        std::ofstream dump_;
+        std::uint32_t dumped_frames_;
+
+        void write_wav_header();
+
+    public:
+        /**
+         * \brief Create a null audio driver.
+         * 
+         * \param sample_rate   The sample rate reported as native.
+         * \param dump_path     Host path of the WAV file to dump the output to. Empty for no dump.
+         */
+        explicit null_audio_driver(const std::uint32_t sample_rate = 44100, const std::string &dump_path = "");
+        ~null_audio_driver() override;
+
+        std::unique_ptr<audio_output_stream> new_output_stream(const std::uint32_t sample_rate,
+            data_callback callback) override;
+
+        std::uint32_t native_sample_rate() override;
+
+        /**
+         * \brief Pull frames from all playing streams and sum them.
+         * 
+         * \param dest      Signed 16-bit stereo destination. Can be null if the output is only dumped.
+         * \param frames    Number of frames to render.
+         */
+        void render(std::int16_t *dest, const std::size_t frames);
+
+        std::uint32_t dumped_frames() const {
+            return dumped_frames_;
+        }
+    };
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <drivers/audio/audio.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace eka2l1::drivers {
+    class audio_mixer;
+
+    /**
+     * \brief A client stream feeding the mixer.
+     * 
+     * The stream pulls signed 16-bit stereo frames from its callback at its own sample rate,
+     * and is resampled to the output rate when mixed.
+     */
+    struct mixer_output_stream: public audio_output_stream {
+    private:
+        friend class audio_mixer;
+
+        audio_mixer *mixer_;
+        data_callback callback_;
+
+        std::uint32_t step_;                    ///< Source frames advanced per output frame, in 16.16 fixed point.
+        std::uint32_t position_;                ///< Fractional position in the pending frames, in 16.16 fixed point.
+
+        std::vector<std::int16_t> pending_;     ///< Source frames pulled but not yet consumed by resampling.
+        std::size_t pending_frames_;
+
+        std::atomic<bool> playing_;
+        std::atomic<std::int32_t> volume_;      ///< Volume in Q14.
+
+        /**
+         * \brief Pull frames from the client and add them to the mix.
+         * 
+         * \param dest      Stereo accumulation buffer at the output rate.
+         * \param scratch   Scratch buffer big enough for the number of frames.
+         * \param frames    Number of output frames to mix.
+         */
+        void mix(std::int32_t *dest, std::int16_t *scratch, const std::size_t frames);
+
+    public:
+        explicit mixer_output_stream(audio_mixer *mixer, const std::uint32_t sample_rate, data_callback callback);
+        ~mixer_output_stream() override;
+
+        bool start() override;
+        bool stop() override;
+
+        bool is_playing() override;
+
+        bool set_volume(const float volume) override;
+    };
+
+    /**
+     * \brief Sums streams of many clients into one output stream of a backend driver.
+     * 
+     * The mixer is itself an audio driver, so clients create their streams on it the same
+     * way they would on a backend. Only one stream is opened on the backend, at its native
+     * sample rate.
+     */
+    class audio_mixer: public audio_driver {
+        friend struct mixer_output_stream;
+
+        std::unique_ptr<audio_driver> backend_;
+        std::unique_ptr<audio_output_stream> output_;
+
+        std::uint32_t output_rate_;
+
+        std::recursive_mutex lock_;            ///< Recursive, clients may stop their stream from their callback.
+        std::vector<mixer_output_stream *> streams_;
+        std::atomic<bool> output_started_;
+
+        std::vector<std::int32_t> mix_buffer_;
+        std::vector<std::int16_t> scratch_buffer_;
+
+        void add_stream(mixer_output_stream *stream);
+        void remove_stream(mixer_output_stream *stream);
+        void start_output();
+
+    public:
+        explicit audio_mixer(std::unique_ptr<audio_driver> backend);
+        ~audio_mixer() override;
+
+        std::unique_ptr<audio_output_stream> new_output_stream(const std::uint32_t sample_rate,
+            data_callback callback) override;
+
+        std::uint32_t native_sample_rate() override;
+
+        /**
+         * \brief Mix all playing streams.
+         * 
+         * This is the callback of the backend output stream.
+         * 
+         * \param dest      Signed 16-bit stereo destination.
+         * \param frames    Number of frames to produce.
+         * 
+         * \returns Number of frames written, always the number requested.
+         */
+        std::size_t mix(std::int16_t *dest, const std::size_t frames);
+
+        audio_driver *backend() {
+            return backend_.get();
+        }
+    };
+
+    /**
+     * \brief Add signed 16-bit samples, scaled by a Q14 volume, to a 32-bit accumulator.
+     */
+    void accumulate_samples(std::int32_t *dest, const std::int16_t *source, const std::size_t count,
+        const std::int32_t volume);
+
+    /**
+     * \brief Convert 32-bit accumulated samples back to signed 16-bit, with saturation.
+     */
+    void saturate_samples(std::int16_t *dest, const std::int32_t *source, const std::size_t count);
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace eka2l1::drivers {
+    /**
+     * \brief Generate a sine tone from a precomputed wavetable.
+     * 
+     * The phase is a 32-bit fraction of one period, so a tone keeps its pitch exactly
+     * no matter how long it plays.
+     */
+    class tone_generator {
+        std::uint32_t phase_;
+        std::uint32_t step_;
+
+    public:
+        explicit tone_generator();
+
+        void set_frequency(const std::uint32_t frequency, const std::uint32_t sample_rate);
+
+        void reset() {
+            phase_ = 0;
+        }
+
+        /**
+         * \brief Write the tone to both channels of a signed 16-bit stereo buffer.
+         * 
+         * \param dest          The destination buffer.
+         * \param frames        Number of frames to write.
+         * \param amplitude     Peak of the wave, 32767 at most.
+         */
+        void generate(std::int16_t *dest, const std::size_t frames, const std::int32_t amplitude);
+    };
+}
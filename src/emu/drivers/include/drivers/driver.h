@@ -21,10 +21,18 @@
 #pragma once
 
 #include <common/queue.h>
+
 #include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace eka2l1::drivers {
     static constexpr std::uint32_t MAX_COMMAND_DATA_SIZE = 80;
+    static constexpr std::uint32_t COMMAND_POOL_SLAB_SIZE = 512;            ///< Number of commands allocated at once by the pool.
+    static constexpr std::size_t COMMAND_PAYLOAD_BLOCK_SIZE = 0x10000;     ///< Default size of a command list payload block.
 
     /**
      * \brief Represent a command for driver.
@@ -51,6 +59,59 @@ namespace eka2l1::drivers {
         }
     };
 
+    /**
+     * \brief A block of memory holding out-of-line data of commands in a list.
+     * 
+     * The data follows the block header directly.
+     */
+    struct alignas(16) command_payload_block {
+        command_payload_block *next_;
+        std::size_t size_;
+        std::size_t used_;
+
+        std::uint8_t *data() {
+            return reinterpret_cast<std::uint8_t *>(this + 1);
+        }
+    };
+
+    /**
+     * \brief Recycles commands and payload blocks between command lists.
+     * 
+     * Commands are allocated in slabs and never freed back to the heap. When the driver
+     * finishes a list, all of its commands and payload blocks are given back here in one go.
+     */
+    class command_pool {
+        std::mutex lock_;
+
+        command *free_commands_;
+        command_payload_block *free_blocks_;
+
+        std::vector<std::unique_ptr<command[]>> slabs_;
+
+    public:
+        explicit command_pool();
+        ~command_pool();
+
+        command *allocate_command(const std::uint16_t opcode, int *status);
+        command_payload_block *allocate_block(const std::size_t min_size);
+
+        /**
+         * \brief Give back a chain of commands and a chain of payload blocks.
+         * 
+         * \param first   First command of the chain, linked by next_.
+         * \param last    Last command of the chain.
+         * \param blocks  First payload block of the chain.
+         */
+        void release(command *first, command *last, command_payload_block *blocks);
+    };
+
+    /**
+     * \brief Get the command pool shared by every driver.
+     */
+    command_pool &get_command_pool();
+
+    struct command_list;
+
     struct command_helper {
         std::uint16_t cursor_;
         command *todo_;
@@ -100,23 +161,10 @@ namespace eka2l1::drivers {
             drv->cond_.notify_all();
         }
 
-        bool push_string(const std::u16string &data) {
-            // Alloc memory for the string
-            std::uint16_t length = static_cast<std::uint16_t>(data.length());
-
-            if (!push(length)) {
-                return false;
-            }
-
-            char16_t *dat = new char16_t[length];
-            std::copy(data.data(), data.data() + length, dat);
-
-            if (!push(dat)) {
-                return false;
-            }
-
-            return true;
-        }
+        /**
+         * \brief Push a string, its data is stored in the payload of the list the command belongs to.
+         */
+        bool push_string(command_list &list, const std::u16string &data);
 
         bool pop_string(std::u16string &dat) {
             std::uint16_t length = 0;
@@ -132,8 +180,6 @@ namespace eka2l1::drivers {
             }
 
             std::copy(ptr, ptr + length, &dat[0]);
-            delete ptr;
-
             return true;
         }
     };
@@ -149,7 +195,7 @@ namespace eka2l1::drivers {
 
     template <typename... Args>
     command *make_command(const std::uint16_t opcode, int *status, Args... arguments) {
-        command *cmd = new command(opcode, status);
+        command *cmd = get_command_pool().allocate_command(opcode, status);
         command_helper helper(cmd);
 
         if constexpr(sizeof...(Args) > 0)
@@ -160,13 +206,20 @@ namespace eka2l1::drivers {
 
     /**
      * \brief A linked list of command.
+     * 
+     * Out-of-line data of commands (strings, bitmap and buffer data...) is bump-allocated
+     * in payload blocks owned by the list, and lives until the driver finishes the list.
      */
     struct command_list {
         command *first_;
         command *last_;
 
+        command_payload_block *payload_;
+
         explicit command_list()
-            : first_(nullptr) {
+            : first_(nullptr)
+            , last_(nullptr)
+            , payload_(nullptr) {
         }
 
         void add(command *cmd_) {
@@ -180,6 +233,31 @@ namespace eka2l1::drivers {
             last_->next_ = cmd_;
             last_ = cmd_;
         }
+
+        /**
+         * \brief Allocate memory for out-of-line command data.
+         * \returns Pointer to the memory, aligned to 16 bytes.
+         */
+        void *allocate_payload(const std::size_t size);
+
+        /**
+         * \brief Forget all commands and payload, without releasing them.
+         * 
+         * Used after the list content has been handed to the driver.
+         */
+        void reset() {
+            first_ = nullptr;
+            last_ = nullptr;
+            payload_ = nullptr;
+        }
+
+        /**
+         * \brief Give all commands and payload back to the command pool, and empty the list.
+         */
+        void release() {
+            get_command_pool().release(first_, last_, payload_);
+            reset();
+        }
     };
 
     class driver {
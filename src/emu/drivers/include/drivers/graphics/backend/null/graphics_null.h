@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <drivers/graphics/graphics.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace eka2l1::drivers {
+    /**
+     * \brief A graphics driver that draws nothing.
+     * 
+     * Command lists are consumed right when they are submitted, on the submitting thread.
+     * Objects only get a handle, so clients that create and use resources keep working
+     * without a window or a GPU.
+     */
+    class null_graphics_driver : public graphics_driver {
+        drivers::handle next_handle_;
+        std::atomic<std::uint64_t> presents_;
+
+        void dispatch(command *cmd);
+
+    public:
+        explicit null_graphics_driver();
+        ~null_graphics_driver() override {}
+
+        void update_bitmap(drivers::handle h, const std::size_t size, const eka2l1::vec2 &offset,
+            const eka2l1::vec2 &dim, const int bpp, const void *data) override {}
+
+        void attach_descriptors(drivers::handle h, const int stride, const bool instance_move, const attribute_descriptor *descriptors,
+            const int descriptor_count) override {}
+
+        void set_viewport(const eka2l1::rect &viewport) override {}
+
+        std::unique_ptr<graphics_command_list> new_command_list() override;
+        std::unique_ptr<graphics_command_list_builder> new_command_builder(graphics_command_list *list) override;
+        void submit_command_list(graphics_command_list &command_list) override;
+
+        void run() override {}
+        void abort() override {}
+
+        /**
+         * \brief Get the number of present commands this driver received.
+         */
+        std::uint64_t presents() const {
+            return presents_;
+        }
+    };
+}
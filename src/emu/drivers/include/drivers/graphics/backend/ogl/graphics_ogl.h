@@ -29,6 +29,7 @@
 
 #include <memory>
 #include <queue>
+#include <vector>
 
 namespace eka2l1::drivers {
     struct ogl_state {
@@ -79,12 +80,14 @@ namespace eka2l1::drivers {
         GLint mask_loc_mask;
 
         ogl_state backup;
+        std::vector<GLfloat> batch_verts;    ///< Vertices of batched bitmap draws, reused between draws.
         std::atomic_bool should_stop;
 
         void do_init();
 
         void clear(command_helper &helper);
         void draw_bitmap(command_helper &helper);
+        void draw_bitmaps(command_helper &helper);
         void draw_rectangle(command_helper &helper);
         void set_invalidate(command_helper &helper);
         void invalidate_rect(command_helper &helper);
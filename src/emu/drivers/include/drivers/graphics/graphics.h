@@ -50,6 +50,7 @@ namespace eka2l1::drivers {
         graphics_driver_set_brush_color,
         graphics_driver_update_bitmap,
         graphics_driver_draw_bitmap,
+        graphics_driver_draw_bitmaps,
         graphics_driver_draw_rectangle,
         graphics_driver_resize_bitmap,
 
@@ -123,6 +124,7 @@ namespace eka2l1::drivers {
          * \brief Submit a command list.
          * 
          * The list object will be copied within the function, and can be safely delete after.
+         * The list is left empty, so it can also be filled and submitted again.
          *
          * \param command_list     Command list to submit.
          */
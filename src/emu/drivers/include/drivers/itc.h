@@ -162,6 +162,24 @@ namespace eka2l1::drivers {
             const eka2l1::vec2 &dim)
             = 0;
 
+        /**
+         * \brief Queue an update of a bitmap, and get the memory to write the new data into.
+         * 
+         * The memory belongs to the command list, so the data doesn't need to be built somewhere
+         * else and copied. It must be filled before the list is submitted.
+         *
+         * \param h       Handle to the bitmap.
+         * \param bpp     Number of bits per pixel.
+         * \param size    Size of bitmap data.
+         * \param offset  The offset of the bitmap (pixels).
+         * \param dim     The dimensions of bitmap (pixels).
+         * 
+         * \returns Pointer to the memory that will hold the bitmap data.
+         */
+        virtual void *update_bitmap_buffer(drivers::handle h, const int bpp, const std::size_t size, const eka2l1::vec2 &offset,
+            const eka2l1::vec2 &dim)
+            = 0;
+
         /**
          * \brief Draw a bitmap to currently binded bitmap.
          *
@@ -173,6 +191,20 @@ namespace eka2l1::drivers {
          */
         virtual void draw_bitmap(drivers::handle h, drivers::handle maskh, const eka2l1::rect &dest_rect, const eka2l1::rect &source_rect, const std::uint32_t flags = 0) = 0;
 
+        /**
+         * \brief Draw many regions of a bitmap to currently binded bitmap, in a single draw.
+         * 
+         * Masks are not supported. The rectangles are copied, they don't have to outlive the call.
+         * 
+         * \param h            The handle of the bitmap to blit.
+         * \param dest_rects   Destination rectangles.
+         * \param source_rects Source rectangles, one for each destination rectangle.
+         * \param count        Number of rectangles.
+         * \param flags        Drawing flags, applied to all rectangles.
+         */
+        virtual void draw_bitmaps(drivers::handle h, const eka2l1::rect *dest_rects, const eka2l1::rect *source_rects,
+            const std::uint32_t count, const std::uint32_t flags = 0) = 0;
+
         /**
          * \brief Draw a rectangle with brush color.
          * 
@@ -358,8 +390,14 @@ namespace eka2l1::drivers {
         void update_bitmap(drivers::handle h, const int bpp, const char *data, const std::size_t size, const eka2l1::vec2 &offset,
             const eka2l1::vec2 &dim) override;
 
+        void *update_bitmap_buffer(drivers::handle h, const int bpp, const std::size_t size, const eka2l1::vec2 &offset,
+            const eka2l1::vec2 &dim) override;
+
         void draw_bitmap(drivers::handle h, drivers::handle maskh, const eka2l1::rect &dest_rect, const eka2l1::rect &source_rect, const std::uint32_t flags = 0) override;
 
+        void draw_bitmaps(drivers::handle h, const eka2l1::rect *dest_rects, const eka2l1::rect *source_rects,
+            const std::uint32_t count, const std::uint32_t flags = 0) override;
+
         void draw_rectangle(const eka2l1::rect &target_rect) override;
 
         void use_program(drivers::handle h) override;
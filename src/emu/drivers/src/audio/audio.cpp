@@ -18,19 +18,33 @@
  */
 
 #include <drivers/audio/audio.h>
+#include <drivers/audio/mixer.h>
 #include <drivers/audio/backend/cubeb/audio_cubeb.h>
+#include <drivers/audio/backend/null/audio_null.h>
 
 namespace eka2l1::drivers {
-    std::unique_ptr<audio_driver> make_audio_driver(const audio_driver_backend backend) {
+    std::unique_ptr<audio_driver> make_audio_driver(const audio_driver_backend backend, const std::string &dump_path) {
+        std::unique_ptr<audio_driver> backend_driver;
+
         switch (backend) {
         case audio_driver_backend::cubeb: {
-            return std::make_unique<cubeb_audio_driver>();
+            backend_driver = std::make_unique<cubeb_audio_driver>();
+            break;
+        }
+
+        case audio_driver_backend::null: {
+            backend_driver = std::make_unique<null_audio_driver>(44100, dump_path);
+            break;
         }
 
         default:
             break;
         }
 
-        return nullptr;
+        if (!backend_driver) {
+            return nullptr;
+        }
+
+        return std::make_unique<audio_mixer>(std::move(backend_driver));
     }
 }
\ No newline at end of file
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <drivers/audio/backend/null/audio_null.h>
+#include <drivers/audio/mixer.h>
+
+#include <common/algorithm.h>
+#include <common/log.h>
+
+#include <algorithm>
+
+namespace eka2l1::drivers {
+    static constexpr std::size_t NULL_AUDIO_CHUNK_FRAMES = 1024;
+
+    struct wav_header {
+        char riff_magic[4] = { 'R', 'I', 'F', 'F' };
+        std::uint32_t riff_size;
+        char wave_magic[4] = { 'W', 'A', 'V', 'E' };
+
+        char fmt_magic[4] = { 'f', 'm', 't', ' ' };
+        std::uint32_t fmt_size = 16;
+        std::uint16_t format = 1;                   ///< PCM
+        std::uint16_t channels = 2;
+        std::uint32_t sample_rate;
+        std::uint32_t byte_rate;
+        std::uint16_t block_align = 4;
+        std::uint16_t bits_per_sample = 16;
+
+        char data_magic[4] = { 'd', 'a', 't', 'a' };
+        std::uint32_t data_size;
+    };
+
+    null_audio_output_stream::null_audio_output_stream(null_audio_driver *driver, data_callback callback)
+        : driver_(driver)
+        , callback_(callback)
+        , playing_(false)
+        , volume_(1.0f) {
+        const std::lock_guard<std::mutex> guard(driver_->lock_);
+        driver_->streams_.push_back(this);
+    }
+
+    null_audio_output_stream::~null_audio_output_stream() {
+        const std::lock_guard<std::mutex> guard(driver_->lock_);
+        driver_->streams_.erase(std::remove(driver_->streams_.begin(), driver_->streams_.end(), this),
+            driver_->streams_.end());
+    }
+
+    bool null_audio_output_stream::start() {
+        playing_ = true;
+        return true;
+    }
+
+    bool null_audio_output_stream::stop() {
+        playing_ = false;
+        return true;
+    }
+
+    bool null_audio_output_stream::is_playing() {
+        return playing_;
+    }
+
+    bool null_audio_output_stream::set_volume(const float volume) {
+        volume_ = std::clamp(volume, 0.0f, 1.0f);
+        return true;
+    }
+
+    null_audio_driver::null_audio_driver(const std::uint32_t sample_rate, const std::string &dump_path)
+        : sample_rate_(sample_rate)
+        , dumped_frames_(0) {
+        mix_buffer_.resize(NULL_AUDIO_CHUNK_FRAMES * 2);
+        stream_buffer_.resize(NULL_AUDIO_CHUNK_FRAMES * 2);
+        output_buffer_.resize(NULL_AUDIO_CHUNK_FRAMES * 2);
+
+        if (!dump_path.empty()) {
+            dump_.open(dump_path, std::ios::binary);
+
+            if (!dump_) {
+                LOG_ERROR("Unable to open audio dump file {}", dump_path);
+            } else {
+                // Sizes are patched when the driver is destroyed
+                write_wav_header();
+            }
+        }
+    }
+
+    null_audio_driver::~null_audio_driver() {
+        if (dump_.is_open()) {
+            dump_.seekp(0, std::ios::beg);
+            write_wav_header();
+        }
+    }
+
+    void null_audio_driver::write_wav_header() {
+        wav_header header;
+        header.data_size = dumped_frames_ * 4;
+        header.riff_size = static_cast<std::uint32_t>(sizeof(wav_header) - 8) + header.data_size;
+        header.sample_rate = sample_rate_;
+        header.byte_rate = sample_rate_ * 4;
+
+        dump_.write(reinterpret_cast<const char *>(&header), sizeof(wav_header));
+    }
+
+    std::unique_ptr<audio_output_stream> null_audio_driver::new_output_stream(const std::uint32_t sample_rate,
+        data_callback callback) {
+        if (sample_rate != sample_rate_) {
+            LOG_WARN("Null audio stream with rate {} is rendered at {}", sample_rate, sample_rate_);
+        }
+
+        return std::make_unique<null_audio_output_stream>(this, callback);
+    }
+
+    std::uint32_t null_audio_driver::native_sample_rate() {
+        return sample_rate_;
+    }
+
+    void null_audio_driver::render(std::int16_t *dest, const std::size_t frames) {
+        const std::lock_guard<std::mutex> guard(lock_);
+
+        for (std::size_t done = 0; done < frames; done += NULL_AUDIO_CHUNK_FRAMES) {
+            const std::size_t to_render = common::min(frames - done, NULL_AUDIO_CHUNK_FRAMES);
+            std::fill(mix_buffer_.begin(), mix_buffer_.begin() + to_render * 2, 0);
+
+            for (null_audio_output_stream *stream: streams_) {
+                if (!stream->playing_) {
+                    continue;
+                }
+
+                const std::size_t got = common::min(stream->callback_(stream_buffer_.data(), to_render), to_render);
+                accumulate_samples(mix_buffer_.data(), stream_buffer_.data(), got * 2,
+                    static_cast<std::int32_t>(stream->volume_ * (1 << 14)));
+            }
+
+            std::int16_t *out = dest ? (dest + done * 2) : output_buffer_.data();
+            saturate_samples(out, mix_buffer_.data(), to_render * 2);
+
+            if (dump_.is_open()) {
+                dump_.write(reinterpret_cast<const char *>(out), to_render * 4);
+                dumped_frames_ += static_cast<std::uint32_t>(to_render);
+            }
+        }
+    }
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <drivers/audio/mixer.h>
+
+#include <common/algorithm.h>
+#include <common/log.h>
+#include <common/platform.h>
+
+#include <algorithm>
+
+#if EKA2L1_ARCH(X64)
+#include <emmintrin.h>
+#endif
+
+namespace eka2l1::drivers {
+    static constexpr std::size_t MIXER_CHUNK_FRAMES = 1024;
+    static constexpr std::uint32_t MIXER_DEFAULT_SAMPLE_RATE = 44100;
+    static constexpr std::int32_t MIXER_VOLUME_ONE = 1 << 14;
+
+    void accumulate_samples(std::int32_t *dest, const std::int16_t *source, const std::size_t count,
+        const std::int32_t volume) {
+        std::size_t i = 0;
+
+#if EKA2L1_ARCH(X64)
+        // Multiply each sample with the volume through madd, pairing them with zero
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i vol = _mm_set1_epi32(volume);
+
+        for (; i + 8 <= count; i += 8) {
+            const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+
+            const __m128i lo = _mm_srai_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(samples, zero), vol), 14);
+            const __m128i hi = _mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(samples, zero), vol), 14);
+
+            __m128i *dest_vec = reinterpret_cast<__m128i *>(dest + i);
+            _mm_storeu_si128(dest_vec, _mm_add_epi32(_mm_loadu_si128(dest_vec), lo));
+            _mm_storeu_si128(dest_vec + 1, _mm_add_epi32(_mm_loadu_si128(dest_vec + 1), hi));
+        }
+#endif
+
+        for (; i < count; i++) {
+            dest[i] += (static_cast<std::int32_t>(source[i]) * volume) >> 14;
+        }
+    }
+
+    void saturate_samples(std::int16_t *dest, const std::int32_t *source, const std::size_t count) {
+        std::size_t i = 0;
+
+#if EKA2L1_ARCH(X64)
+        for (; i + 8 <= count; i += 8) {
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+            const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i + 4));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i), _mm_packs_epi32(lo, hi));
+        }
+#endif
+
+        for (; i < count; i++) {
+            dest[i] = static_cast<std::int16_t>(std::clamp<std::int32_t>(source[i], -32768, 32767));
+        }
+    }
+
+    mixer_output_stream::mixer_output_stream(audio_mixer *mixer, const std::uint32_t sample_rate, data_callback callback)
+        : mixer_(mixer)
+        , callback_(callback)
+        , position_(0)
+        , pending_frames_(0)
+        , playing_(false)
+        , volume_(MIXER_VOLUME_ONE) {
+        step_ = static_cast<std::uint32_t>((static_cast<std::uint64_t>(sample_rate) << 16) / mixer->output_rate_);
+        mixer_->add_stream(this);
+    }
+
+    mixer_output_stream::~mixer_output_stream() {
+        mixer_->remove_stream(this);
+    }
+
+    void mixer_output_stream::mix(std::int32_t *dest, std::int16_t *scratch, const std::size_t frames) {
+        const std::int32_t volume = volume_.load();
+
+        if (step_ == (1 << 16)) {
+            // Same rate, the client can write straight to the scratch buffer
+            const std::size_t written = common::min(callback_(scratch, frames), frames);
+            accumulate_samples(dest, scratch, written * 2, volume);
+
+            return;
+        }
+
+        // Linear interpolation needs the frame after the last position too
+        std::uint64_t position = position_;
+        const std::size_t needed = static_cast<std::size_t>((position + (frames - 1) * step_) >> 16) + 2;
+
+        if (pending_frames_ < needed) {
+            if (pending_.size() < needed * 2) {
+                pending_.resize(needed * 2);
+            }
+
+            const std::size_t to_pull = needed - pending_frames_;
+            const std::size_t pulled = common::min(callback_(&pending_[pending_frames_ * 2], to_pull), to_pull);
+
+            // A client that ends early is padded with silence
+            std::fill(pending_.begin() + (pending_frames_ + pulled) * 2, pending_.begin() + needed * 2, 0);
+            pending_frames_ = needed;
+        }
+
+        for (std::size_t i = 0; i < frames; i++) {
+            const std::size_t index = static_cast<std::size_t>(position >> 16) * 2;
+            const std::int32_t frac = static_cast<std::int32_t>(position & 0xFFFF);
+
+            for (std::size_t channel = 0; channel < 2; channel++) {
+                const std::int32_t s0 = pending_[index + channel];
+                const std::int32_t s1 = pending_[index + 2 + channel];
+
+                scratch[i * 2 + channel] = static_cast<std::int16_t>(s0 + (((s1 - s0) * frac) >> 16));
+            }
+
+            position += step_;
+        }
+
+        accumulate_samples(dest, scratch, frames * 2, volume);
+
+        // Keep the frames that are still needed for the next round
+        const std::size_t consumed = common::min<std::size_t>(static_cast<std::size_t>(position >> 16), pending_frames_);
+
+        std::copy(pending_.begin() + consumed * 2, pending_.begin() + pending_frames_ * 2, pending_.begin());
+        pending_frames_ -= consumed;
+        position_ = static_cast<std::uint32_t>(position & 0xFFFF);
+    }
+
+    bool mixer_output_stream::start() {
+        playing_ = true;
+        mixer_->start_output();
+
+        return true;
+    }
+
+    bool mixer_output_stream::stop() {
+        // Wait for a mix in progress, so the client can safely reset its state after this
+        const std::lock_guard<std::recursive_mutex> guard(mixer_->lock_);
+        playing_ = false;
+
+        return true;
+    }
+
+    bool mixer_output_stream::is_playing() {
+        return playing_;
+    }
+
+    bool mixer_output_stream::set_volume(const float volume) {
+        volume_ = static_cast<std::int32_t>(std::clamp(volume, 0.0f, 1.0f) * MIXER_VOLUME_ONE);
+        return true;
+    }
+
+    audio_mixer::audio_mixer(std::unique_ptr<audio_driver> backend)
+        : backend_(std::move(backend))
+        , output_rate_(0)
+        , output_started_(false) {
+        if (backend_) {
+            output_rate_ = backend_->native_sample_rate();
+        }
+
+        if (!output_rate_) {
+            output_rate_ = MIXER_DEFAULT_SAMPLE_RATE;
+        }
+
+        mix_buffer_.resize(MIXER_CHUNK_FRAMES * 2);
+        scratch_buffer_.resize(MIXER_CHUNK_FRAMES * 2);
+
+        if (backend_) {
+            output_ = backend_->new_output_stream(output_rate_, [this](std::int16_t *dest, std::size_t frames) {
+                return mix(dest, frames);
+            });
+        }
+    }
+
+    audio_mixer::~audio_mixer() {
+        if (output_ && output_started_) {
+            output_->stop();
+        }
+
+        output_.reset();
+    }
+
+    void audio_mixer::add_stream(mixer_output_stream *stream) {
+        const std::lock_guard<std::recursive_mutex> guard(lock_);
+        streams_.push_back(stream);
+    }
+
+    void audio_mixer::remove_stream(mixer_output_stream *stream) {
+        const std::lock_guard<std::recursive_mutex> guard(lock_);
+        streams_.erase(std::remove(streams_.begin(), streams_.end(), stream), streams_.end());
+    }
+
+    void audio_mixer::start_output() {
+        // The output keeps running once started, mixing silence costs less than restarting the backend
+        if (output_ && !output_started_.exchange(true)) {
+            if (!output_->start()) {
+                LOG_ERROR("Unable to start the mixer output stream");
+            }
+        }
+    }
+
+    std::unique_ptr<audio_output_stream> audio_mixer::new_output_stream(const std::uint32_t sample_rate,
+        data_callback callback) {
+        return std::make_unique<mixer_output_stream>(this, sample_rate, callback);
+    }
+
+    std::uint32_t audio_mixer::native_sample_rate() {
+        return output_rate_;
+    }
+
+    std::size_t audio_mixer::mix(std::int16_t *dest, const std::size_t frames) {
+        const std::lock_guard<std::recursive_mutex> guard(lock_);
+
+        for (std::size_t done = 0; done < frames; done += MIXER_CHUNK_FRAMES) {
+            const std::size_t to_mix = common::min(frames - done, MIXER_CHUNK_FRAMES);
+            std::fill(mix_buffer_.begin(), mix_buffer_.begin() + to_mix * 2, 0);
+
+            for (mixer_output_stream *stream: streams_) {
+                if (stream->playing_) {
+                    stream->mix(mix_buffer_.data(), scratch_buffer_.data(), to_mix);
+                }
+            }
+
+            saturate_samples(dest + done * 2, mix_buffer_.data(), to_mix * 2);
+        }
+
+        return frames;
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <drivers/audio/tone.h>
+
+#include <array>
+#include <cmath>
+
+namespace eka2l1::drivers {
+    static constexpr std::uint32_t SINE_TABLE_BITS = 10;
+    static constexpr std::uint32_t SINE_TABLE_SIZE = 1 << SINE_TABLE_BITS;
+    static constexpr double PI = 3.14159265358979323846;
+
+    using sine_table = std::array<std::int16_t, SINE_TABLE_SIZE + 1>;
+
+    static const sine_table &get_sine_table() {
+        static const sine_table table = []() {
+            sine_table result;
+
+            // One extra entry so interpolation never has to wrap
+            for (std::uint32_t i = 0; i <= SINE_TABLE_SIZE; i++) {
+                result[i] = static_cast<std::int16_t>(std::lround(std::sin(2.0 * PI * i / SINE_TABLE_SIZE) * 32767.0));
+            }
+
+            return result;
+        }();
+
+        return table;
+    }
+
+    tone_generator::tone_generator()
+        : phase_(0)
+        , step_(0) {
+    }
+
+    void tone_generator::set_frequency(const std::uint32_t frequency, const std::uint32_t sample_rate) {
+        step_ = sample_rate ? static_cast<std::uint32_t>((static_cast<std::uint64_t>(frequency) << 32) / sample_rate) : 0;
+    }
+
+    void tone_generator::generate(std::int16_t *dest, const std::size_t frames, const std::int32_t amplitude) {
+        const sine_table &table = get_sine_table();
+
+        for (std::size_t i = 0; i < frames; i++) {
+            const std::uint32_t index = phase_ >> (32 - SINE_TABLE_BITS);
+            const std::int32_t frac = static_cast<std::int32_t>((phase_ >> (16 - SINE_TABLE_BITS)) & 0xFFFF);
+
+            const std::int32_t s0 = table[index];
+            const std::int32_t s1 = table[index + 1];
+            const std::int32_t sample = s0 + (((s1 - s0) * frac) >> 16);
+
+            const std::int16_t scaled = static_cast<std::int16_t>((sample * amplitude) >> 15);
+
+            dest[i * 2] = scaled;
+            dest[i * 2 + 1] = scaled;
+
+            phase_ += step_;
+        }
+    }
+}
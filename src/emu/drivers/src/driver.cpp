@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <drivers/driver.h>
+
+#include <common/algorithm.h>
+
+#include <new>
+
+namespace eka2l1::drivers {
+    static constexpr std::size_t PAYLOAD_ALIGNMENT = 16;
+
+    command_pool::command_pool()
+        : free_commands_(nullptr)
+        , free_blocks_(nullptr) {
+    }
+
+    command_pool::~command_pool() {
+        while (free_blocks_) {
+            command_payload_block *next = free_blocks_->next_;
+            ::operator delete(free_blocks_);
+
+            free_blocks_ = next;
+        }
+    }
+
+    command *command_pool::allocate_command(const std::uint16_t opcode, int *status) {
+        command *cmd = nullptr;
+
+        {
+            const std::lock_guard<std::mutex> guard(lock_);
+
+            if (!free_commands_) {
+                slabs_.push_back(std::make_unique<command[]>(COMMAND_POOL_SLAB_SIZE));
+                command *slab = slabs_.back().get();
+
+                for (std::uint32_t i = 0; i < COMMAND_POOL_SLAB_SIZE - 1; i++) {
+                    slab[i].next_ = &slab[i + 1];
+                }
+
+                slab[COMMAND_POOL_SLAB_SIZE - 1].next_ = nullptr;
+                free_commands_ = slab;
+            }
+
+            cmd = free_commands_;
+            free_commands_ = cmd->next_;
+        }
+
+        cmd->opcode_ = opcode;
+        cmd->next_ = nullptr;
+        cmd->status_ = status;
+
+        return cmd;
+    }
+
+    command_payload_block *command_pool::allocate_block(const std::size_t min_size) {
+        command_payload_block *block = nullptr;
+
+        if (min_size <= COMMAND_PAYLOAD_BLOCK_SIZE) {
+            const std::lock_guard<std::mutex> guard(lock_);
+
+            if (free_blocks_) {
+                block = free_blocks_;
+                free_blocks_ = block->next_;
+            }
+        }
+
+        if (!block) {
+            // Oversized payloads get their own block, which is freed instead of recycled
+            const std::size_t size = common::max(min_size, COMMAND_PAYLOAD_BLOCK_SIZE);
+
+            block = reinterpret_cast<command_payload_block *>(::operator new(sizeof(command_payload_block) + size));
+            block->size_ = size;
+        }
+
+        block->next_ = nullptr;
+        block->used_ = 0;
+
+        return block;
+    }
+
+    void command_pool::release(command *first, command *last, command_payload_block *blocks) {
+        // Free oversized blocks outside of the lock
+        command_payload_block *recycle = nullptr;
+
+        while (blocks) {
+            command_payload_block *next = blocks->next_;
+
+            if (blocks->size_ == COMMAND_PAYLOAD_BLOCK_SIZE) {
+                blocks->next_ = recycle;
+                recycle = blocks;
+            } else {
+                ::operator delete(blocks);
+            }
+
+            blocks = next;
+        }
+
+        const std::lock_guard<std::mutex> guard(lock_);
+
+        if (first && last) {
+            last->next_ = free_commands_;
+            free_commands_ = first;
+        }
+
+        while (recycle) {
+            command_payload_block *next = recycle->next_;
+
+            recycle->next_ = free_blocks_;
+            free_blocks_ = recycle;
+
+            recycle = next;
+        }
+    }
+
+    command_pool &get_command_pool() {
+        static command_pool pool;
+        return pool;
+    }
+
+    void *command_list::allocate_payload(const std::size_t size) {
+        std::size_t offset = payload_ ? common::align(payload_->used_, PAYLOAD_ALIGNMENT) : 0;
+
+        if (!payload_ || (offset + size > payload_->size_)) {
+            command_payload_block *block = get_command_pool().allocate_block(size);
+            block->next_ = payload_;
+
+            payload_ = block;
+            offset = 0;
+        }
+
+        payload_->used_ = offset + size;
+        return payload_->data() + offset;
+    }
+
+    bool command_helper::push_string(command_list &list, const std::u16string &data) {
+        std::uint16_t length = static_cast<std::uint16_t>(data.length());
+
+        if (!push(length)) {
+            return false;
+        }
+
+        char16_t *dat = reinterpret_cast<char16_t *>(list.allocate_payload(length * sizeof(char16_t)));
+        std::copy(data.data(), data.data() + length, dat);
+
+        if (!push(dat)) {
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -178,8 +178,6 @@ namespace eka2l1::drivers {
         helper.pop(dim);
 
         update_bitmap(handle, size, offset, dim, bpp, data);
-
-        delete data;
     }
 
     void shared_graphics_driver::create_bitmap(command_helper &helper) {
@@ -428,8 +426,6 @@ namespace eka2l1::drivers {
         }
 
         shobj->set(this, binding, var_type, data);
-
-        delete data;
     }
 
     void shared_graphics_driver::bind_texture(command_helper &helper) {
@@ -492,8 +488,6 @@ namespace eka2l1::drivers {
         }
 
         bufobj->update_data(this, data, offset, size);
-
-        delete data;
     }
 
     void shared_graphics_driver::attach_descriptors(drivers::handle h, const int stride, const bool instance_move,
@@ -521,8 +515,6 @@ namespace eka2l1::drivers {
         helper.pop(descriptor_count);
 
         attach_descriptors(h, stride, instance_move, descriptors, descriptor_count);
-
-        delete descriptors;
     }
 
     void shared_graphics_driver::destroy_object(command_helper &helper) {
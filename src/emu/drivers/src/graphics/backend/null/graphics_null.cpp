@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <drivers/graphics/backend/null/graphics_null.h>
+#include <drivers/graphics/buffer.h>
+#include <drivers/graphics/texture.h>
+
+namespace eka2l1::drivers {
+    null_graphics_driver::null_graphics_driver()
+        : graphics_driver(graphic_api::null)
+        , next_handle_(1)
+        , presents_(0) {
+    }
+
+    std::unique_ptr<graphics_command_list> null_graphics_driver::new_command_list() {
+        return std::make_unique<server_graphics_command_list>();
+    }
+
+    std::unique_ptr<graphics_command_list_builder> null_graphics_driver::new_command_builder(graphics_command_list *list) {
+        return std::make_unique<server_graphics_command_list_builder>(list);
+    }
+
+    void null_graphics_driver::dispatch(command *cmd) {
+        command_helper helper(cmd);
+        drivers::handle *store = nullptr;
+
+        // Only the commands giving back a handle need their arguments read, until the handle pointer
+        switch (cmd->opcode_) {
+        case graphics_driver_create_bitmap: {
+            eka2l1::vec2 size;
+
+            helper.pop(size);
+            helper.pop(store);
+
+            break;
+        }
+
+        case graphics_driver_create_program: {
+            char *vert_data = nullptr;
+            char *frag_data = nullptr;
+            std::size_t vert_size = 0;
+            std::size_t frag_size = 0;
+            void **metadata = nullptr;
+
+            helper.pop(vert_data);
+            helper.pop(frag_data);
+            helper.pop(vert_size);
+            helper.pop(frag_size);
+            helper.pop(metadata);
+            helper.pop(store);
+
+            if (metadata) {
+                *metadata = nullptr;
+            }
+
+            break;
+        }
+
+        case graphics_driver_create_texture: {
+            std::uint8_t dim = 0;
+            std::uint8_t mip_level = 0;
+            drivers::texture_format internal_format = drivers::texture_format::none;
+            drivers::texture_format data_format = drivers::texture_format::none;
+            drivers::texture_data_type data_type = drivers::texture_data_type::ubyte;
+            void *data = nullptr;
+
+            helper.pop(dim);
+            helper.pop(mip_level);
+            helper.pop(internal_format);
+            helper.pop(data_format);
+            helper.pop(data_type);
+            helper.pop(data);
+
+            std::uint32_t size_component = 0;
+
+            for (std::uint8_t i = 0; i < dim; i++) {
+                helper.pop(size_component);
+            }
+
+            helper.pop(store);
+            break;
+        }
+
+        case graphics_driver_create_buffer: {
+            std::size_t initial_size = 0;
+            buffer_hint hint = buffer_hint::none;
+            buffer_upload_hint upload_hint = static_cast<buffer_upload_hint>(0);
+
+            helper.pop(initial_size);
+            helper.pop(hint);
+            helper.pop(upload_hint);
+            helper.pop(store);
+
+            break;
+        }
+
+        case graphics_driver_display: {
+            presents_++;
+            break;
+        }
+
+        default:
+            break;
+        }
+
+        if (store) {
+            *store = next_handle_++;
+        }
+
+        if (cmd->status_) {
+            helper.finish(this, 0);
+        }
+    }
+
+    void null_graphics_driver::submit_command_list(graphics_command_list &command_list) {
+        server_graphics_command_list &server_list = static_cast<server_graphics_command_list &>(command_list);
+        command *cmd = server_list.list_.first_;
+
+        while (cmd) {
+            dispatch(cmd);
+            cmd = cmd->next_;
+        }
+
+        // Nothing is kept, so the list goes back to the pool right away
+        server_list.list_.release();
+    }
+}
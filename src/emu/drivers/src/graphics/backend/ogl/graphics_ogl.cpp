@@ -303,6 +303,117 @@ namespace eka2l1::drivers {
         glBindVertexArray(0);
     }
 
+    void ogl_graphics_driver::draw_bitmaps(command_helper &helper) {
+        if (!sprite_program) {
+            do_init();
+        }
+
+        drivers::handle to_draw = 0;
+        helper.pop(to_draw);
+
+        bitmap *bmp = get_bitmap(to_draw);
+
+        if (!bmp) {
+            LOG_ERROR("Invalid bitmap handle to draw");
+            return;
+        }
+
+        const eka2l1::rect *dest_rects = nullptr;
+        const eka2l1::rect *source_rects = nullptr;
+        std::uint32_t count = 0;
+        std::uint32_t flags = 0;
+
+        helper.pop(dest_rects);
+        helper.pop(source_rects);
+        helper.pop(count);
+        helper.pop(flags);
+
+        sprite_program->use(this);
+
+        const eka2l1::vec2 tex_size = bmp->tex->get_size();
+        const float texel_width = 1.0f / tex_size.x;
+        const float texel_height = 1.0f / tex_size.y;
+
+        // Positions are in pixels, so every quad shares the identity model matrix.
+        // Two triangles per quad: position xy, then texcoord xy.
+        batch_verts.resize(count * 6 * 4);
+        GLfloat *vert = batch_verts.data();
+
+        for (std::uint32_t i = 0; i < count; i++) {
+            eka2l1::rect source_rect = source_rects[i];
+            eka2l1::rect dest_rect = dest_rects[i];
+
+            if (source_rect.size.x == 0) {
+                source_rect.size.x = tex_size.x;
+            }
+
+            if (source_rect.size.y == 0) {
+                source_rect.size.y = tex_size.y;
+            }
+
+            if (dest_rect.size.x == 0) {
+                dest_rect.size.x = source_rect.size.x;
+            }
+
+            if (dest_rect.size.y == 0) {
+                dest_rect.size.y = source_rect.size.y;
+            }
+
+            const GLfloat x0 = static_cast<GLfloat>(dest_rect.top.x);
+            const GLfloat y0 = static_cast<GLfloat>(dest_rect.top.y);
+            const GLfloat x1 = static_cast<GLfloat>(dest_rect.top.x + dest_rect.size.x);
+            const GLfloat y1 = static_cast<GLfloat>(dest_rect.top.y + dest_rect.size.y);
+
+            const GLfloat u0 = source_rect.top.x * texel_width;
+            const GLfloat v0 = source_rect.top.y * texel_height;
+            const GLfloat u1 = (source_rect.top.x + source_rect.size.x) * texel_width;
+            const GLfloat v1 = (source_rect.top.y + source_rect.size.y) * texel_height;
+
+            const GLfloat quad[] = {
+                x0, y0, u0, v0,
+                x1, y0, u1, v0,
+                x0, y1, u0, v1,
+                x1, y0, u1, v0,
+                x1, y1, u1, v1,
+                x0, y1, u0, v1
+            };
+
+            std::copy(quad, quad + sizeof(quad) / sizeof(GLfloat), vert);
+            vert += sizeof(quad) / sizeof(GLfloat);
+        }
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(bmp->tex->texture_handle()));
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);    
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        const glm::mat4 model_matrix = glm::identity<glm::mat4>();
+
+        glUniformMatrix4fv(model_loc, 1, false, glm::value_ptr(model_matrix));
+        glUniformMatrix4fv(proj_loc, 1, false, glm::value_ptr(projection_matrix));
+
+        const GLfloat color[] = { 255.0f, 255.0f, 255.0f, 255.0f };
+
+        if (flags & bitmap_draw_flag_use_brush) {
+            glUniform4fv(color_loc, 1, brush_color.elements.data());
+        } else {
+            glUniform4fv(color_loc, 1, color);
+        }
+
+        glBindVertexArray(sprite_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, sprite_vbo);
+        glBufferData(GL_ARRAY_BUFFER, batch_verts.size() * sizeof(GLfloat), batch_verts.data(), GL_STREAM_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid *)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid *)(2 * sizeof(GLfloat)));
+
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(count * 6));
+
+        glBindVertexArray(0);
+    }
+
     void ogl_graphics_driver::set_invalidate(command_helper &helper) {
         bool enable = false;
         helper.pop(enable);
@@ -557,7 +668,11 @@ namespace eka2l1::drivers {
     }
 
     void ogl_graphics_driver::submit_command_list(graphics_command_list &command_list) {
-        list_queue.push(static_cast<server_graphics_command_list &>(command_list));
+        server_graphics_command_list &server_list = static_cast<server_graphics_command_list &>(command_list);
+        list_queue.push(server_list);
+
+        // The driver owns the commands now. Leave the list empty so it can be filled again.
+        server_list.list_.reset();
     }
 
     void ogl_graphics_driver::display(command_helper &helper) {
@@ -574,6 +689,11 @@ namespace eka2l1::drivers {
             break;
         }
 
+        case graphics_driver_draw_bitmaps: {
+            draw_bitmaps(helper);
+            break;
+        }
+
         case graphics_driver_set_invalidate: {
             set_invalidate(helper);
             break;
@@ -655,17 +775,14 @@ namespace eka2l1::drivers {
             }
 
             command *cmd = list->list_.first_;
-            command *next = nullptr;
 
             while (cmd) {
                 dispatch(cmd);
-                next = cmd->next_;
-
-                // TODO: If any command list requires not rebuilding the buffer, dont delete the command.
-                // For now, not likely
-                delete cmd;
-                cmd = next;
+                cmd = cmd->next_;
             }
+
+            // Recycle the commands and their payload for the next lists
+            list->list_.release();
         }
     }
 
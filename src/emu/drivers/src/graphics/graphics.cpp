@@ -17,6 +17,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <drivers/graphics/backend/null/graphics_null.h>
 #include <drivers/graphics/backend/ogl/graphics_ogl.h>
 #include <drivers/graphics/graphics.h>
 
@@ -55,6 +56,10 @@ namespace eka2l1::drivers {
             return std::make_unique<ogl_graphics_driver>();
         }
 
+        case graphic_api::null: {
+            return std::make_unique<null_graphics_driver>();
+        }
+
         default:
             break;
         }
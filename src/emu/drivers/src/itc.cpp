@@ -50,8 +50,8 @@ namespace eka2l1::drivers {
         return send_sync_command_detail(drv, cmd);
     }
 
-    static void *make_data_copy(const void *source, const std::size_t size) {
-        std::uint8_t *copy = new std::uint8_t[size];
+    static void *make_data_copy(command_list &list, const void *source, const std::size_t size) {
+        std::uint8_t *copy = reinterpret_cast<std::uint8_t *>(list.allocate_payload(size));
         std::copy(reinterpret_cast<const std::uint8_t *>(source), reinterpret_cast<const std::uint8_t *>(source) + size, copy);
 
         return copy;
@@ -158,15 +158,38 @@ namespace eka2l1::drivers {
     void server_graphics_command_list_builder::update_bitmap(drivers::handle h, const int bpp, const char *data, const std::size_t size,
         const eka2l1::vec2 &offset, const eka2l1::vec2 &dim) {
         // Copy data
-        command *cmd = make_command(graphics_driver_update_bitmap, nullptr, h, make_data_copy(data, size), bpp, size, offset, dim);
+        command *cmd = make_command(graphics_driver_update_bitmap, nullptr, h, make_data_copy(get_command_list(), data, size), bpp, size, offset, dim);
         get_command_list().add(cmd);
     }
 
+    void *server_graphics_command_list_builder::update_bitmap_buffer(drivers::handle h, const int bpp, const std::size_t size,
+        const eka2l1::vec2 &offset, const eka2l1::vec2 &dim) {
+        void *data = get_command_list().allocate_payload(size);
+
+        command *cmd = make_command(graphics_driver_update_bitmap, nullptr, h, data, bpp, size, offset, dim);
+        get_command_list().add(cmd);
+
+        return data;
+    }
+
     void server_graphics_command_list_builder::draw_bitmap(drivers::handle h, drivers::handle maskh, const eka2l1::rect &dest_rect, const eka2l1::rect &source_rect, const std::uint32_t flags) {
         command *cmd = make_command(graphics_driver_draw_bitmap, nullptr, h, maskh, dest_rect, source_rect, flags);
         get_command_list().add(cmd);
     }
 
+    void server_graphics_command_list_builder::draw_bitmaps(drivers::handle h, const eka2l1::rect *dest_rects, const eka2l1::rect *source_rects,
+        const std::uint32_t count, const std::uint32_t flags) {
+        if (count == 0) {
+            return;
+        }
+
+        void *dest_copy = make_data_copy(get_command_list(), dest_rects, count * sizeof(eka2l1::rect));
+        void *source_copy = make_data_copy(get_command_list(), source_rects, count * sizeof(eka2l1::rect));
+
+        command *cmd = make_command(graphics_driver_draw_bitmaps, nullptr, h, dest_copy, source_copy, count, flags);
+        get_command_list().add(cmd);
+    }
+
     void server_graphics_command_list_builder::bind_bitmap(const drivers::handle h) {
         command *cmd = make_command(graphics_driver_bind_bitmap, nullptr, h);
         get_command_list().add(cmd);
@@ -191,7 +214,7 @@ namespace eka2l1::drivers {
 
     void server_graphics_command_list_builder::set_uniform(drivers::handle h, const int binding, const drivers::shader_set_var_type var_type,
         const void *data, const std::size_t data_size) {
-        const void *uniform_data = make_data_copy(data, data_size);
+        const void *uniform_data = make_data_copy(get_command_list(), data, data_size);
 
         command *cmd = make_command(graphics_driver_set_uniform, nullptr, h, var_type, uniform_data, binding);
         get_command_list().add(cmd);
@@ -220,7 +243,7 @@ namespace eka2l1::drivers {
             total_chunk_size += chunk_size[i];
         }
 
-        std::uint8_t *data = new std::uint8_t[total_chunk_size];
+        std::uint8_t *data = reinterpret_cast<std::uint8_t *>(get_command_list().allocate_payload(total_chunk_size));
 
         for (int i = 0; i < chunk_count; i++) {
             std::copy(reinterpret_cast<const std::uint8_t *>(chunk_ptr[i]), reinterpret_cast<const std::uint8_t *>(chunk_ptr[i]) + chunk_size[i], data + cursor);
@@ -273,7 +296,7 @@ namespace eka2l1::drivers {
 
     void server_graphics_command_list_builder::attach_descriptors(drivers::handle h, const int stride, const bool instance_move,
         const attribute_descriptor *descriptors, const int descriptor_count) {
-        void *des = make_data_copy(descriptors, descriptor_count * sizeof(attribute_descriptor));
+        void *des = make_data_copy(get_command_list(), descriptors, descriptor_count * sizeof(attribute_descriptor));
         command *cmd = make_command(graphics_driver_attach_descriptors, nullptr, h, stride, instance_move, des, descriptor_count);
         get_command_list().add(cmd);
     }
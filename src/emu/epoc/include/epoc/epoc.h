@@ -73,6 +73,17 @@ namespace eka2l1 {
 
     class system_impl;
 
+    /**
+     * \brief Counters of the work done by the system since it was created.
+     * 
+     * Rates are obtained by sampling the counters at two points in time.
+     */
+    struct system_stats {
+        std::uint64_t instructions;         ///< Guest instructions executed.
+        std::uint64_t ipc_messages;         ///< IPC messages sent by guest threads.
+        std::uint64_t frames;               ///< Screen frames redrawn by the window server.
+    };
+
     /*! A system instance, where all the magic happens. 
      *
      * Represents the Symbian system. You can switch the system version dynamiclly.
@@ -110,7 +121,43 @@ namespace eka2l1 {
         int loop();
         void shutdown();
 
-        void do_state(common::chunkyseri &seri);
+        /**
+         * \brief Get the throughput counters of the system.
+         * 
+         * Should be called from the thread running the loop.
+         */
+        system_stats get_stats();
+
+        /**
+         * \brief Save or restore the state of the system.
+         * 
+         * On restore, nothing is changed unless the whole state matches the system.
+         * 
+         * \returns False if the state can't be saved or restored.
+         */
+        bool do_state(common::chunkyseri &seri);
+
+        /**
+         * \brief Save the state of the system to a file.
+         * 
+         * Must be called while the CPU is not running, such as between two loops. The state
+         * is compressed and written in the background once this returns.
+         * 
+         * \returns False if the state can't be queued for writing.
+         */
+        bool save_state(const std::string &path);
+
+        /**
+         * \brief Restore the state of the system from a file.
+         * 
+         * Only the clock, committed chunk memory and thread contexts are restored. Other kernel
+         * objects, server state and pending timing events stay as they are in this session. The
+         * system must already have the same kernel objects as when the state was saved, such as
+         * after booting and launching the same app, else the state is rejected.
+         * 
+         * \returns True on success.
+         */
+        bool load_state(const std::string &path);
 
         manager_system *get_manager_system();
         memory_system *get_memory_system();
@@ -75,6 +75,8 @@ namespace eka2l1 {
         class session;
     }
 
+    struct ipc_msg_queue;
+
     enum class ipc_message_status {
         delivered,
         accepted,
@@ -104,7 +106,14 @@ namespace eka2l1 {
             MSG_ATTRIB_LOCK_FREE = 0x1
         };
 
-        bool free : true;
+        bool free = true;
+
+        ipc_msg *next_free = nullptr;           ///< Next free slot in the kernel pool.
+
+        // Links in the queue the message is waiting in
+        ipc_msg_queue *queued_in = nullptr;
+        ipc_msg *queue_prev = nullptr;
+        ipc_msg *queue_next = nullptr;
 
         void lock_free() {
             attrib |= MSG_ATTRIB_LOCK_FREE;
@@ -123,5 +132,32 @@ namespace eka2l1 {
             : own_thr(own) {}
     };
 
-    using ipc_msg_ptr = std::shared_ptr<ipc_msg>;
+    /*! \brief Messages are owned by the kernel pool and live as long as the kernel does. */
+    using ipc_msg_ptr = ipc_msg *;
+
+    /**
+     * \brief FIFO of messages, linked through the messages themselves.
+     *
+     * A message can wait in one queue at a time. Nothing is allocated when queueing.
+     */
+    struct ipc_msg_queue {
+        ipc_msg *head = nullptr;
+        ipc_msg *tail = nullptr;
+
+        bool empty() const {
+            return head == nullptr;
+        }
+
+        bool contains(const ipc_msg *msg) const {
+            return msg->queued_in == this;
+        }
+
+        void push_back(ipc_msg *msg);
+        ipc_msg *pop_front();
+        ipc_msg *pop_back();
+        void remove(ipc_msg *msg);
+
+        /*! \brief Unlink all messages in the queue. */
+        void clear();
+    };
 }
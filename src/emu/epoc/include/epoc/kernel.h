@@ -26,6 +26,7 @@
 #include <epoc/kernel/library.h>
 #include <epoc/kernel/mutex.h>
 #include <epoc/kernel/object_ix.h>
+#include <epoc/kernel/object_name_index.h>
 #include <epoc/kernel/process.h>
 #include <epoc/kernel/scheduler.h>
 #include <epoc/kernel/sema.h>
@@ -34,17 +35,21 @@
 #include <epoc/services/property.h>
 #include <epoc/services/server.h>
 #include <epoc/services/session.h>
+#include <epoc/services/worker.h>
 
 #include <common/hash.h>
+#include <common/queue.h>
 
 #include <epoc/ipc.h>
 #include <epoc/ptr.h>
 
 #include <atomic>
 #include <exception>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 
 namespace eka2l1 {
@@ -128,14 +133,37 @@ namespace eka2l1 {
         class chunkyseri;
     }
 
+    /**
+     * \brief Kernel state read from a save state, before it is applied.
+     */
+    struct kernel_save_data {
+        std::uint32_t uid_counter;
+
+        std::vector<std::pair<kernel::chunk *, mem::chunk_save_data>> chunks;
+        std::vector<std::pair<kernel::thread *, kernel::thread_save_data>> threads;
+    };
+
     class kernel_system {
         friend class debugger_base;
         friend class imgui_debugger;
         friend class gdbstub;
         friend class kernel::process;
+        friend class kernel::kernel_obj;
 
         /* Kernel objects map */
-        std::array<ipc_msg_ptr, 0x1000> msgs;
+
+        // Message slots. The index of a slot is the handle the guest sees. Slots are handed
+        // out in order first, then reused through the freelist.
+        std::array<ipc_msg, 0x1000> msgs;
+        ipc_msg *free_msgs = nullptr;
+        std::uint32_t msgs_used = 0;
+        std::atomic<std::uint64_t> msgs_created { 0 };
+
+        // Work handed back by host threads, run on the emulation thread
+        service::emulation_call_queue host_calls;
+        std::atomic<std::thread::id> emulation_thread;
+
+        std::unique_ptr<service::server_worker_pool> server_workers;
 
         /* End kernel objects map */
         std::mutex kern_lock;
@@ -155,6 +183,9 @@ namespace eka2l1 {
         std::vector<kernel_obj_unq_ptr> codesegs;
         std::vector<kernel_obj_unq_ptr> timers;
 
+        //! Every object above, indexed by type and name
+        kernel::object_name_index name_index;
+
         timing_system *timing;
         manager_system *mngr;
         memory_system *mem;
@@ -174,6 +205,17 @@ namespace eka2l1 {
 
         void setup_new_process(process_ptr pr);
 
+        /*! \brief Get the list that owns objects of a type. Nullptr if the type is not managed by the kernel. */
+        std::vector<kernel_obj_unq_ptr> *get_object_list(const kernel::object_type type);
+
+        void index_object_name(kernel_obj_ptr obj) {
+            name_index.add(obj);
+        }
+
+        bool unindex_object_name(kernel_obj_ptr obj) {
+            return name_index.remove(obj);
+        }
+
     public:
         uint32_t next_uid() const;
 
@@ -234,9 +276,60 @@ namespace eka2l1 {
         ipc_msg_ptr create_msg(kernel::owner_type owner);
         ipc_msg_ptr get_msg(int handle);
 
+        /*! \brief Get the number of messages created since the kernel started. */
+        std::uint64_t total_msgs_created() const {
+            return msgs_created.load(std::memory_order_relaxed);
+        }
+
+        /*! \brief Give a message back to the pool. Locked messages are kept. */
         void free_msg(ipc_msg_ptr msg);
 
-        /*! \brief Completely destroy a message. */
+        /*! \brief Get the host threads HLE servers can run on. Null if they all run on the emulation thread. */
+        service::server_worker_pool *get_server_workers() {
+            return server_workers.get();
+        }
+
+        /*! \brief Mark the calling thread as the one running the guest. */
+        void set_emulation_thread() {
+            emulation_thread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        }
+
+        bool is_emulation_thread() const {
+            return emulation_thread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+        }
+
+        /*! \brief Run a function on the emulation thread, the next time the loop gets to it.
+         *
+         * Can be called from any thread. Functions queued from the same thread run in order.
+        */
+        void call_on_emulation_thread(std::function<void()> func);
+
+        /**
+         * \brief Write a request status of a thread and signal it.
+         *
+         * Can be called from any thread. Off the emulation thread, the completion is queued
+         * and done once the loop gets to it. The requester is not touched before that.
+         *
+         * \param requester The thread waiting for the request.
+         * \param sts       Address of the request status, in the requester's process.
+         * \param code      The result to write.
+         * \param signal    Signal the requester's request semaphore after writing.
+         */
+        void complete_request(kernel::thread *requester, eka2l1::ptr<epoc::request_status> sts,
+            const int code, const bool signal = true);
+
+        /**
+         * \brief Write a request status of a thread, found by its UID, and signal it.
+         *
+         * Can be called from any thread. The thread is only looked up on the emulation thread,
+         * nothing is done if it no longer exists by then.
+         *
+         * \param requester_uid UID of the thread waiting for the request.
+         */
+        void complete_request(const kernel::uid requester_uid, eka2l1::ptr<epoc::request_status> sts,
+            const int code, const bool signal = true);
+
+        /*! \brief Give a message back to the pool, even if it's locked. */
         void destroy_msg(ipc_msg_ptr msg);
 
         /* Fast duplication, unsafe */
@@ -254,6 +347,7 @@ namespace eka2l1 {
             }
 
             SYNCHRONIZE_ACCESS;
+            name_index.add(svr.get());
             servers.push_back(std::move(svr));
         }
 
@@ -262,6 +356,9 @@ namespace eka2l1 {
 
         kernel_obj_ptr get_kernel_obj_raw(kernel::handle handle);
 
+        /*! \brief Get a kernel object by a handle, as seen by the given thread. */
+        kernel_obj_ptr get_kernel_obj_raw(kernel::handle handle, kernel::thread *target);
+
         bool notify_prop(prop_ident_pair ident);
         bool subscribe_prop(prop_ident_pair ident, int *request_sts);
         bool unsubscribe_prop(prop_ident_pair ident);
@@ -276,7 +373,26 @@ namespace eka2l1 {
             const std::uint32_t stack_size = 0);
 
         bool should_terminate();
-        void do_state(common::chunkyseri &seri);
+
+        /**
+         * \brief Save or restore the state of kernel objects.
+         * 
+         * On restore, nothing is changed unless the whole state matches the kernel objects.
+         * 
+         * \returns False if the state can't be restored.
+         */
+        bool do_state(common::chunkyseri &seri);
+
+        /**
+         * \brief Read the kernel state, and check it against the kernel objects, without applying it.
+         * 
+         * Objects are matched by UID. Every object must be in the state, and the state must fit
+         * in them.
+         * 
+         * \returns False if the state does not match.
+         */
+        bool read_state(common::chunkyseri &seri, kernel_save_data &data);
+        void apply_state(kernel_save_data &data);
 
         codeseg_ptr pull_codeseg_by_uids(const kernel::uid uid0, const kernel::uid uid1,
             const kernel::uid uid2);
@@ -292,6 +408,10 @@ namespace eka2l1 {
             return threads;
         }
 
+        std::vector<kernel_obj_unq_ptr> &get_server_list() {
+            return servers;
+        }
+
         std::vector<kernel_obj_unq_ptr> &get_codeseg_list() {
             return codesegs;
         }
@@ -303,40 +423,16 @@ namespace eka2l1 {
             return reinterpret_cast<T*>(get_kernel_obj_raw(handle));
         }
 
+        /*! \brief Get kernel object by a handle owned by the given thread or its process.
+        */
         template <typename T>
-        T *get_by_name_and_type(const std::string &name, const kernel::object_type obj_type) {
-            switch (obj_type) {
-#define OBJECT_SEARCH(obj_type, obj_map)                                               \
-    case kernel::object_type::obj_type: {                                              \
-        auto res = std::find_if(obj_map.begin(), obj_map.end(), [&](const auto &rhs) { \
-            return name == rhs->name();                                                \
-        });                                                                            \
-        if (res == obj_map.end())                                                      \
-            return nullptr;                                                            \
-        return reinterpret_cast<T*>(res->get());                                       \
-    }
-
-                OBJECT_SEARCH(mutex, mutexes)
-                OBJECT_SEARCH(sema, semas)
-                OBJECT_SEARCH(chunk, chunks)
-                OBJECT_SEARCH(thread, threads)
-                OBJECT_SEARCH(process, processes)
-                OBJECT_SEARCH(change_notifier, change_notifiers)
-                OBJECT_SEARCH(library, libraries)
-                OBJECT_SEARCH(codeseg, codesegs)
-                OBJECT_SEARCH(server, servers)
-                OBJECT_SEARCH(prop, props)
-                OBJECT_SEARCH(prop_ref, prop_refs)
-                OBJECT_SEARCH(session, sessions)
-                OBJECT_SEARCH(timer, timers)
-
-#undef OBJECT_SEARCH
-
-            default:
-                break;
-            }
+        T *get(const kernel::handle handle, kernel::thread *target) {
+            return reinterpret_cast<T*>(get_kernel_obj_raw(handle, target));
+        }
 
-            return nullptr;
+        template <typename T>
+        T *get_by_name_and_type(const std::string &name, const kernel::object_type obj_type) {
+            return reinterpret_cast<T*>(name_index.find(name, obj_type));
         }
 
         /*! \brief Get kernel object by name
@@ -412,6 +508,7 @@ namespace eka2l1 {
             #define ADD_OBJECT_TO_CONTAINER(type, container, additional_setup)           \
             case type:                                                                   \
                 additional_setup;                                                        \
+                name_index.add(obj.get());                                               \
                 container.push_back(std::move(obj));                                     \
                 return reinterpret_cast<T*>(container.back().get());
 
@@ -154,6 +154,13 @@ namespace eka2l1 {
             const std::size_t committed() const;
 
             void *host_base();
+
+            /*! \brief Save the committed memory of the chunk. */
+            void do_state(common::chunkyseri &seri) override;
+
+            /*! \brief Read the committed memory of the chunk from a state, without applying it. */
+            bool read_state(common::chunkyseri &seri, mem::chunk_save_data &data);
+            void apply_state(const mem::chunk_save_data &data);
         };
     }
 }
@@ -23,6 +23,8 @@
 #include <common/types.h>
 
 #include <epoc/ptr.h>
+
+#include <array>
 #include <functional>
 #include <map>
 #include <memory>
@@ -68,12 +70,39 @@ namespace eka2l1 {
     }
 
     namespace hle {
+        using import_func = void (*)(system *);
+
         struct epoc_import_func {
-            std::function<void(system *)> func;
+            import_func func;
             std::string name;
         };
 
         using func_map = std::unordered_map<uint32_t, eka2l1::hle::epoc_import_func>;
+
+        enum {
+            SVC_DISPATCH_CLASS_SIZE = 0x100,                                ///< Number of ordinals in an executive call class.
+            SVC_DISPATCH_TABLE_SIZE = SVC_DISPATCH_CLASS_SIZE * 2           ///< Slow executive calls first, then fast ones.
+        };
+
+        struct svc_dispatch_entry {
+            import_func func { nullptr };
+            const std::string *name { nullptr };
+        };
+
+        struct svc_call_stat {
+            std::uint64_t calls { 0 };
+            std::uint64_t host_time_ns { 0 };
+        };
+
+        /*! \brief Get index of a SVC in the dispatch table.
+         * \returns -1 if the SVC ordinal can't be densely indexed.
+        */
+        int svc_dispatch_index(const sid svcnum);
+
+        struct lib_path_cache_stat {
+            std::uint64_t hits { 0 };
+            std::uint64_t misses { 0 };
+        };
         using export_table = std::vector<std::uint32_t>;
         using symbols = std::vector<std::string>;
 
@@ -92,10 +121,27 @@ namespace eka2l1 {
             std::unordered_map<std::string, symbols> lib_symbols;
 
             bool log_svc{ false };
+            bool profile_svc{ false };
+
+            std::array<svc_dispatch_entry, SVC_DISPATCH_TABLE_SIZE> svc_table;
+            std::array<svc_call_stat, SVC_DISPATCH_TABLE_SIZE> svc_stats;
+
+            // Library name (lowercased) -> Path it was found at. Empty path if it was not found on any drive.
+            std::unordered_map<std::u16string, std::u16string> lib_path_cache;
+            std::uint32_t lib_path_cache_generation{ 0 };
+            lib_path_cache_stat lib_path_stats;
+
+            /*! \brief Search all drives for a library, through the path cache.
+             * \returns The full path of the library, or an empty string if it doesn't exist.
+            */
+            std::u16string resolve_lib_path(const std::u16string &name);
 
         protected:
             void load_patch_libraries(const std::string &patch_folder);
 
+            /*! \brief Call a SVC with tracing, profiling and scripting hooks. */
+            void call_svc_hooked(const sid svcnum, const int idx);
+
         public:
             std::unordered_map<sid, epoc_import_func> svc_funcs;
 
@@ -119,6 +165,30 @@ namespace eka2l1 {
 			*/
             bool call_svc(sid svcnum);
 
+            /*! \brief Register HLE system calls, and resolve them into the dispatch table. */
+            void register_svcs(const func_map &funcs);
+
+            /*! \brief Enable or disable counting calls and host time of each system call. */
+            void set_svc_profiling(const bool enable);
+
+            /*! \brief Enable or disable tracing every system call.
+             *
+             * The flag is read from the config when the dispatch table is built. Call this
+             * when the config value changes afterwards.
+            */
+            void set_svc_logging(const bool enable);
+
+            /*! \brief Get the number of calls and host time spent of a system call. */
+            svc_call_stat get_svc_stat(const sid svcnum) const;
+
+            /*! \brief Log all system calls that have been profiled, most expensive first. */
+            void log_svc_stats();
+
+            /*! \brief Get the hit and miss count of the library path cache. */
+            lib_path_cache_stat get_lib_path_cache_stat() const {
+                return lib_path_stats;
+            }
+
             /*! \brief Load a codeseg/library/exe from name
              *
              * If the manager detects we are loading a library and a HLE module is available,
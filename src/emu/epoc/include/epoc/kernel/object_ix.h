@@ -4,6 +4,7 @@
 #include <epoc/kernel/kernel_obj.h>
 
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -39,30 +40,70 @@ namespace eka2l1 {
             kernel
         };
 
+        enum {
+            OBJECT_IX_SEGMENT_SIZE = 0x100,                                         ///< Number of slots allocated at once when the table grows.
+            OBJECT_IX_MAX_SLOTS = 0x8000,                                           ///< Index field of a handle is 15 bits.
+            OBJECT_IX_MAX_SEGMENTS = OBJECT_IX_MAX_SLOTS / OBJECT_IX_SEGMENT_SIZE,
+            OBJECT_IX_INSTANCE_MASK = 0x1FFF                                        ///< Instance field of a handle is 13 bits.
+        };
+
         struct object_ix_record {
-            kernel_obj_ptr object;
-            uint32_t associated_handle;
-            bool free = true;
+            std::atomic<kernel_obj_ptr> object { nullptr };
+            std::atomic<std::uint32_t> associated_handle { 0 };     ///< Handle currently given out from this slot. 0 if the slot is free.
+
+            std::uint16_t instance { 0 };                           ///< Instance of the last handle given out from this slot.
+            std::int32_t next_free { -1 };                          ///< Next slot in the free list, when this slot is free.
         };
 
-        /*! \brief The ultimate object handles holder. */
+        using object_ix_segment = std::array<object_ix_record, OBJECT_IX_SEGMENT_SIZE>;
+
+        /*! \brief The ultimate object handles holder. 
+         *
+         * Slots are allocated in segments which are never moved nor freed until the table dies,
+         * so looking up an object does not need any lock. Adding and closing handles must still be
+         * serialized by the caller (the kernel lock).
+         * 
+         * Each slot remembers the handle it last gave out. A handle whose slot has since been closed
+         * and reused has a different instance, and is rejected as stale.
+        */
         class object_ix {
             uint64_t uid;
 
-            size_t next_instance;
+            std::array<std::atomic<object_ix_segment *>, OBJECT_IX_MAX_SEGMENTS> segments;
+            std::uint32_t segment_count;
+
+            std::int32_t free_head;
 
-            std::array<object_ix_record, 0x100> objects;
             std::vector<std::uint32_t> handles;
 
             handle_array_owner owner;
 
-            uint32_t make_handle(size_t index);
+            uint32_t make_handle(size_t index, const std::uint16_t instance);
 
             kernel_system *kern;
 
+            object_ix_record *get_record(const std::uint32_t index) const;
+
+            /*! \brief Allocate one more segment of slots, and put them on the free list.
+             * \returns False if the table has reached its maximum size.
+            */
+            bool grow();
+
+            /*! \brief Relink every free slot, lowest index first. */
+            void rebuild_free_list();
+
+            void free_segments();
+
         public:
-            object_ix() {}
+            object_ix();
             object_ix(kernel_system *kern, handle_array_owner owner);
+            ~object_ix();
+
+            object_ix(const object_ix &) = delete;
+            object_ix &operator=(const object_ix &) = delete;
+
+            object_ix(object_ix &&rhs);
+            object_ix &operator=(object_ix &&rhs);
 
             void do_state(common::chunkyseri &seri);
 
@@ -77,7 +118,7 @@ namespace eka2l1 {
             std::uint32_t duplicate(uint32_t handle);
 
             /*! \brief Get the kernel object reference by the handle. 
-                \returns The kernel object referenced. Nullptr if there is none found.
+                \returns The kernel object referenced. Nullptr if there is none found, or the handle is stale.
             */
             kernel_obj_ptr get_object(uint32_t handle);
 
@@ -87,6 +128,11 @@ namespace eka2l1 {
                 return uid;
             }
 
+            /*! \brief Get the number of slots the table can currently hold without growing. */
+            std::size_t capacity() const {
+                return segment_count * OBJECT_IX_SEGMENT_SIZE;
+            }
+
             /*! \brief Get the last handle created. 0 if none left */
             std::uint32_t last_handle();
         };
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <epoc/kernel/kernel_obj.h>
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+namespace eka2l1::kernel {
+    /**
+     * \brief Hashed index of kernel objects, by object type and name.
+     * 
+     * Names are hashed lowercased, so both exact lookups and case-insensitive
+     * Symbian-style matches can use the index. Exact lookups still compare the original case.
+     */
+    class object_name_index {
+        using name_map = std::unordered_multimap<std::string, kernel_obj *>;
+
+        std::array<name_map, static_cast<std::size_t>(object_type::unk) + 1> maps;
+        std::size_t count { 0 };
+
+        name_map *get_map(const object_type type);
+        const name_map *get_map(const object_type type) const;
+
+    public:
+        /*! \brief Add an object to the index, under its current name. */
+        void add(kernel_obj *obj);
+
+        /*! \brief Remove an object from the index. 
+         * \returns False if the object was not in the index.
+        */
+        bool remove(kernel_obj *obj);
+
+        /**
+         * \brief Find an object with exactly this name.
+         * 
+         * \param name Name of the object, not the full name.
+         * \param type Type of the object.
+         * 
+         * \returns The object with the lowest unique id, if many share the name. Nullptr if none.
+         */
+        kernel_obj *find(const std::string &name, const object_type type) const;
+
+        /**
+         * \brief Call a function with each object whose name equals the given one, ignoring case.
+         */
+        template <typename F>
+        void for_each_folded_match(const std::string &name, const object_type type, F func) const;
+
+        std::size_t size() const {
+            return count;
+        }
+
+        void clear();
+    };
+
+    std::string fold_object_name(const std::string &name);
+
+    template <typename F>
+    void object_name_index::for_each_folded_match(const std::string &name, const object_type type, F func) const {
+        const name_map *map = get_map(type);
+
+        if (!map) {
+            return;
+        }
+
+        const auto range = map->equal_range(fold_object_name(name));
+
+        for (auto ite = range.first; ite != range.second; ite++) {
+            func(ite->second);
+        }
+    }
+}
@@ -50,6 +50,12 @@ namespace eka2l1 {
 
         using uid = std::uint32_t;
 
+        struct context_switch_stat {
+            std::uint64_t thread_switches { 0 };
+            std::uint64_t process_switches { 0 };          ///< Switches that also changed the address space.
+            std::uint64_t process_switch_host_ns { 0 };    ///< Host time spent changing address space.
+        };
+
         class thread_scheduler {
             kernel::thread *readys[64];
             std::uint32_t ready_mask[2] { 0, 0 };
@@ -68,6 +74,8 @@ namespace eka2l1 {
             timing_system *timing;
             kernel_system *kern;
 
+            context_switch_stat switch_stat;
+
         protected:
             kernel::thread *next_ready_thread();
             void switch_context(kernel::thread *oldt, kernel::thread *newt);
@@ -99,6 +107,11 @@ namespace eka2l1 {
             kernel::process *current_process() const {
                 return crr_process;
             }
+
+            /*! \brief Get the number of context switches done, and the cost of address space switches. */
+            const context_switch_stat &get_context_switch_stat() const {
+                return switch_stat;
+            }
         };
     }
 }
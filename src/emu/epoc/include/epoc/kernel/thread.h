@@ -121,6 +121,21 @@ namespace eka2l1 {
             std::string func_name;
         };
 
+        /**
+         * \brief CPU context and bookkeeping of a thread, read from a state but not applied yet.
+         */
+        struct thread_save_data {
+            arm::arm_interface::thread_context ctx;
+
+            std::uint32_t flags;
+            int leave_depth;
+            int exit_reason;
+            int rendezvous_reason;
+            std::uint64_t lrt;
+            int time;
+            int timeslice;
+        };
+
         class thread : public kernel_obj {
             friend class eka2l1::kernel_system;
 
@@ -338,6 +353,13 @@ namespace eka2l1 {
             std::uint32_t last_handle() {
                 return thread_handles.last_handle();
             }
+
+            /*! \brief Save the CPU context and bookkeeping of the thread. */
+            void do_state(common::chunkyseri &seri) override;
+
+            /*! \brief Read the CPU context and bookkeeping of the thread from a state, without applying it. */
+            bool read_state(common::chunkyseri &seri, thread_save_data &data);
+            void apply_state(const thread_save_data &data);
         };
 
         using thread_ptr = kernel::thread*;
@@ -25,10 +25,27 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <utility>
+#include <vector>
+
+namespace eka2l1::common {
+    class chunkyseri;
+}
 
 namespace eka2l1::mem {
     class mmu_base;
 
+    /**
+     * \brief Committed region of a chunk, read from a state but not applied yet.
+     */
+    struct chunk_save_data {
+        vm_address bottom;
+        vm_address top;
+
+        std::vector<std::pair<vm_address, std::size_t>> runs;       ///< Committed offset and size.
+        std::vector<std::uint8_t *> run_data;                       ///< Content of each run, inside the state buffer.
+    };
+
     struct mem_model_chunk {
         prot permission_;
     protected:
@@ -81,6 +98,25 @@ namespace eka2l1::mem {
          * This is support for some JIT's context switching.
          */
         virtual void map_to_cpu() = 0;
+
+        /**
+         * \brief Save the committed region and its content.
+         */
+        virtual void do_state(common::chunkyseri &seri) = 0;
+
+        /**
+         * \brief Read the committed region and its content from a state, without applying it.
+         * 
+         * \returns False if the state does not fit this chunk.
+         */
+        virtual bool read_state(common::chunkyseri &seri, chunk_save_data &data) = 0;
+
+        /**
+         * \brief Restore the committed region read from a state.
+         * 
+         * Pages committed now but not in the state are decommitted.
+         */
+        virtual void apply_state(const chunk_save_data &data) = 0;
     };
 
     using mem_model_chunk_impl = std::unique_ptr<mem_model_chunk>;
@@ -62,8 +62,22 @@ namespace eka2l1::mem {
 
         virtual ~mmu_base() {}
 
-        void map_to_cpu(const vm_address addr, const std::size_t size, void *ptr, const prot perm);
-        void unmap_from_cpu(const vm_address addr, const std::size_t size);
+        /**
+         * \brief Map host memory to the CPU.
+         * 
+         * \param id  The address space the memory belongs to. 0 for memory visible to all address spaces.
+         *            Only matters if the CPU keeps page tables per address space.
+         */
+        void map_to_cpu(const asid id, const vm_address addr, const std::size_t size, void *ptr, const prot perm);
+        void unmap_from_cpu(const asid id, const vm_address addr, const std::size_t size);
+
+        /**
+         * \brief Check if the CPU keeps a page table per address space.
+         * 
+         * If true, memory of any address space can be mapped to the CPU at any time, and switching
+         * address space does not need remapping.
+         */
+        bool cpu_has_addr_space_tables() const;
 
         /**
          * \brief Get number of bytes a page occupy
@@ -106,6 +120,13 @@ namespace eka2l1::mem {
          */
         virtual asid rollover_fresh_addr_space() = 0;
 
+        /**
+         * \brief Give back an address space, so its ID can be reused.
+         * 
+         * \param id The ASID returned by rollover_fresh_addr_space.
+         */
+        virtual void free_addr_space(const asid id) = 0;
+
         /**
          * \brief Set current MMU's address space.
          * 
@@ -51,6 +51,22 @@ namespace eka2l1::mem {
 
         void do_selection_cpu_memory_manipulation(const bool unmap);
 
+        /**
+         * \brief Get the address space to map this chunk's memory to on the CPU.
+         * \returns ASID of the owner process if the chunk is local, else 0 (global).
+         */
+        asid cpu_addr_space() const;
+
+        /**
+         * \brief Check if commits and decommits of this chunk should be reflected to the CPU right away.
+         */
+        bool should_map_to_cpu() const;
+
+        /**
+         * \brief Get runs of committed pages, as pairs of offset and size.
+         */
+        std::vector<std::pair<vm_address, std::size_t>> committed_runs();
+
     public:
         bool is_local { false };
         bool is_external_host { false };
@@ -91,5 +107,9 @@ namespace eka2l1::mem {
         
         void unmap_from_cpu() override;
         void map_to_cpu() override;
+
+        void do_state(common::chunkyseri &seri) override;
+        bool read_state(common::chunkyseri &seri, chunk_save_data &data) override;
+        void apply_state(const chunk_save_data &data) override;
     };
 }
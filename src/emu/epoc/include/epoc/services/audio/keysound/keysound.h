@@ -23,6 +23,7 @@
 #include <epoc/services/framework.h>
 
 #include <drivers/audio/stream.h>
+#include <drivers/audio/tone.h>
 
 #include <memory>
 #include <stack>
@@ -46,8 +47,11 @@ namespace eka2l1 {
             std::uint32_t duration_unit_;
 
             std::size_t parser_pos_;
+            bool tone_played_;
             epoc::keysound::sound_info sound_;
 
+            drivers::tone_generator tone_;
+
             explicit parser_state();
         } state_;
 
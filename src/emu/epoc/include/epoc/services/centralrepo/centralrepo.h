@@ -42,6 +42,19 @@ namespace eka2l1 {
 	*/
     bool parse_new_centrep_ini(const std::string &path, central_repo &repo);
 
+    /*! \brief Load a centrep ini file, through a compiled binary cache.
+     *
+     * The cache holds the parsed repo, tagged with the source path, size and last modification time.
+     * If the tag still matches the ini file, the cache is mapped and loaded without touching the ini parser.
+     * Else the ini is parsed, and the cache is rewritten.
+     * 
+     * \param path         Host path of the ini file.
+     * \param cache_folder Host folder to store compiled repos in.
+     * 
+     * \returns False if IO error or invalid centrep configs.
+    */
+    bool load_centrep_ini_cached(const std::string &path, const std::string &cache_folder, central_repo &repo);
+
     class central_repo_server;
 
     struct central_repo_client_session {
@@ -82,6 +95,8 @@ namespace eka2l1 {
 
         bool first_repo = true;
 
+        std::string compiled_ini_folder;        ///< Host folder of compiled ini repos.
+
     protected:
         void rescan_drives(eka2l1::io_system *io);
 
@@ -52,7 +52,6 @@ namespace eka2l1 {
         std::uint64_t intd;
         double reald;
         std::string strd;
-        std::u16string str16d;
     };
 
     struct central_repo_entry {
@@ -99,7 +98,7 @@ namespace eka2l1 {
 
         std::uint32_t owner_uid;
 
-        std::vector<central_repo_entry> entries;
+        std::vector<central_repo_entry> entries;            ///< Sorted by key. Call sort_entries() after filling it directly.
         std::vector<central_repo_client_subsession *> attached;
 
         central_repo_entry_access_policy default_policy;
@@ -115,6 +114,9 @@ namespace eka2l1 {
 
         central_repo_entry *find_entry(const std::uint32_t key);
 
+        /*! \brief Restore the key order of entries, after they were filled without add_new_entry. */
+        void sort_entries();
+
         std::uint32_t get_default_meta_for_new_key(const std::uint32_t key);
 
         bool add_new_entry(const std::uint32_t key, const central_repo_entry_variant &var);
@@ -145,10 +147,13 @@ namespace eka2l1 {
          * 
          * As you can see, the one that match our description is 0x07B10B52
          * 
+         * Entries are sorted by key, so only the range of keys sharing the leading masked bits
+         * of the partial key is walked.
+         * 
          * \param partial_key     The bit pattern to be matched.
          * \param mask            The mask that requires which bit is mandatory.
          * \param matched_entries Reference to vector containing entries.
-         * \param etype           The type of all the entries to be matched.
+         * \param etype           The type of all the entries to be matched. None to match entries of any type.
          */
         void query_entries(const std::uint32_t partial_key, const std::uint32_t mask,
             std::vector<central_repo_entry*> &matched_entries, 
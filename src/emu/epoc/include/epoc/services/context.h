@@ -24,6 +24,7 @@
 #include <common/log.h>
 
 #include <epoc/ipc.h>
+#include <epoc/kernel/kernel_obj.h>
 #include <epoc/ptr.h>
 
 #include <cstring>
@@ -61,6 +62,10 @@ namespace eka2l1 {
             bool auto_free = false;     ///< Auto free this message when the context is destroyed. Useful 
                                         ///< for HLE context.
 
+            kernel::uid requester_uid = 0;  ///< UID of the message's thread, taken on the emulation thread.
+                                            ///< When set, the request is completed by looking the thread up
+                                            ///< again on the emulation thread. Used by server workers.
+
             /**
              * \brief   Get raw IPC argument data.
              * 
@@ -148,6 +153,20 @@ namespace eka2l1 {
              */
             std::size_t get_arg_size(int idx);
 
+            /**
+             * \brief   Get the maximum size in bytes that a descriptor IPC argument can hold.
+             * 
+             * Together with get_arg_ptr, this lets a service fill the guest buffer directly,
+             * instead of building the data on host and copying it over with write_arg_pkg.
+             * 
+             * \param   idx The index of argument.
+             * \returns The maximum size of the descriptor data, in bytes.
+             *          Return size_t(-1) if index is out of range or the argument is not a descriptor.
+             * 
+             * \sa      get_arg_ptr, set_arg_des_len
+             */
+            std::size_t get_arg_max_size(int idx);
+
             /**
              * \brief   Set length of a descriptor passed as IPC argument in given index.
              * 
@@ -21,9 +21,11 @@
 #pragma once
 
 #include <epoc/services/ecom/plugin.h>
+#include <epoc/services/ecom/registry.h>
 #include <epoc/services/server.h>
 #include <epoc/utils/uid.h>
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -65,6 +67,11 @@ namespace eka2l1 {
         std::vector<ecom_implementation_info_ptr> implementations;
         std::vector<ecom_implementation_info_ptr> collected_impls;
 
+        // Implementations each drive provides, and the drive generation they were last validated at
+        std::array<ecom_drive_registry, drive_count> drive_registries;
+        std::array<std::uint32_t, drive_count> drive_generations;
+
+        std::string registry_folder;
         bool init{ false };
 
         void do_get_resolved_impl_creation_method(service::ipc_context *ctx);
@@ -81,27 +88,61 @@ namespace eka2l1 {
         bool register_implementation(const std::uint32_t interface_uid,
             ecom_implementation_info_ptr &impl);
 
-        bool load_plugins(eka2l1::io_system *io);
-        bool load_and_install_plugin_from_buffer(const std::u16string &name, std::uint8_t *buf, const std::size_t size,
-            const drive_number drv);
-
-        bool load_plugin_on_drive(eka2l1::io_system *io, const drive_number drv);
+        /**
+         * \brief Parse a plugin resource file.
+         *
+         * \param name    The path of the resource, used to name the plugin DLL.
+         * \param entries Vector to push parsed implementations into.
+         * 
+         * \returns False if the resource is not a valid plugin description.
+         */
+        bool parse_plugin_from_buffer(const std::u16string &name, std::uint8_t *buf, const std::size_t size,
+            const drive_number drv, const bool from_archive, std::vector<ecom_registry_entry> &entries);
 
-        /*
-         * \brief Search the ROM and ROFS for an archive of plugins.
+        /**
+         * \brief Search a ROM drive for archives of plugins.
          *
          * Archive are SPI file. They usually has pattern of ecom-*-*.spi or
          * ecom-*-*.sXX where XX is language code.
          * 
-         * This searchs these files on Z:\Private\10009d8f
+         * This searchs these files on <drive>:\Private\10009d8f
          * 
-         * \returns A vector contains all canidates.
+         * \returns A vector contains all canidates. Empty if the drive is not a ROM drive.
+         */
+        std::vector<std::string> get_ecom_plugin_archives(eka2l1::io_system *io, const drive_number drv);
+
+        /**
+         * \brief List plugin archives and resource files of a drive, with their size and modification time.
          */
-        std::vector<std::string> get_ecom_plugin_archives(eka2l1::io_system *io);
+        std::vector<ecom_registry_source> get_registry_sources(eka2l1::io_system *io, const drive_number drv);
 
-        /*! \brief Load archives
+        /**
+         * \brief Parse all plugin archives and resource files listed in a registry.
+         */
+        void build_drive_registry(eka2l1::io_system *io, const drive_number drv, ecom_drive_registry &reg);
+
+        /**
+         * \brief Bring the registry of a drive up to date.
+         *
+         * The registry saved on the host is reused if it was built from the same files, else
+         * the drive is parsed again and its saved registry is replaced.
+         *
+         * \returns True if the implementations of the drive changed.
+         */
+        bool load_drive_registry(eka2l1::io_system *io, const drive_number drv);
+
+        /**
+         * \brief Rebuild the interface and implementation lookup from all drive registries.
+         *
+         * Archived plugins are installed first, then plugin resources from drive A to Z.
+         * The first implementation registered with an UID wins.
+         */
+        void install_drive_registries();
+
+        /**
+         * \brief Reload registries of drives that changed since the last lookup.
          */
-        bool load_archives(eka2l1::io_system *io);
+        void sync_registry(eka2l1::io_system *io);
 
         void connect(service::ipc_context &ctx) override;
 
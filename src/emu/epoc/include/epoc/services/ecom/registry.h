@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <epoc/services/ecom/plugin.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace eka2l1 {
+    /**
+     * \brief A plugin resource file or archive that a drive registry was built from.
+     */
+    struct ecom_registry_source {
+        std::string path;
+        std::uint64_t size;
+        std::uint64_t last_write;
+        bool archive;               ///< A SPI archive of plugin resources.
+
+        bool operator==(const ecom_registry_source &rhs) const {
+            return (path == rhs.path) && (size == rhs.size) && (last_write == rhs.last_write)
+                && (archive == rhs.archive);
+        }
+
+        bool operator!=(const ecom_registry_source &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+
+    struct ecom_registry_entry {
+        std::uint32_t interface_uid;
+        ecom_implementation_info_ptr impl;
+        bool from_archive;          ///< The plugin resource came from a SPI archive.
+    };
+
+    /**
+     * \brief All implementations a drive provides, and the files they were parsed from.
+     *
+     * Entries are kept in the order the plugins were parsed. Duplicated implementations
+     * are also kept, the server resolves them when it installs the registry.
+     */
+    struct ecom_drive_registry {
+        std::vector<ecom_registry_source> sources;
+        std::vector<ecom_registry_entry> entries;
+    };
+
+    /**
+     * \brief Load a drive registry previously saved to the host.
+     *
+     * The file is memory-mapped. A file that is truncated or written by other format
+     * version is rejected.
+     *
+     * \param path Host path of the registry file.
+     * \param reg  The registry to load into. Untouched on failure.
+     *
+     * \returns True on success.
+     */
+    bool load_ecom_drive_registry(const std::string &path, ecom_drive_registry &reg);
+
+    /**
+     * \brief Save a drive registry to the host.
+     * \returns True on success.
+     */
+    bool save_ecom_drive_registry(const std::string &path, ecom_drive_registry &reg);
+}
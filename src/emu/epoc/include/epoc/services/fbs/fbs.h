@@ -28,6 +28,7 @@
 #include <epoc/services/fbs/font.h>
 #include <epoc/services/fbs/font_atlas.h>
 #include <epoc/services/fbs/font_store.h>
+#include <epoc/services/fbs/glyph_cache.h>
 #include <epoc/services/framework.h>
 #include <epoc/services/fbs/adapter/font_adapter.h>
 #include <epoc/services/window/common.h>
@@ -42,6 +43,7 @@
 #include <optional>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace eka2l1 {
     struct file;
@@ -256,7 +258,7 @@ namespace eka2l1 {
         fbs_load_data_err_read_decomp_fail
     };
 
-    class fbs_chunk_allocator : public common::block_allocator {
+    class fbs_chunk_allocator : public common::tlsf_allocator {
         chunk_ptr target_chunk;
 
     public:
@@ -292,6 +294,9 @@ namespace eka2l1 {
         epoc::open_font_session_cache_link *session_cache_link;
 
         epoc::font_store persistent_font_store;
+        std::unique_ptr<epoc::glyph_cache> glyphs;                 ///< Rasterized glyphs of all clients, in the large chunk.
+        epoc::glyph_cache_entry uncached_glyph;                    ///< Last glyph that did not fit in the cache.
+        std::vector<std::uint8_t> uncached_glyph_bitmap;
 
         void load_fonts(eka2l1::io_system *io);
 
@@ -341,6 +346,18 @@ namespace eka2l1 {
         
         fbsfont *look_for_font_with_address(const eka2l1::address addr);
 
+        /**
+         * \brief Get the bitmap and metric of a glyph, rasterizing it if it is not cached yet.
+         * 
+         * \param info  The font to rasterize with.
+         * \param code  Codepoint, or glyph index with the top bit set.
+         * 
+         * A glyph that can't be cached is still returned. It stays valid until the next call.
+         * 
+         * \returns Nullptr if the glyph is not available in the font.
+         */
+        const epoc::glyph_cache_entry *rasterize_glyph_cached(const epoc::open_font_info &info, const std::uint32_t code);
+
         std::uint8_t *get_shared_chunk_base() {
             return base_shared_chunk;
         }
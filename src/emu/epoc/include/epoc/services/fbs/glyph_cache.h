@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <epoc/services/fbs/font.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace eka2l1::common {
+    class allocator;
+}
+
+namespace eka2l1::epoc {
+    struct glyph_cache_key {
+        const void *face;               ///< The font file adapter the glyph comes from.
+        std::uint32_t face_idx;         ///< Index of the font in the file.
+        float scale_x;
+        float scale_y;
+        std::uint32_t code;             ///< Codepoint, or glyph index with the top bit set.
+
+        bool operator==(const glyph_cache_key &rhs) const {
+            return (face == rhs.face) && (face_idx == rhs.face_idx) && (scale_x == rhs.scale_x)
+                && (scale_y == rhs.scale_y) && (code == rhs.code);
+        }
+    };
+
+    struct glyph_cache_key_hasher {
+        std::size_t operator()(const glyph_cache_key &key) const;
+    };
+
+    struct glyph_cache_entry {
+        std::uint8_t *bitmap;           ///< 8bpp bitmap, owned by the cache.
+        int width;
+        int height;
+
+        glyph_bitmap_type bitmap_type;
+        open_font_character_metric metric;  ///< Metric with no baseline offset applied.
+    };
+
+    /**
+     * \brief Rasterized glyphs, shared by every client of a font and bitmap server.
+     * 
+     * Glyphs are looked up by font, size and codepoint. Bitmaps are stored with the given
+     * allocator, usually backed by a chunk. When the byte budget is reached or the allocator
+     * runs out of space, the least recently used glyphs are evicted.
+     */
+    class glyph_cache {
+        using lru_list = std::list<std::pair<glyph_cache_key, glyph_cache_entry>>;
+
+        common::allocator *alloc_;
+        std::size_t max_bytes_;
+        std::size_t used_bytes_;
+
+        lru_list lru_;                  ///< Most recently used glyph first.
+        std::unordered_map<glyph_cache_key, lru_list::iterator, glyph_cache_key_hasher> lookup_;
+
+        bool evict_last();
+
+    public:
+        explicit glyph_cache(common::allocator *alloc, const std::size_t max_bytes);
+        ~glyph_cache();
+
+        /**
+         * \brief Find a glyph, and mark it as most recently used.
+         * \returns Nullptr if the glyph is not cached.
+         */
+        const glyph_cache_entry *get(const glyph_cache_key &key);
+
+        /**
+         * \brief Copy a rasterized glyph into the cache.
+         * 
+         * \returns The new entry, or nullptr if it can't fit even in an empty cache.
+         */
+        const glyph_cache_entry *add(const glyph_cache_key &key, const std::uint8_t *bitmap, const int width,
+            const int height, const glyph_bitmap_type bitmap_type, const open_font_character_metric &metric);
+
+        void clear();
+
+        std::size_t count() const {
+            return lookup_.size();
+        }
+
+        std::size_t used_bytes() const {
+            return used_bytes_;
+        }
+    };
+}
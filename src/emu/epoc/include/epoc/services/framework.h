@@ -87,6 +87,7 @@ namespace eka2l1::service {
     class typical_server: public server {
         friend class typical_session;
         std::unordered_map<service::uid, typical_session_ptr> sessions;
+        std::mutex sessions_lock;       ///< Sessions are created on the emulation thread, used on the worker.
 
     protected:
         normal_object_container obj_con;
@@ -95,6 +96,7 @@ namespace eka2l1::service {
         ~typical_server() override;
 
         void clear_all_sessions() {
+            const std::lock_guard<std::mutex> guard(sessions_lock);
             sessions.clear();
         }
 
@@ -105,11 +107,14 @@ namespace eka2l1::service {
 
         template <typename T>
         T *session(const service::uid session_uid) {
-            if (sessions.find(session_uid) == sessions.end()) {
+            const std::lock_guard<std::mutex> guard(sessions_lock);
+            auto ss_ite = sessions.find(session_uid);
+
+            if (ss_ite == sessions.end()) {
                 return nullptr;
             }
             
-            return reinterpret_cast<T*>(&*sessions[session_uid]);
+            return reinterpret_cast<T*>(ss_ite->second.get());
         }
 
         template <typename T, typename ...Args>
@@ -118,6 +123,7 @@ namespace eka2l1::service {
             epoc::version client_version;
             client_version.u32 = ctx->get_arg<std::uint32_t>(0).value();
 
+            const std::lock_guard<std::mutex> guard(sessions_lock);
             sessions.emplace(suid, std::make_unique<T>(
                 reinterpret_cast<typical_server*>(this), suid, client_version, arguments...));
 
@@ -136,7 +142,7 @@ namespace eka2l1::service {
         }
 
         explicit typical_server(system *sys, const std::string name);
-        void process_accepted_msg() override;
+        void dispatch(service::ipc_context &ctx) override;
 
         void disconnect(service::ipc_context &ctx) override;
     };
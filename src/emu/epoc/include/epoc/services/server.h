@@ -27,6 +27,7 @@
 #include <epoc/utils/reqsts.h>
 
 #include <functional>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <unordered_map>
@@ -45,9 +46,9 @@ namespace eka2l1 {
     /*! \brief IPC implementation. */
     namespace service {
         struct server_msg;
+        class server_worker_pool;
 
         using ipc_func_wrapper = std::function<void(ipc_context&)>;
-        using ipc_msg_ptr = std::shared_ptr<ipc_msg>;
 
         /*! \brief A class represents an IPC function */
         struct ipc_func {
@@ -96,7 +97,11 @@ namespace eka2l1 {
             std::vector<session *> sessions;
 
             /** Messages that has been delivered but not accepted yet */
-            std::vector<server_msg> delivered_msgs;
+            ipc_msg_queue delivered_msgs;
+
+            /** Number of messages delivered, in total and for each opcode */
+            std::uint64_t total_delivered;
+            std::unordered_map<int, std::uint64_t> opcode_delivered;
 
             /** The thread own this server */
             //thread_ptr owning_thread;
@@ -118,6 +123,12 @@ namespace eka2l1 {
             bool hle = false;
             bool unhandle_callback_enable = false;
 
+            server_worker_pool *workers;     ///< Null when messages are handled on the emulation thread.
+            std::size_t worker_index;
+            std::mutex work_lock;
+
+            void process_accepted_msg_on_worker();
+
         protected:
             bool is_msg_delivered(ipc_msg_ptr &msg);
             bool ready();
@@ -131,6 +142,17 @@ namespace eka2l1 {
 
             virtual void on_unhandled_opcode(service::ipc_context &ctx) {}
 
+            /*! \brief Call the handler of a received message. */
+            virtual void dispatch(service::ipc_context &ctx);
+
+            /**
+             * \brief Handle messages of this server on a host worker, if the kernel has workers.
+             *
+             * Connect still runs on the emulation thread. Other handlers must only touch the
+             * server's own state, the client's memory and the file system.
+             */
+            void run_on_worker();
+
         public:
             std::uint32_t frequent_process_event;
 
@@ -173,6 +195,31 @@ namespace eka2l1 {
             bool is_hle() const {
                 return hle;
             }
+
+            bool is_on_worker() const {
+                return workers != nullptr;
+            }
+
+            /*! \brief Keep the worker of this server from handling messages while the lock is held.
+             *
+             * Needed before touching the state of a server from outside its handlers.
+            */
+            std::unique_lock<std::mutex> acquire_work_lock() {
+                return std::unique_lock<std::mutex>(work_lock);
+            }
+
+            /*! \brief Get the number of messages delivered to this server since it started.
+             *
+             * The counters are plain integers written by the emulation thread. Only read them from
+             * that thread, for example between two calls to the system loop.
+            */
+            std::uint64_t get_total_delivered() const {
+                return total_delivered;
+            }
+
+            const std::unordered_map<int, std::uint64_t> &get_opcode_delivered() const {
+                return opcode_delivered;
+            }
         };
     }
 }
@@ -28,6 +28,8 @@
 #include <epoc/services/fbs/bitmap.h>
 
 #include <array>
+#include <unordered_map>
+#include <vector>
 
 namespace eka2l1 {
     class kernel_system;
@@ -35,19 +37,29 @@ namespace eka2l1 {
 
 namespace eka2l1::epoc {
     constexpr std::uint32_t MAX_CACHE_SIZE = 1024;
+    constexpr std::int32_t DIRTY_BAND_ROWS = 16;        ///< Number of bitmap rows covered by one dirty-tracking hash.
 
     class bitmap_cache {
     public:
         using driver_texture_handle_array = std::array<drivers::handle, MAX_CACHE_SIZE>;
         using bitmap_array = std::array<epoc::bitwise_bitmap*, MAX_CACHE_SIZE>;
-        using timestamps_array = std::array<std::uint64_t, MAX_CACHE_SIZE>;
-        using hashes_array = timestamps_array;
+        using hashes_array = std::array<std::uint64_t, MAX_CACHE_SIZE>;
+        using band_hashes_array = std::array<std::vector<std::uint64_t>, MAX_CACHE_SIZE>;
+        using lru_links_array = std::array<std::int64_t, MAX_CACHE_SIZE>;
 
     private:
         driver_texture_handle_array driver_textures;
         bitmap_array                bitmaps;
-        timestamps_array            timestamps;
-        hashes_array                hashes;
+        hashes_array                hashes;             ///< Hash of the bitmap header and layout.
+        band_hashes_array           band_hashes;        ///< Hash of each band of rows of the bitmap data.
+
+        // Least recently used list of cache slots, linked by index. Head is the most recently used.
+        lru_links_array             lru_prev;
+        lru_links_array             lru_next;
+        std::int64_t                lru_head { -1 };
+        std::int64_t                lru_tail { -1 };
+
+        std::unordered_map<epoc::bitwise_bitmap*, std::int64_t> bitmap_slots;
 
         std::uint8_t *base_large_chunk;
 
@@ -56,22 +68,42 @@ namespace eka2l1::epoc {
 
         std::int64_t last_free { 0 };
 
+        void lru_unlink(const std::int64_t idx);
+        void lru_push_front(const std::int64_t idx);
+
+        void upload_bitmap(drivers::graphics_command_list_builder *builder, const std::int64_t idx,
+            epoc::bitwise_bitmap *bmp, const std::int32_t first_row, const std::int32_t row_count);
+
     protected:
         std::uint64_t hash_bitwise_bitmap(epoc::bitwise_bitmap *bw_bmp);
 
+        /**
+         * \brief   Rehash the bitmap data band by band, and find the rows that changed.
+         * 
+         * \param   idx         Cache slot of the bitmap.
+         * \param   bw_bmp      The bitmap.
+         * \param   first_row   Set to the first changed row.
+         * \param   row_count   Set to the number of rows from first_row that need reupload.
+         *                      Zero if nothing changed.
+         */
+        void find_dirty_rows(const std::int64_t idx, epoc::bitwise_bitmap *bw_bmp, std::int32_t &first_row,
+            std::int32_t &row_count);
+
     public:
         explicit bitmap_cache(kernel_system *kern_);
 
+        /**
+         * \brief   Get the index of the slot to evict, which is the least recently used one.
+         */
         std::int64_t get_suitable_bitmap_index();
 
         /**
          * \brief   Add a bitmap to texture cache if not available in the cache, and get
          *          the driver's texture handle.
          * 
-         * If the cache is full, this will find the least used bitmap (by sorting out 
-         * last used timestamp). Also, since bitwise bitmap modify itself by user's will
-         * without a method to notify the user, this also hashes bitmap data (using xxHash),
-         * and will reupload the bitmap to driver if the texture data is different.
+         * If the cache is full, the least recently used bitmap is evicted. Since bitwise bitmap
+         * data is modified by the guest without notifying us, the data is hashed in bands of
+         * DIRTY_BAND_ROWS rows (using xxHash), and only bands that differ are reuploaded.
          * 
          * \param   driver  Pointer
          * \param   bmp     The pointer to bitwise bitmap.
@@ -79,12 +111,5 @@ namespace eka2l1::epoc {
          */
         drivers::handle add_or_get(drivers::graphics_driver *driver, drivers::graphics_command_list_builder *builder,
             epoc::bitwise_bitmap *bmp);
-
-        /**
-         * \brief   Remove the bitmap from cache.
-         * \returns True if success. False if bitmap not found. Likely that the bitmap has been
-         *          purged from cache
-         */
-        bool remove(epoc::bitwise_bitmap *bmp);
     };
 }
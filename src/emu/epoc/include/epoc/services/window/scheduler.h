@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <vector>
 
@@ -84,6 +85,7 @@ namespace eka2l1::epoc {
         int callback_evt_;
 
         bool callback_scheduled_;
+        std::atomic<std::uint64_t> frames_;
 
         void schedule_scans(drivers::graphics_driver *driver);
 
@@ -124,5 +126,12 @@ namespace eka2l1::epoc {
          * \param screen_number The number of the screen.
          */
         void unschedule(const int screen_number);
+
+        /**
+         * \brief Get the number of screen redraws done since the scheduler was created.
+         */
+        std::uint64_t frames_produced() const {
+            return frames_.load(std::memory_order_relaxed);
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <common/queue.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace eka2l1 {
+    class timing_system;
+}
+
+namespace eka2l1::service {
+    /**
+     * \brief Host threads that handle messages of HLE servers off the emulation thread.
+     *
+     * A server is bound to one worker for its whole life, so its messages are still handled
+     * one at a time and in the order they were sent. Different servers run side by side.
+     */
+    class server_worker_pool {
+        using job = std::function<void()>;
+
+        struct worker {
+            request_queue<job> jobs;
+            std::thread thread;
+        };
+
+        std::vector<std::unique_ptr<worker>> workers_;
+        std::size_t next_worker_;
+
+    public:
+        explicit server_worker_pool(const std::size_t worker_count);
+        ~server_worker_pool();
+
+        /*! \brief Pick the worker for a new server. Workers are handed out in turn. */
+        std::size_t assign();
+
+        /*! \brief Queue a job on a worker. Blocks if the worker has too much queued. */
+        void post(const std::size_t worker_index, job func);
+    };
+
+    /**
+     * \brief Functions queued from any thread, to run on the emulation thread.
+     *
+     * They are run from a timing event, the next time the emulation thread advances time.
+     * Functions queued from the same thread run in the order they were queued.
+     */
+    class emulation_call_queue {
+        mpsc_queue<std::function<void()>> calls_;
+        timing_system *timing_;
+        int call_evt_;
+
+    public:
+        explicit emulation_call_queue();
+
+        /*! \brief Register the timing event that runs the queued functions. */
+        void init(timing_system *timing, const std::string &event_name);
+
+        /*! \brief Queue a function. Can be called from any thread. */
+        void post(std::function<void()> func);
+    };
+}
@@ -19,9 +19,13 @@
  */
 #pragma once
 
+#include <common/queue.h>
+
 #include <cstdint>
 #include <functional>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace eka2l1 {
@@ -44,12 +48,41 @@ namespace eka2l1 {
         int event_type;
         uint64_t event_time;
         uint64_t event_user_data;
+
+        uint64_t event_order;           ///< Schedule order. Breaks ties between events due at the same tick.
+        uint32_t event_handle;          ///< Slot in the handle table, which tracks the event position in the heap.
+    };
+
+    struct event_key {
+        int event_type;
+        uint64_t event_user_data;
+
+        bool operator==(const event_key &rhs) const {
+            return (event_type == rhs.event_type) && (event_user_data == rhs.event_user_data);
+        }
+    };
+
+    struct event_key_hash {
+        std::size_t operator()(const event_key &key) const {
+            return std::hash<uint64_t>()(key.event_user_data ^ (static_cast<uint64_t>(key.event_type) << 48));
+        }
     };
 
     namespace common {
         class chunkyseri;
     }
 
+    /**
+     * \brief Timing state read from a save state, before it is applied.
+     */
+    struct timing_save_data {
+        std::int64_t cpu_hz;
+        std::uint64_t ticks;                    ///< Ticks passed when the state was saved.
+        std::uint64_t idle_ticks;
+        std::uint64_t last_global_time_ticks;
+        std::uint64_t last_global_time_us;
+    };
+
     // class NTimer
     class timing_system {
         std::int64_t slice_len;
@@ -67,10 +100,28 @@ namespace eka2l1 {
         std::vector<mhz_change_callback> internal_mhzcs;
 
         std::vector<event_type> event_types;
-        std::vector<event> events, ts_events;
+
+        // Binary min-heap, ordered by event time then schedule order.
+        std::vector<event> events;
+        std::vector<std::uint32_t> event_positions;
+        std::vector<std::uint32_t> free_event_handles;
+        std::unordered_multimap<event_key, std::uint32_t, event_key_hash> event_lookup;
+        std::uint64_t event_order_counter;
+
+        // Events scheduled from other threads. Time is relative until they are moved.
+        mpsc_queue<event> ts_events;
 
         void fire_mhz_changes();
 
+        void push_event(event evt);
+        void remove_event_at(const std::size_t pos);
+        void remove_event_lookup(const event &evt);
+        void rebuild_event_heap();
+
+        void sift_event_up(std::size_t pos);
+        void sift_event_down(std::size_t pos);
+        void place_event(const std::size_t pos, const event &evt);
+
     public:
         std::int64_t get_slice_length() {
             return slice_len;
@@ -134,6 +185,14 @@ namespace eka2l1 {
 
         void schedule_event(int64_t cycles_into_future, int event_type, uint64_t userdata = 0);
         void schedule_event_imm(int event_type, uint64_t userdata = 0);
+
+        /**
+         * \brief Schedule an event from a thread other than the emulation thread.
+         *
+         * The event is queued without taking any lock, and is put into the event queue
+         * on the next advance.
+         */
+        void schedule_event_thread_safe(int64_t cycles_into_future, int event_type, uint64_t userdata = 0);
         void unschedule_event(int event_type, uint64_t userdata);
 
         void remove_event(int event_type);
@@ -156,5 +215,12 @@ namespace eka2l1 {
         std::int64_t get_downcount();
 
         void do_state(common::chunkyseri &seri);
+
+        /**
+         * \brief Read timing state without applying it.
+         * \returns False if the state is not valid.
+         */
+        bool read_state(common::chunkyseri &seri, timing_save_data &data);
+        void apply_state(timing_save_data &data);
     };
 }
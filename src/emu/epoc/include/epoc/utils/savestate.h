@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace eka2l1 {
+    namespace common {
+        class chunkyseri;
+    }
+
+    using state_do_func = std::function<bool(common::chunkyseri &seri)>;
+    using state_apply_func = std::function<void()>;
+
+    /**
+     * \brief Write save states to the host without stalling the emulation for long.
+     * 
+     * Saving a state only serializes it into a staging buffer on the caller thread, which
+     * is mostly a copy of committed guest memory. Compressing and writing the buffer is done
+     * on a worker thread, and staging buffers are recycled between saves.
+     */
+    class state_saver {
+        struct pending_state {
+            std::string path;
+            std::vector<std::uint8_t> raw;
+        };
+
+        std::thread worker;
+        std::mutex lock;
+        std::condition_variable work_cond;
+        std::condition_variable done_cond;
+
+        std::vector<pending_state> pendings;
+        std::vector<std::vector<std::uint8_t>> free_buffers;
+
+        std::size_t in_flight { 0 };
+        bool should_stop { false };
+
+        void worker_loop();
+
+    public:
+        explicit state_saver();
+        ~state_saver();
+
+        /**
+         * \brief Serialize a state, and queue it to be written to a file.
+         * 
+         * \param path Host path of the state file.
+         * \param func Function doing state. Called twice, to measure and to write.
+         * 
+         * \returns False if the state can't be queued, or the function failed.
+         */
+        bool save(const std::string &path, state_do_func func);
+
+        /**
+         * \brief Block until all queued states are written.
+         */
+        void wait();
+    };
+
+    /**
+     * \brief Load a state written by a state saver.
+     * 
+     * A file that is truncated, or that a different format version wrote, is rejected
+     * before the read function is called. The state is only applied once the read function
+     * succeeds and the whole state has been consumed.
+     * 
+     * \param path  Host path of the state file.
+     * \param read  Function reading the state into staging, in read mode. Must not change
+     *              anything else.
+     * \param apply Function applying what was read.
+     * 
+     * \returns True on success.
+     */
+    bool load_state(const std::string &path, state_do_func read, state_apply_func apply);
+}
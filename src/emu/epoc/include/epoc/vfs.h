@@ -209,8 +209,8 @@ namespace eka2l1 {
         std::string full_path;
 
         io_component_type type;
-        std::size_t size;
-        std::uint64_t last_write;
+        std::size_t size = 0;
+        std::uint64_t last_write = 0;       ///< Microseconds since 1AD. Zero if unknown.
     };
 
     struct directory : public io_component {
@@ -289,6 +289,11 @@ namespace eka2l1 {
         std::mutex access_lock;
 
         std::atomic<filesystem_id> id_counter;
+        std::atomic<std::uint32_t> lib_dir_generation{ 0 };
+        std::array<std::atomic<std::uint32_t>, drive_count> drive_generations{};
+
+        void touch_entry(const std::u16string &path);
+        void touch_all_drives();
 
     public:
         void init();
@@ -298,6 +303,26 @@ namespace eka2l1 {
 
         std::optional<std::u16string> get_raw_path(const std::u16string &path);
 
+        /*! \brief Get the generation of library directories.
+        *
+        * The generation changes every time a file system or drive is added or removed,
+        * or an entry under \\sys\\bin is modified. Caches of library lookup results
+        * should be dropped when it changes.
+        */
+        std::uint32_t get_lib_dir_generation() const {
+            return lib_dir_generation.load();
+        }
+
+        /*! \brief Get the generation of a drive.
+        *
+        * The generation changes every time the drive is mounted or unmounted, or an entry
+        * on it is modified. Caches built from the content of a drive should be rebuilt
+        * when it changes.
+        */
+        std::uint32_t get_drive_generation(const drive_number drv) const {
+            return drive_generations[drv].load();
+        }
+
         /*! \brief Add a new file system to the IO system
         *
         * Each filesystem will be assigned an ID for management.
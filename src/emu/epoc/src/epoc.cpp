@@ -23,12 +23,14 @@
 #include <epoc/kernel/process.h>
 
 #include <common/algorithm.h>
+#include <common/buffer.h>
 #include <common/chunkyseri.h>
 #include <common/cvt.h>
 #include <common/fileutils.h>
 #include <common/log.h>
 #include <common/path.h>
 #include <common/random.h>
+#include <common/virtualmem.h>
 #include <common/platform.h>
 
 #include <disasm/disasm.h>
@@ -37,7 +39,9 @@
 #include <manager/rpkg.h>
 
 #include <epoc/hal.h>
+#include <epoc/services/window/window.h>
 #include <epoc/utils/panic.h>
+#include <epoc/utils/savestate.h>
 
 #ifdef ENABLE_SCRIPTING
 #include <manager/script_manager.h>
@@ -66,6 +70,12 @@
 #include <manager/config.h>
 
 namespace eka2l1 {
+    /*! \brief State of the system read from a save state, before it is applied. */
+    struct system_save_data {
+        timing_save_data timing;
+        kernel_save_data kern;
+    };
+
     /* A system instance, where all the magic happens.
      * Represents the Symbian system. You can switch the system version dynamiclly.
     */
@@ -108,6 +118,9 @@ namespace eka2l1 {
 
         bool reschedule_pending;
 
+        //! Guest instructions executed by all loops.
+        std::atomic<std::uint64_t> instructions_executed { 0 };
+
         epocver ver = epocver::epoc94;
         bool exit = false;
 
@@ -121,6 +134,9 @@ namespace eka2l1 {
         bool save_snapshot_processes(const std::string &path,
             const std::vector<uint32_t> &inclue_uids);
 
+        //! Compresses and writes save states in the background.
+        state_saver saver;
+
         system *parent;
 
         language sys_lang = language::en;
@@ -197,6 +213,8 @@ namespace eka2l1 {
         int loop();
         void shutdown();
 
+        system_stats get_stats();
+
         /*!\brief Snapshot is a way to save the state of the system.
          *
          * Snapshot can be used for fast startup. Here, in EKA2L1,
@@ -281,7 +299,13 @@ namespace eka2l1 {
         bool install_rpkg(const std::string &devices_rom_path, const std::string &path, std::string &firmware_code);
         void load_scripts();
 
-        void do_state(common::chunkyseri &seri);
+        bool do_state(common::chunkyseri &seri);
+
+        bool read_state(common::chunkyseri &seri, system_save_data &data);
+        void apply_state(system_save_data &data);
+
+        bool save_state(const std::string &path);
+        bool load_state(const std::string &path);
 
         /*! \brief Install a SIS/SISX. */
         bool install_package(std::u16string path, drive_number drv);
@@ -317,9 +341,59 @@ namespace eka2l1 {
 #endif
     }
 
-    void system_impl::do_state(common::chunkyseri &seri) {
+    bool system_impl::do_state(common::chunkyseri &seri) {
+        if (seri.get_seri_mode() == common::SERI_MODE_READ) {
+            system_save_data data;
+
+            if (!read_state(seri, data)) {
+                return false;
+            }
+
+            apply_state(data);
+            return true;
+        }
+
+        kernel::thread *crr_thread = kern.crr_thread();
+
+        if (crr_thread) {
+            // The running thread's context only lives in the CPU
+            cpu->save_context(crr_thread->get_thread_context());
+        }
+
         // Save timing first
         timing.do_state(seri);
+        return kern.do_state(seri);
+    }
+
+    bool system_impl::read_state(common::chunkyseri &seri, system_save_data &data) {
+        return timing.read_state(seri, data.timing) && kern.read_state(seri, data.kern);
+    }
+
+    void system_impl::apply_state(system_save_data &data) {
+        timing.apply_state(data.timing);
+        kern.apply_state(data.kern);
+
+        // Guest code may have been replaced
+        cpu->clear_instruction_cache();
+
+        if (kernel::thread *crr_thread = kern.crr_thread()) {
+            cpu->load_context(crr_thread->get_thread_context());
+        }
+    }
+
+    bool system_impl::save_state(const std::string &path) {
+        return saver.save(path, [this](common::chunkyseri &seri) { return do_state(seri); });
+    }
+
+    bool system_impl::load_state(const std::string &path) {
+        // A state may still be on its way to the same file
+        saver.wait();
+
+        // Staged here, the guest memory in it points into the file buffer until it's applied
+        system_save_data staged;
+
+        return eka2l1::load_state(path, [&](common::chunkyseri &seri) { return read_state(seri, staged); },
+            [&]() { apply_state(staged); });
     }
 
     void system_impl::init() {
@@ -394,6 +468,9 @@ namespace eka2l1 {
     int system_impl::loop() {
         bool should_step = false;
 
+        // Whoever runs the loop is the thread allowed to touch guest state
+        kern.set_emulation_thread();
+
         if (gdb_stub.is_server_enabled()) {
             gdb_stub.handle_packet();
 
@@ -419,7 +496,10 @@ namespace eka2l1 {
                 cpu->step();
             }
 
-            kern.crr_thread()->add_ticks(static_cast<int>(cpu->get_num_instruction_executed()));
+            const std::uint32_t executed = cpu->get_num_instruction_executed();
+
+            kern.crr_thread()->add_ticks(static_cast<int>(executed));
+            instructions_executed.fetch_add(executed, std::memory_order_relaxed);
         }
 
         if (!kern.should_terminate()) {
@@ -438,22 +518,45 @@ namespace eka2l1 {
         return 1;
     }
 
+    system_stats system_impl::get_stats() {
+        system_stats stats;
+        stats.instructions = instructions_executed.load(std::memory_order_relaxed);
+        stats.ipc_messages = kern.total_msgs_created();
+        stats.frames = 0;
+
+        window_server *winserv = reinterpret_cast<window_server *>(kern.get_by_name<service::server>(
+            WINDOW_SERVER_NAME));
+
+        if (winserv) {
+            stats.frames = winserv->get_anim_scheduler()->frames_produced();
+        }
+
+        return stats;
+    }
+
     bool system_impl::install_package(std::u16string path, drive_number drv) {
         std::atomic<int> h;
         return mngr.get_package_manager()->install_package(path, drv, h);
     }
 
     bool system_impl::load_rom(const std::string &path) {
-        symfile f = eka2l1::physical_file_proxy(path, READ_MODE | BIN_MODE);
+        const std::int64_t rom_size = common::file_size(path);
+        void *rom_view = (rom_size > 0) ? common::map_file(path, prot::read, 0, true) : nullptr;
 
-        if (!f || !f->valid()) {
+        if (!rom_view) {
             LOG_ERROR("ROM file not present: {}", path);
             return false;
         }
 
-        eka2l1::ro_file_stream rom_fstream(f.get());
-        std::optional<loader::rom> romf_res = loader::load_rom(reinterpret_cast<common::ro_stream*>(
-            &rom_fstream));
+        // Parse the directory tree straight from the mapped image, rather than going
+        // through file reads for each entry.
+        common::ro_buf_stream rom_stream(reinterpret_cast<std::uint8_t *>(rom_view),
+            static_cast<std::uint64_t>(rom_size));
+
+        std::optional<loader::rom> romf_res = loader::load_rom(reinterpret_cast<common::ro_stream *>(
+            &rom_stream));
+
+        common::unmap_file(rom_view, static_cast<std::size_t>(rom_size));
 
         if (!romf_res) {
             return false;
@@ -485,6 +588,8 @@ namespace eka2l1 {
     }
 
     void system_impl::shutdown() {
+        saver.wait();
+
         timing.shutdown();
         kern.shutdown();
         hlelibmngr.shutdown();
@@ -603,6 +708,10 @@ namespace eka2l1 {
         return impl->shutdown();
     }
 
+    system_stats system::get_stats() {
+        return impl->get_stats();
+    }
+
     manager_system *system::get_manager_system() {
         return impl->get_manager_system();
     }
@@ -688,9 +797,17 @@ namespace eka2l1 {
         return impl->get_hal(category);
     }
 
-    void system::do_state(common::chunkyseri &seri) {
+    bool system::do_state(common::chunkyseri &seri) {
         return impl->do_state(seri);
     }
+
+    bool system::save_state(const std::string &path) {
+        return impl->save_state(path);
+    }
+
+    bool system::load_state(const std::string &path) {
+        return impl->load_state(path);
+    }
     
     const language system::get_system_language() const {
         return impl->get_system_language();
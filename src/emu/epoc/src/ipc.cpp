@@ -52,4 +52,61 @@ namespace eka2l1 {
     ipc_arg_type ipc_arg::get_arg_type(int slot) {
         return static_cast<ipc_arg_type>((flag >> (slot * 3)) & 7);
     }
-}
\ No newline at end of file
+
+    void ipc_msg_queue::push_back(ipc_msg *msg) {
+        msg->queued_in = this;
+        msg->queue_prev = tail;
+        msg->queue_next = nullptr;
+
+        if (tail) {
+            tail->queue_next = msg;
+        } else {
+            head = msg;
+        }
+
+        tail = msg;
+    }
+
+    void ipc_msg_queue::remove(ipc_msg *msg) {
+        if (msg->queue_prev) {
+            msg->queue_prev->queue_next = msg->queue_next;
+        } else {
+            head = msg->queue_next;
+        }
+
+        if (msg->queue_next) {
+            msg->queue_next->queue_prev = msg->queue_prev;
+        } else {
+            tail = msg->queue_prev;
+        }
+
+        msg->queued_in = nullptr;
+        msg->queue_prev = nullptr;
+        msg->queue_next = nullptr;
+    }
+
+    ipc_msg *ipc_msg_queue::pop_front() {
+        ipc_msg *msg = head;
+
+        if (msg) {
+            remove(msg);
+        }
+
+        return msg;
+    }
+
+    ipc_msg *ipc_msg_queue::pop_back() {
+        ipc_msg *msg = tail;
+
+        if (msg) {
+            remove(msg);
+        }
+
+        return msg;
+    }
+
+    void ipc_msg_queue::clear() {
+        while (pop_front()) {
+        }
+    }
+}
@@ -30,6 +30,7 @@
 #include <common/cvt.h>
 #include <common/fileutils.h>
 #include <common/log.h>
+#include <common/wildcard.h>
 #include <common/path.h>
 #include <common/virtualmem.h>
 
@@ -48,7 +49,10 @@
 #include <epoc/loader/romimage.h>
 
 #include <epoc/services/init.h>
+#include <epoc/timing.h>
+#include <epoc/utils/reqsts.h>
 
+#include <manager/config.h>
 #include <manager/manager.h>
 
 namespace eka2l1 {
@@ -65,6 +69,17 @@ namespace eka2l1 {
         rom_map = nullptr;
 
         kernel_handles = kernel::object_ix(this, kernel::handle_array_owner::kernel);
+        set_emulation_thread();
+
+        host_calls.init(timing, "KernelHostCalls");
+
+        // Servers pick their worker when they are created
+        const int total_workers = sys->get_config()->hle_server_workers;
+
+        if (total_workers > 0) {
+            server_workers = std::make_unique<service::server_worker_pool>(static_cast<std::size_t>(total_workers));
+        }
+
         service::init_services(sys);
     }
 
@@ -74,8 +89,21 @@ namespace eka2l1 {
         }
 
         rom_map = nullptr;
+
+        if (thr_sch) {
+            const kernel::context_switch_stat &stat = thr_sch->get_context_switch_stat();
+
+            if (stat.process_switches != 0) {
+                LOG_INFO("Context switches: {} total, {} across processes, {} ns average per address space switch",
+                    stat.thread_switches, stat.process_switches, stat.process_switch_host_ns / stat.process_switches);
+            }
+        }
+
         thr_sch.reset();
 
+        // Stop running messages before the servers go away
+        server_workers.reset();
+
         // Delete one by one in order. Do not change the order
         servers.clear();
         sessions.clear();
@@ -90,6 +118,8 @@ namespace eka2l1 {
         processes.clear();
         libraries.clear();
         codesegs.clear();
+
+        name_index.clear();
     }
 
     kernel::thread *kernel_system::crr_thread() {
@@ -105,31 +135,31 @@ namespace eka2l1 {
     }
 
     ipc_msg_ptr kernel_system::create_msg(kernel::owner_type owner) {
-        auto slot_free = std::find_if(msgs.begin(), msgs.end(),
-            [](auto slot) { return !slot || slot->free; });
-
-        if (slot_free != msgs.end()) {
-            if (!*slot_free) {
-                ipc_msg_ptr msg = std::make_shared<ipc_msg>(crr_thread());
-                *slot_free = std::move(msg);
-            }
-
-            slot_free->get()->own_thr = crr_thread();
-            slot_free->get()->free = false;
-            slot_free->get()->id = static_cast<std::uint32_t>(slot_free - msgs.begin());
-
-            return *slot_free;
+        ipc_msg *msg = free_msgs;
+
+        if (msg) {
+            free_msgs = msg->next_free;
+        } else if (msgs_used < msgs.size()) {
+            msg = &msgs[msgs_used];
+            msg->id = msgs_used++;
+        } else {
+            return nullptr;
         }
 
-        return nullptr;
+        msg->own_thr = crr_thread();
+        msg->free = false;
+        msg->next_free = nullptr;
+
+        msgs_created.fetch_add(1, std::memory_order_relaxed);
+        return msg;
     }
 
     ipc_msg_ptr kernel_system::get_msg(int handle) {
-        if (msgs.size() <= handle) {
+        if ((handle < 0) || (static_cast<std::uint32_t>(handle) >= msgs_used) || msgs[handle].free) {
             return nullptr;
         }
 
-        return msgs[handle];
+        return &msgs[handle];
     }
 
     bool kernel_system::destroy(kernel_obj_ptr obj) {
@@ -144,6 +174,7 @@ namespace eka2l1 {
         if (res == obj_map.end())                                                                                \
             return false;                                                                                        \
         (*res)->destroy();                                                                                       \
+        name_index.remove(res->get());                                                                           \
         obj_map.erase(res);                                                                                      \
         return true;                                                                                             \
     }
@@ -267,38 +298,93 @@ namespace eka2l1 {
     }
 
     kernel_obj_ptr kernel_system::get_kernel_obj_raw(uint32_t handle) {
+        return get_kernel_obj_raw(handle, crr_thread());
+    }
+
+    kernel_obj_ptr kernel_system::get_kernel_obj_raw(uint32_t handle, kernel::thread *target) {
         if (handle == 0xFFFF8000) {
             return reinterpret_cast<kernel::kernel_obj*>(get_by_id<kernel::process>(
-                crr_process()->unique_id()));
+                target->owning_process()->unique_id()));
         } else if (handle == 0xFFFF8001) {
             return reinterpret_cast<kernel::kernel_obj*>(get_by_id<kernel::thread>(
-                crr_thread()->unique_id()));
+                target->unique_id()));
         }
 
         kernel::handle_inspect_info info = kernel::inspect_handle(handle);
 
         if (info.handle_array_local) {
-            return crr_thread()->thread_handles.get_object(handle);
+            return target->thread_handles.get_object(handle);
         }
 
         if (info.handle_array_kernel) {
             return kernel_handles.get_object(handle);
         }
 
-        return crr_process()->process_handles.get_object(handle);
+        return target->owning_process()->process_handles.get_object(handle);
+    }
+
+    void kernel_system::call_on_emulation_thread(std::function<void()> func) {
+        host_calls.post(func);
+    }
+
+    void kernel_system::complete_request(kernel::thread *requester, eka2l1::ptr<epoc::request_status> sts,
+        const int code, const bool signal) {
+        if (!is_emulation_thread()) {
+            call_on_emulation_thread([this, requester, sts, code, signal]() {
+                complete_request(requester, sts, code, signal);
+            });
+
+            return;
+        }
+
+        *sts.get(requester->owning_process()) = code;
+
+        if (signal) {
+            requester->signal_request();
+        }
+    }
+
+    void kernel_system::complete_request(const kernel::uid requester_uid, eka2l1::ptr<epoc::request_status> sts,
+        const int code, const bool signal) {
+        if (!is_emulation_thread()) {
+            call_on_emulation_thread([this, requester_uid, sts, code, signal]() {
+                complete_request(requester_uid, sts, code, signal);
+            });
+
+            return;
+        }
+
+        kernel::thread *requester = get_by_id<kernel::thread>(requester_uid);
+
+        if (!requester || (requester->unique_id() != requester_uid)) {
+            return;
+        }
+
+        complete_request(requester, sts, code, signal);
     }
 
     void kernel_system::free_msg(ipc_msg_ptr msg) {
         if (msg->locked()) {
             return;
         }
-        
-        msg->free = true;
+
+        destroy_msg(msg);
     }
 
-    /*! \brief Completely destroy a message. */
     void kernel_system::destroy_msg(ipc_msg_ptr msg) {
-        (msgs.begin() + msg->id)->reset();
+        // Slots may be given back more than once, don't link them twice
+        if (msg->free) {
+            return;
+        }
+
+        if (msg->queued_in) {
+            msg->queued_in->remove(msg);
+        }
+
+        msg->free = true;
+        msg->attrib = 0;
+        msg->next_free = free_msgs;
+        free_msgs = msg;
     }
 
     property_ptr kernel_system::get_prop(int cagetory, int key) {
@@ -451,50 +537,100 @@ namespace eka2l1 {
         return reinterpret_cast<codeseg_ptr>(res->get());
     }
 
+    std::vector<kernel_obj_unq_ptr> *kernel_system::get_object_list(const kernel::object_type type) {
+        switch (type) {
+#define OBJECT_LIST(obj_type, obj_map)   \
+    case kernel::object_type::obj_type: \
+        return &obj_map;
+
+            OBJECT_LIST(mutex, mutexes)
+            OBJECT_LIST(sema, semas)
+            OBJECT_LIST(chunk, chunks)
+            OBJECT_LIST(thread, threads)
+            OBJECT_LIST(process, processes)
+            OBJECT_LIST(change_notifier, change_notifiers)
+            OBJECT_LIST(library, libraries)
+            OBJECT_LIST(codeseg, codesegs)
+            OBJECT_LIST(server, servers)
+            OBJECT_LIST(prop, props)
+            OBJECT_LIST(prop_ref, prop_refs)
+            OBJECT_LIST(session, sessions)
+            OBJECT_LIST(timer, timers)
+
+#undef OBJECT_LIST
+
+        default:
+            break;
+        }
+
+        return nullptr;
+    }
+
     std::optional<find_handle> kernel_system::find_object(const std::string &name, int start, kernel::object_type type, const bool use_full_name) {
         find_handle handle_find_info;
         SYNCHRONIZE_ACCESS;
 
-        switch (type) {
-#define OBJECT_SEARCH(obj_type, obj_map)                                                       \
-    case kernel::object_type::obj_type: {                                                      \
-        auto res = std::find_if(obj_map.begin() + start, obj_map.end(), [&](const auto &rhs) { \
-            std::string to_compare = "";                                                       \
-            if (use_full_name) {                                                               \
-                rhs->full_name(to_compare);                                                    \
-            } else {                                                                           \
-                to_compare = rhs->name();                                                      \
-            }                                                                                  \
-            return name == to_compare;                                                         \
-        });                                                                                    \
-        if (res == obj_map.end())                                                              \
-            return std::nullopt;                                                               \
-        handle_find_info.index = static_cast<int>(std::distance(obj_map.begin(), res));        \
-        handle_find_info.object_id = (*res)->unique_id();                                      \
-        return handle_find_info;                                                               \
-    }
+        std::vector<kernel_obj_unq_ptr> *obj_list = get_object_list(type);
 
-            OBJECT_SEARCH(mutex, mutexes)
-            OBJECT_SEARCH(sema, semas)
-            OBJECT_SEARCH(chunk, chunks)
-            OBJECT_SEARCH(thread, threads)
-            OBJECT_SEARCH(process, processes)
-            OBJECT_SEARCH(change_notifier, change_notifiers)
-            OBJECT_SEARCH(library, libraries)
-            OBJECT_SEARCH(codeseg, codesegs)
-            OBJECT_SEARCH(server, servers)
-            OBJECT_SEARCH(prop, props)
-            OBJECT_SEARCH(prop_ref, prop_refs)
-            OBJECT_SEARCH(session, sessions)
-            OBJECT_SEARCH(timer, timers)
+        if (!obj_list || start < 0 || static_cast<std::size_t>(start) >= obj_list->size()) {
+            return std::nullopt;
+        }
 
-#undef OBJECT_SEARCH
+        // Same as Symbian's MatchF: wildcards allowed, case folded
+        auto is_match = [&](kernel_obj_ptr obj) {
+            std::string to_compare = "";
 
-        default:
-            break;
+            if (use_full_name) {
+                obj->full_name(to_compare);
+            } else {
+                to_compare = obj->name();
+            }
+
+            return common::match_wildcard(to_compare, name, false);
+        };
+
+        std::size_t found_index = obj_list->size();
+
+        // A full name is the owner's full name, "::", then the object name. If the last part of
+        // the pattern has no wildcard, only objects with that name can match, so ask the name index
+        // for them instead of walking the whole list.
+        const std::size_t last_part_pos = use_full_name ? name.rfind("::") : std::string::npos;
+        const std::string last_part = (last_part_pos == std::string::npos) ? name : name.substr(last_part_pos + 2);
+
+        if (!common::has_wildcard(last_part)) {
+            name_index.for_each_folded_match(last_part, type, [&](kernel_obj_ptr obj) {
+                // Objects are sorted by unique id in their list
+                auto res = std::lower_bound(obj_list->begin(), obj_list->end(), obj->unique_id(),
+                    [](const kernel_obj_unq_ptr &lhs, const kernel::uid rhs) { return lhs->unique_id() < rhs; });
+
+                // The index may still hold an object that already left its list
+                if ((res == obj_list->end()) || ((*res)->unique_id() != obj->unique_id())) {
+                    return;
+                }
+
+                const std::size_t idx = std::distance(obj_list->begin(), res);
+
+                if (idx >= static_cast<std::size_t>(start) && idx < found_index && is_match(obj)) {
+                    found_index = idx;
+                }
+            });
+        } else {
+            for (std::size_t i = start; i < obj_list->size(); i++) {
+                if (is_match((*obj_list)[i].get())) {
+                    found_index = i;
+                    break;
+                }
+            }
         }
 
-        return std::nullopt;
+        if (found_index == obj_list->size()) {
+            return std::nullopt;
+        }
+
+        handle_find_info.index = static_cast<int>(found_index);
+        handle_find_info.object_id = (*obj_list)[found_index]->unique_id();
+
+        return handle_find_info;
     }
 
     bool kernel_system::should_terminate() {
@@ -538,11 +674,170 @@ namespace eka2l1 {
         kernel_info() {}
     };
 
-    void kernel_system::do_state(common::chunkyseri &seri) {
-        auto s = seri.section("Kernel", 1);
+    static void write_uids_for_object_list(common::chunkyseri &seri, std::vector<kernel_obj_unq_ptr> &objs) {
+        std::uint32_t count = static_cast<std::uint32_t>(objs.size());
+        seri.absorb(count);
+
+        for (auto &obj : objs) {
+            kernel::uid obj_uid = obj->unique_id();
+            seri.absorb(obj_uid);
+        }
+    }
+
+    static bool match_uids_for_object_list(common::chunkyseri &seri, std::vector<kernel_obj_unq_ptr> &objs) {
+        std::uint32_t count = 0;
+        seri.absorb(count);
+
+        if (count != objs.size()) {
+            LOG_ERROR("State has {} objects of a type while the kernel has {}, can't restore", count, objs.size());
+            return false;
+        }
+
+        // Both lists are sorted by UID
+        for (auto &obj : objs) {
+            kernel::uid obj_uid = 0;
+            seri.absorb(obj_uid);
+
+            if (obj_uid != obj->unique_id()) {
+                LOG_ERROR("Object with UID {} in state doesn't exist in the kernel, can't restore", obj_uid);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static void write_state_for_object_list(common::chunkyseri &seri, std::vector<kernel_obj_unq_ptr> &objs) {
+        std::uint32_t count = static_cast<std::uint32_t>(objs.size());
+        seri.absorb(count);
+
+        for (auto &obj : objs) {
+            kernel::uid obj_uid = obj->unique_id();
+
+            seri.absorb(obj_uid);
+            obj->do_state(seri);
+        }
+    }
+
+    template <typename T, typename D>
+    static bool read_state_for_object_list(common::chunkyseri &seri, std::vector<kernel_obj_unq_ptr> &objs,
+        std::vector<std::pair<T *, D>> &staged) {
+        std::uint32_t count = 0;
+        seri.absorb(count);
+
+        if (count != objs.size()) {
+            LOG_ERROR("State has {} objects while the kernel has {}, can't restore", count, objs.size());
+            return false;
+        }
+
+        std::unordered_map<kernel::uid, T *> objs_by_uid;
+
+        for (auto &obj : objs) {
+            objs_by_uid.emplace(obj->unique_id(), reinterpret_cast<T *>(obj.get()));
+        }
+
+        staged.resize(count);
+
+        for (auto &[obj, data] : staged) {
+            kernel::uid obj_uid = 0;
+            seri.absorb(obj_uid);
+
+            auto obj_ite = objs_by_uid.find(obj_uid);
+
+            if (obj_ite == objs_by_uid.end()) {
+                LOG_ERROR("Object with UID {} in state doesn't exist in the kernel, can't restore", obj_uid);
+                return false;
+            }
+
+            obj = obj_ite->second;
+
+            // Each object only once, so with the count check every object is covered
+            objs_by_uid.erase(obj_ite);
+
+            if (!obj->read_state(seri, data)) {
+                LOG_ERROR("State of object with UID {} doesn't fit it, can't restore", obj_uid);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool kernel_system::do_state(common::chunkyseri &seri) {
+        if (seri.get_seri_mode() == common::SERI_MODE_READ) {
+            kernel_save_data data;
+
+            if (!read_state(seri, data)) {
+                return false;
+            }
+
+            apply_state(data);
+            return true;
+        }
+
+        auto s = seri.section("Kernel", 2);
 
         if (!s) {
-            return;
+            return false;
         }
+
+        SYNCHRONIZE_ACCESS;
+
+        std::uint32_t uid_counter_val = uid_counter;
+        seri.absorb(uid_counter_val);
+
+        // Only chunk memory and thread contexts are restored. Objects are not recreated, so a state
+        // only loads on a kernel that has the exact same objects, created in the same order.
+        for (int type = 0; type < static_cast<int>(kernel::object_type::unk); type++) {
+            std::vector<kernel_obj_unq_ptr> *objs = get_object_list(static_cast<kernel::object_type>(type));
+
+            if (objs) {
+                write_uids_for_object_list(seri, *objs);
+            }
+        }
+
+        // Memory goes first, then the threads running on it
+        write_state_for_object_list(seri, chunks);
+        write_state_for_object_list(seri, threads);
+
+        return true;
+    }
+
+    bool kernel_system::read_state(common::chunkyseri &seri, kernel_save_data &data) {
+        auto s = seri.section("Kernel", 2);
+
+        if (!s) {
+            return false;
+        }
+
+        SYNCHRONIZE_ACCESS;
+
+        seri.absorb(data.uid_counter);
+
+        for (int type = 0; type < static_cast<int>(kernel::object_type::unk); type++) {
+            std::vector<kernel_obj_unq_ptr> *objs = get_object_list(static_cast<kernel::object_type>(type));
+
+            if (objs && !match_uids_for_object_list(seri, *objs)) {
+                return false;
+            }
+        }
+
+        return read_state_for_object_list(seri, chunks, data.chunks)
+            && read_state_for_object_list(seri, threads, data.threads);
+    }
+
+    void kernel_system::apply_state(kernel_save_data &data) {
+        SYNCHRONIZE_ACCESS;
+
+        for (auto &[target, chunk_data] : data.chunks) {
+            target->apply_state(chunk_data);
+        }
+
+        for (auto &[target, thread_data] : data.threads) {
+            target->apply_state(thread_data);
+        }
+
+        // UIDs past the saved counter may have been used since, by objects already freed
+        uid_counter = std::max(uid_counter.load(), data.uid_counter);
     }
 }
@@ -184,5 +184,29 @@ namespace eka2l1 {
         void *chunk::host_base() {
             return mmc_impl_->host_base();
         }
+
+        void chunk::do_state(common::chunkyseri &seri) {
+            auto s = seri.section("Chunk", 1);
+
+            if (!s) {
+                return;
+            }
+
+            mmc_impl_->do_state(seri);
+        }
+
+        bool chunk::read_state(common::chunkyseri &seri, mem::chunk_save_data &data) {
+            auto s = seri.section("Chunk", 1);
+
+            if (!s) {
+                return false;
+            }
+
+            return mmc_impl_->read_state(seri, data);
+        }
+
+        void chunk::apply_state(const mem::chunk_save_data &data) {
+            mmc_impl_->apply_state(data);
+        }
     }
 }
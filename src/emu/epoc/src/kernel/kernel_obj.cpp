@@ -52,6 +52,17 @@ namespace eka2l1 {
             seri.absorb(access_count);
         }
     
+        void kernel_obj::rename(const std::string &new_name) {
+            // Keep the kernel's name index in sync, if the object is registered there
+            const bool indexed = kern && kern->unindex_object_name(this);
+
+            obj_name = new_name;
+
+            if (indexed) {
+                kern->index_object_name(this);
+            }
+        }
+
         void kernel_obj::full_name(std::string &name_will_full) {
             if (owner) {
                 // recusively calling parent's owner to get name
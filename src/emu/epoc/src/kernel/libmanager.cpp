@@ -38,6 +38,8 @@
 
 #include <manager/config.h>
 
+#include <chrono>
+
 #include <epoc/loader/e32img.h>
 #include <epoc/loader/romimage.h>
 #include <epoc/vfs.h>
@@ -428,6 +430,9 @@ sb.clear();
 #undef EXPORT
 #undef ENLIB
 
+        profile_svc = sys->get_config()->profile_svc;
+        log_svc = sys->get_config()->log_svc;
+
         if (ver == epocver::epoc94) {
             epoc::register_epocv94(*this);
         } else if (ver == epocver::epoc93) {
@@ -618,21 +623,19 @@ sb.clear();
         // Absolute yet ?
         if (!eka2l1::has_root_dir(lib_path)) {
             // Nope ? We need to cycle through all possibilities
-            for (drive_number drv = drive_z; drv >= drive_a; drv = static_cast<drive_number>(static_cast<int>(drv) - 1)) {
-                lib_path = drive_to_char16(drv);
-                lib_path += u":\\Sys\\Bin\\";
-                lib_path += name;
+            lib_path = resolve_lib_path(name);
 
-                if (io->exist(lib_path)) {
-                    auto result = load_depend_on_drive(drv, lib_path);
-                    if (result != nullptr) {
-                        result->set_full_path(lib_path);
-                        return result;
-                    }
-                }
+            if (lib_path.empty()) {
+                return nullptr;
             }
 
-            return nullptr;
+            auto result = load_depend_on_drive(char16_to_drive(lib_path[0]), lib_path);
+
+            if (result != nullptr) {
+                result->set_full_path(lib_path);
+            }
+
+            return result;
         }
 
         drive_number drv = char16_to_drive(lib_path[0]);
@@ -648,36 +651,171 @@ sb.clear();
         return nullptr;
     }
 
+    std::u16string lib_manager::resolve_lib_path(const std::u16string &name) {
+        const std::uint32_t generation = io->get_lib_dir_generation();
+
+        if (generation != lib_path_cache_generation) {
+            lib_path_cache.clear();
+            lib_path_cache_generation = generation;
+        }
+
+        const std::u16string key = common::lowercase_ucs2_string(name);
+        auto cache_ite = lib_path_cache.find(key);
+
+        if (cache_ite != lib_path_cache.end()) {
+            lib_path_stats.hits++;
+            return cache_ite->second;
+        }
+
+        lib_path_stats.misses++;
+
+        std::u16string lib_path;
+
+        for (drive_number drv = drive_z; drv >= drive_a; drv = static_cast<drive_number>(static_cast<int>(drv) - 1)) {
+            lib_path = drive_to_char16(drv);
+            lib_path += u":\\Sys\\Bin\\";
+            lib_path += name;
+
+            if (io->exist(lib_path)) {
+                lib_path_cache.emplace(key, lib_path);
+                return lib_path;
+            }
+        }
+
+        lib_path_cache.emplace(key, std::u16string{});
+        return std::u16string{};
+    }
+
     void lib_manager::shutdown() {
+        if (profile_svc) {
+            log_svc_stats();
+        }
+
+        if (lib_path_stats.hits + lib_path_stats.misses != 0) {
+            LOG_INFO("Library path cache: {} hits, {} misses ({}% hit rate)", lib_path_stats.hits, lib_path_stats.misses,
+                lib_path_stats.hits * 100 / (lib_path_stats.hits + lib_path_stats.misses));
+        }
+
         reset();
     }
 
     void lib_manager::reset() {
         svc_funcs.clear();
+
+        svc_table.fill(svc_dispatch_entry{});
+        svc_stats.fill(svc_call_stat{});
+
+        lib_path_cache.clear();
+        lib_path_stats = lib_path_cache_stat{};
     }
 
-    bool lib_manager::call_svc(sid svcnum) {
-        auto res = svc_funcs.find(svcnum);
+    int svc_dispatch_index(const sid svcnum) {
+        // Slow executive calls are 0x00 - 0xFF, fast ones are 0x800000 - 0x8000FF
+        if (svcnum & ~(0x800000 | (SVC_DISPATCH_CLASS_SIZE - 1))) {
+            return -1;
+        }
 
-        if (res == svc_funcs.end()) {
-            return false;
+        return static_cast<int>(((svcnum >> 23) & 1) * SVC_DISPATCH_CLASS_SIZE + (svcnum & (SVC_DISPATCH_CLASS_SIZE - 1)));
+    }
+
+    void lib_manager::register_svcs(const func_map &funcs) {
+        for (const auto &[svcnum, func] : funcs) {
+            const int idx = svc_dispatch_index(svcnum);
+
+            if (idx < 0) {
+                LOG_ERROR("SVC 0x{:x} ({}) can't be put in the dispatch table, ignored", svcnum, func.name);
+                continue;
+            }
+
+            // An ordinal registered earlier keeps its function, the table follows what is in the map
+            auto res = svc_funcs.insert({ svcnum, func });
+
+            svc_table[idx].func = res.first->second.func;
+            svc_table[idx].name = &res.first->second.name;
         }
+    }
 
-        epoc_import_func func = res->second;
+    void lib_manager::set_svc_profiling(const bool enable) {
+        profile_svc = enable;
+    }
+
+    void lib_manager::set_svc_logging(const bool enable) {
+        log_svc = enable;
+    }
 
-        if (sys->get_config()->log_svc) {
-            LOG_TRACE("Calling SVC 0x{:x} {}", svcnum, func.name);
+    svc_call_stat lib_manager::get_svc_stat(const sid svcnum) const {
+        const int idx = svc_dispatch_index(svcnum);
+
+        if (idx < 0) {
+            return svc_call_stat{};
+        }
+
+        return svc_stats[idx];
+    }
+
+    void lib_manager::log_svc_stats() {
+        std::vector<int> called;
+
+        for (int i = 0; i < SVC_DISPATCH_TABLE_SIZE; i++) {
+            if (svc_stats[i].calls != 0) {
+                called.push_back(i);
+            }
+        }
+
+        std::sort(called.begin(), called.end(), [&](const int lhs, const int rhs) {
+            return svc_stats[lhs].host_time_ns > svc_stats[rhs].host_time_ns;
+        });
+
+        for (const int idx : called) {
+            const sid svcnum = ((idx / SVC_DISPATCH_CLASS_SIZE) << 23) | (idx % SVC_DISPATCH_CLASS_SIZE);
+
+            LOG_INFO("SVC 0x{:x} {}: {} calls, {} us total, {} ns average", svcnum,
+                svc_table[idx].name ? *svc_table[idx].name : "Unknown", svc_stats[idx].calls,
+                svc_stats[idx].host_time_ns / 1000, svc_stats[idx].host_time_ns / svc_stats[idx].calls);
+        }
+    }
+
+    void lib_manager::call_svc_hooked(const sid svcnum, const int idx) {
+        if (log_svc) {
+            LOG_TRACE("Calling SVC 0x{:x} {}", svcnum, *svc_table[idx].name);
         }
 
 #ifdef ENABLE_SCRIPTING
         sys->get_manager_system()->get_script_manager()->call_svcs(svcnum, 0);
 #endif
 
-        func.func(sys);
+        if (profile_svc) {
+            const auto start = std::chrono::steady_clock::now();
+            svc_table[idx].func(sys);
+
+            svc_stats[idx].calls++;
+            svc_stats[idx].host_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        } else {
+            svc_table[idx].func(sys);
+        }
 
 #ifdef ENABLE_SCRIPTING
         sys->get_manager_system()->get_script_manager()->call_svcs(svcnum, 1);
 #endif
+    }
+
+    bool lib_manager::call_svc(sid svcnum) {
+        const int idx = svc_dispatch_index(svcnum);
+
+        if ((idx < 0) || !svc_table[idx].func) {
+            return false;
+        }
+
+#ifdef ENABLE_SCRIPTING
+        call_svc_hooked(svcnum, idx);
+#else
+        if (profile_svc || log_svc) {
+            call_svc_hooked(svcnum, idx);
+        } else {
+            svc_table[idx].func(sys);
+        }
+#endif
 
         return true;
     }
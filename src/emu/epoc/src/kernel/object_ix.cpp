@@ -60,10 +60,13 @@ namespace eka2l1 {
             return info;
         }
 
-        std::uint32_t object_ix::make_handle(size_t index) {
+        // Bits of a handle that identify the slot and the instance given out from it
+        static constexpr std::uint32_t HANDLE_SLOT_INSTANCE_MASK = (OBJECT_IX_INSTANCE_MASK << 16) | (OBJECT_IX_MAX_SLOTS - 1);
+
+        std::uint32_t object_ix::make_handle(size_t index, const std::uint16_t instance) {
             std::uint32_t handle = 0;
 
-            handle |= next_instance << 16;
+            handle |= static_cast<std::uint32_t>(instance) << 16;
             handle |= index;
 
             if (owner == handle_array_owner::thread) {
@@ -80,24 +83,86 @@ namespace eka2l1 {
             return handle;
         }
 
-        std::uint32_t object_ix::add_object(kernel_obj_ptr obj) {
-            auto slot = std::find_if(objects.begin(), objects.end(),
-                [](object_ix_record record) { return record.free; });
+        object_ix_record *object_ix::get_record(const std::uint32_t index) const {
+            const std::uint32_t segment_index = index / OBJECT_IX_SEGMENT_SIZE;
+
+            if (segment_index >= OBJECT_IX_MAX_SEGMENTS) {
+                return nullptr;
+            }
+
+            object_ix_segment *segment = segments[segment_index].load(std::memory_order_acquire);
+
+            if (!segment) {
+                return nullptr;
+            }
+
+            return &(*segment)[index % OBJECT_IX_SEGMENT_SIZE];
+        }
+
+        bool object_ix::grow() {
+            if (segment_count >= OBJECT_IX_MAX_SEGMENTS) {
+                return false;
+            }
+
+            object_ix_segment *segment = new object_ix_segment;
+            const std::int32_t base = static_cast<std::int32_t>(segment_count * OBJECT_IX_SEGMENT_SIZE);
+
+            // Chain the new slots in order, in front of what is left of the free list
+            for (std::int32_t i = 0; i < OBJECT_IX_SEGMENT_SIZE; i++) {
+                (*segment)[i].next_free = (i == OBJECT_IX_SEGMENT_SIZE - 1) ? free_head : base + i + 1;
+            }
+
+            free_head = base;
+            segments[segment_count++].store(segment, std::memory_order_release);
+
+            return true;
+        }
+
+        void object_ix::rebuild_free_list() {
+            free_head = -1;
 
-            if (slot != objects.end()) {
-                next_instance++;
-                std::uint32_t ret_handle = make_handle(slot - objects.begin());
+            for (std::int32_t i = static_cast<std::int32_t>(capacity()) - 1; i >= 0; i--) {
+                object_ix_record *record = get_record(i);
 
-                slot->associated_handle = ret_handle;
-                slot->free = false;
-                slot->object = obj;
+                if (record->associated_handle.load(std::memory_order_relaxed) == 0) {
+                    record->next_free = free_head;
+                    free_head = i;
+                }
+            }
+        }
 
-                obj->increase_access_count();
+        void object_ix::free_segments() {
+            for (std::uint32_t i = 0; i < segment_count; i++) {
+                delete segments[i].exchange(nullptr, std::memory_order_relaxed);
+            }
 
-                return ret_handle;
+            segment_count = 0;
+            free_head = -1;
+        }
+
+        std::uint32_t object_ix::add_object(kernel_obj_ptr obj) {
+            if (free_head < 0 && !grow()) {
+                LOG_ERROR("Handle table is full ({} handles)", capacity());
+                return INVALID_HANDLE;
             }
 
-            return INVALID_HANDLE;
+            const std::int32_t index = free_head;
+            object_ix_record *record = get_record(index);
+
+            free_head = record->next_free;
+            record->next_free = -1;
+
+            // Instance 0 is never used, so a handle is never 0 and a stale handle never matches a free slot
+            record->instance = static_cast<std::uint16_t>((record->instance % OBJECT_IX_INSTANCE_MASK) + 1);
+
+            const std::uint32_t ret_handle = make_handle(index, record->instance);
+
+            record->object.store(obj, std::memory_order_relaxed);
+            record->associated_handle.store(ret_handle, std::memory_order_release);
+
+            obj->increase_access_count();
+
+            return ret_handle;
         }
 
         std::uint32_t object_ix::last_handle() {
@@ -128,10 +193,14 @@ namespace eka2l1 {
         }
 
         kernel_obj_ptr object_ix::get_object(std::uint32_t handle) {
-            handle_inspect_info info = inspect_handle(handle);
+            const object_ix_record *record = get_record(handle & (OBJECT_IX_MAX_SLOTS - 1));
+
+            if (record) {
+                const std::uint32_t slot_handle = record->associated_handle.load(std::memory_order_acquire);
 
-            if (info.object_ix_index < objects.size()) {
-                return objects[info.object_ix_index].object;
+                if (slot_handle != 0 && ((slot_handle ^ handle) & HANDLE_SLOT_INSTANCE_MASK) == 0) {
+                    return record->object.load(std::memory_order_relaxed);
+                }
             }
 
             LOG_WARN("Can't find object with handle: 0x{:x}", handle);
@@ -140,66 +209,119 @@ namespace eka2l1 {
         }
 
         int object_ix::close(std::uint32_t handle) {
-            handle_inspect_info info = inspect_handle(handle);
+            object_ix_record *record = get_record(handle & (OBJECT_IX_MAX_SLOTS - 1));
             int ret_value = 0;
 
-            if (info.object_ix_index < objects.size()) {
-                kernel_obj_ptr obj = objects[info.object_ix_index].object;
+            if (!record) {
+                return -1;
+            }
 
-                if (!obj) {
-                    return -1;
-                }
+            const std::uint32_t slot_handle = record->associated_handle.load(std::memory_order_relaxed);
 
-                obj->decrease_access_count();
-                obj->close();
+            if (slot_handle == 0 || ((slot_handle ^ handle) & HANDLE_SLOT_INSTANCE_MASK) != 0) {
+                return -1;
+            }
 
-                if (obj->get_access_count() <= 0 && obj->get_object_type() != object_type::process && obj->get_object_type() != object_type::thread) {
-                    if (obj->get_object_type() == object_type::chunk) {
-                        chunk_ptr c = reinterpret_cast<kernel::chunk*>(obj);
+            kernel_obj_ptr obj = record->object.load(std::memory_order_relaxed);
 
-                        // This is a force hack signaling the closing one is chunk heap, which means the
-                        // thread is in destruction, and detach needed
-                        if (c->is_chunk_heap()) {
-                            ret_value = 1;
-                        }
-                    }
+            if (!obj) {
+                return -1;
+            }
 
-                    kern->destroy(obj);
-                }
+            // Free the slot first, so the handle can't be looked up anymore while the object dies
+            record->associated_handle.store(0, std::memory_order_release);
+            record->object.store(nullptr, std::memory_order_relaxed);
+            record->next_free = free_head;
+            free_head = static_cast<std::int32_t>(handle & (OBJECT_IX_MAX_SLOTS - 1));
+
+            obj->decrease_access_count();
+            obj->close();
+
+            if (obj->get_access_count() <= 0 && obj->get_object_type() != object_type::process && obj->get_object_type() != object_type::thread) {
+                if (obj->get_object_type() == object_type::chunk) {
+                    chunk_ptr c = reinterpret_cast<kernel::chunk*>(obj);
 
-                objects[info.object_ix_index].free = true;
+                    // This is a force hack signaling the closing one is chunk heap, which means the
+                    // thread is in destruction, and detach needed
+                    if (c->is_chunk_heap()) {
+                        ret_value = 1;
+                    }
+                }
 
-                return ret_value;
+                kern->destroy(obj);
             }
 
-            return -1;
+            return ret_value;
+        }
+
+        object_ix::object_ix()
+            : uid(0)
+            , segment_count(0)
+            , free_head(-1)
+            , owner(handle_array_owner::kernel)
+            , kern(nullptr) {
+            for (auto &segment : segments) {
+                segment.store(nullptr, std::memory_order_relaxed);
+            }
         }
 
         object_ix::object_ix(kernel_system *kern, handle_array_owner owner)
-            : kern(kern)
-            , owner(owner)
-            , next_instance(0)
-            , uid(kern->next_uid()) {}
+            : object_ix() {
+            this->kern = kern;
+            this->owner = owner;
+            uid = kern->next_uid();
+        }
+
+        object_ix::~object_ix() {
+            free_segments();
+        }
+
+        object_ix::object_ix(object_ix &&rhs)
+            : object_ix() {
+            *this = std::move(rhs);
+        }
+
+        object_ix &object_ix::operator=(object_ix &&rhs) {
+            if (this == &rhs) {
+                return *this;
+            }
+
+            free_segments();
+
+            for (std::uint32_t i = 0; i < rhs.segment_count; i++) {
+                segments[i].store(rhs.segments[i].exchange(nullptr, std::memory_order_relaxed), std::memory_order_release);
+            }
+
+            segment_count = rhs.segment_count;
+            free_head = rhs.free_head;
+            handles = std::move(rhs.handles);
+            owner = rhs.owner;
+            kern = rhs.kern;
+            uid = rhs.uid;
+
+            rhs.segment_count = 0;
+            rhs.free_head = -1;
+
+            return *this;
+        }
 
         void object_ix::do_state(common::chunkyseri &seri) {
-            auto s = seri.section("ObjectIx", 1);
+            auto s = seri.section("ObjectIx", 2);
 
             if (!s) {
                 return;
             }
 
             seri.absorb(uid);
-            seri.absorb(next_instance);
             seri.absorb(owner);
 
-            std::stack<std::uint16_t> slot_used;
             std::uint32_t slot_count = 0;
 
-            if (seri.get_seri_mode() == common::SERI_MODE_WRITE) {
-                for (std::size_t i = 0; i < objects.size(); i++) {
-                    if (!objects[i].free) {
+            // Measuring must walk the same slots as writing, or the size comes out short
+            if (seri.get_seri_mode() != common::SERI_MODE_READ) {
+                for (std::uint32_t i = 0; i < capacity(); i++) {
+                    if (get_record(i)->associated_handle.load(std::memory_order_relaxed) != 0) {
                         slot_count++;
-                        slot_used.push(static_cast<std::uint16_t>(i));
                     }
                 }
             }
@@ -210,25 +332,42 @@ namespace eka2l1 {
 
             for (std::uint32_t i = 0; i < slot_count; i++) {
                 std::uint32_t obj_id = 0;
+                std::uint32_t slot_handle = 0;
 
-                if (seri.get_seri_mode() == common::SERI_MODE_WRITE) {
-                    next_slot_use = slot_used.top();
-                    slot_used.pop();
+                if (seri.get_seri_mode() != common::SERI_MODE_READ) {
+                    while (get_record(next_slot_use)->associated_handle.load(std::memory_order_relaxed) == 0) {
+                        next_slot_use++;
+                    }
 
-                    obj_id = objects[next_slot_use].object->unique_id();
+                    obj_id = static_cast<std::uint32_t>(get_record(next_slot_use)->object.load(std::memory_order_relaxed)->unique_id());
+                    slot_handle = get_record(next_slot_use)->associated_handle.load(std::memory_order_relaxed);
                 }
 
                 seri.absorb(next_slot_use);
                 seri.absorb(obj_id);
-                seri.absorb(objects[next_slot_use].associated_handle);
+                seri.absorb(slot_handle);
 
                 if (seri.get_seri_mode() == common::SERI_MODE_READ) {
-                    // TODO
-                    //objects[next_slot_use].object = kern->get_kernel_obj_raw(obj_id);
-                    objects[next_slot_use].free = false;
+                    while (next_slot_use >= capacity() && grow()) {
+                    }
+
+                    object_ix_record *record = get_record(next_slot_use);
+
+                    if (record) {
+                        // TODO
+                        //record->object = kern->get_kernel_obj_raw(obj_id);
+                        record->instance = static_cast<std::uint16_t>((slot_handle >> 16) & OBJECT_IX_INSTANCE_MASK);
+                        record->associated_handle.store(slot_handle, std::memory_order_release);
+                    }
+                } else {
+                    next_slot_use++;
                 }
             }
 
+            if (seri.get_seri_mode() == common::SERI_MODE_READ) {
+                rebuild_free_list();
+            }
+
             // Hey, we need to save last thread handle too
             seri.absorb_container(handles);
         }
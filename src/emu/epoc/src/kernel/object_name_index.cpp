@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <epoc/kernel/object_name_index.h>
+#include <common/algorithm.h>
+
+namespace eka2l1::kernel {
+    std::string fold_object_name(const std::string &name) {
+        return common::lowercase_string(name);
+    }
+
+    object_name_index::name_map *object_name_index::get_map(const object_type type) {
+        const std::size_t idx = static_cast<std::size_t>(type);
+        return (idx < maps.size()) ? &maps[idx] : nullptr;
+    }
+
+    const object_name_index::name_map *object_name_index::get_map(const object_type type) const {
+        const std::size_t idx = static_cast<std::size_t>(type);
+        return (idx < maps.size()) ? &maps[idx] : nullptr;
+    }
+
+    void object_name_index::add(kernel_obj *obj) {
+        name_map *map = get_map(obj->get_object_type());
+
+        if (!map) {
+            return;
+        }
+
+        map->emplace(fold_object_name(obj->name()), obj);
+        count++;
+    }
+
+    bool object_name_index::remove(kernel_obj *obj) {
+        name_map *map = get_map(obj->get_object_type());
+
+        if (!map) {
+            return false;
+        }
+
+        const auto range = map->equal_range(fold_object_name(obj->name()));
+
+        for (auto ite = range.first; ite != range.second; ite++) {
+            if (ite->second == obj) {
+                map->erase(ite);
+                count--;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    kernel_obj *object_name_index::find(const std::string &name, const object_type type) const {
+        kernel_obj *result = nullptr;
+
+        for_each_folded_match(name, type, [&](kernel_obj *obj) {
+            if (obj->name() == name && (!result || obj->unique_id() < result->unique_id())) {
+                result = obj;
+            }
+        });
+
+        return result;
+    }
+
+    void object_name_index::clear() {
+        for (auto &map : maps) {
+            map.clear();
+        }
+
+        count = 0;
+    }
+}
@@ -28,6 +28,8 @@
 #include <epoc/mem/mmu.h>
 #include <epoc/mem/process.h>
 #include <epoc/timing.h>
+
+#include <chrono>
 #include <functional>
 
 static void wake_thread(uint64_t ud, int cycles_late);
@@ -78,7 +80,11 @@ namespace eka2l1::kernel {
             crr_thread = newt;
             crr_thread->state = thread_state::run;
 
+            switch_stat.thread_switches++;
+
             if (crr_process != newt->owning_process()) {
+                const auto switch_start = std::chrono::steady_clock::now();
+
                 if (crr_process) {
                     crr_process->get_mem_model()->unmap_locals_from_cpu();
                 }
@@ -89,6 +95,10 @@ namespace eka2l1::kernel {
                 mem->get_mmu()->set_current_addr_space(crr_process->get_mem_model()->address_space_id());
 
                 crr_process->get_mem_model()->remap_locals_to_cpu();
+
+                switch_stat.process_switches++;
+                switch_stat.process_switch_host_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - switch_start).count();
             }
 
             jitter->load_context(crr_thread->ctx);
@@ -19,6 +19,7 @@
  */
 
 #include <common/algorithm.h>
+#include <common/chunkyseri.h>
 #include <common/cvt.h>
 #include <common/log.h>
 #include <common/random.h>
@@ -578,6 +579,66 @@ namespace eka2l1 {
         chunk_ptr thread::get_stack_chunk() {
             return stack_chunk;
         }
+
+        static void absorb_thread_save_data(common::chunkyseri &seri, thread_save_data &data) {
+            for (auto &reg : data.ctx.cpu_registers) {
+                seri.absorb(reg);
+            }
+
+            seri.absorb(data.ctx.sp);
+            seri.absorb(data.ctx.pc);
+            seri.absorb(data.ctx.lr);
+            seri.absorb(data.ctx.cpsr);
+
+            for (auto &reg : data.ctx.fpu_registers) {
+                seri.absorb(reg);
+            }
+
+            seri.absorb(data.ctx.fpscr);
+
+            seri.absorb(data.flags);
+            seri.absorb(data.leave_depth);
+            seri.absorb(data.exit_reason);
+            seri.absorb(data.rendezvous_reason);
+            seri.absorb(data.lrt);
+            seri.absorb(data.time);
+            seri.absorb(data.timeslice);
+        }
+
+        void thread::do_state(common::chunkyseri &seri) {
+            auto s = seri.section("Thread", 1);
+
+            if (!s) {
+                return;
+            }
+
+            thread_save_data data { ctx, flags, leave_depth, exit_reason, rendezvous_reason, lrt, time, timeslice };
+            absorb_thread_save_data(seri, data);
+        }
+
+        bool thread::read_state(common::chunkyseri &seri, thread_save_data &data) {
+            auto s = seri.section("Thread", 1);
+
+            if (!s) {
+                return false;
+            }
+
+            absorb_thread_save_data(seri, data);
+            return true;
+        }
+
+        void thread::apply_state(const thread_save_data &data) {
+            // The scheduler queues are not part of the state, the thread must be in the same
+            // state it was saved with
+            ctx = data.ctx;
+            flags = data.flags;
+            leave_depth = data.leave_depth;
+            exit_reason = data.exit_reason;
+            rendezvous_reason = data.rendezvous_reason;
+            lrt = data.lrt;
+            time = data.time;
+            timeslice = data.timeslice;
+        }
         
         void thread::add_ticks(const int num) {
             time = common::max(0, time - num);
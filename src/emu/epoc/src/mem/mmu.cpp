@@ -53,13 +53,27 @@ namespace eka2l1::mem {
         return alloc_->create_new(page_size_bits_);
     }
 
-    void mmu_base::map_to_cpu(const vm_address addr, const std::size_t size, void *ptr, const prot perm) {
+    void mmu_base::map_to_cpu(const asid id, const vm_address addr, const std::size_t size, void *ptr, const prot perm) {
+        if (cpu_->has_addr_space_tables()) {
+            cpu_->map_backing_mem_to_addr_space(id, addr, size, reinterpret_cast<std::uint8_t*>(ptr), perm);
+            return;
+        }
+
         cpu_->map_backing_mem(addr, size, reinterpret_cast<std::uint8_t*>(ptr), perm);
     }
 
-    void mmu_base::unmap_from_cpu(const vm_address addr, const std::size_t size) {
+    void mmu_base::unmap_from_cpu(const asid id, const vm_address addr, const std::size_t size) {
+        if (cpu_->has_addr_space_tables()) {
+            cpu_->unmap_memory_from_addr_space(id, addr, size);
+            return;
+        }
+
         cpu_->unmap_memory(addr, size);
     }
+
+    bool mmu_base::cpu_has_addr_space_tables() const {
+        return cpu_->has_addr_space_tables();
+    }
     
     mmu_impl make_new_mmu(page_table_allocator *alloc, arm::arm_interface *cpu, const std::size_t psize_bits, const bool mem_map_old,
         const mem_model_type model) {
@@ -22,11 +22,24 @@
 #include <epoc/mem/model/multiple/process.h>
 
 #include <common/algorithm.h>
+#include <common/chunkyseri.h>
 #include <common/virtualmem.h>
 
 #include <common/log.h>
 
+#include <cstring>
+
 namespace eka2l1::mem {
+    asid multiple_mem_model_chunk::cpu_addr_space() const {
+        return (is_local && own_process_) ? own_process_->addr_space_id_ : 0;
+    }
+
+    bool multiple_mem_model_chunk::should_map_to_cpu() const {
+        // With page tables per address space, the right one is always updated, current or not
+        return mmu_->cpu_has_addr_space_tables() || !own_process_
+            || (own_process_->addr_space_id_ == mmu_->current_addr_space());
+    }
+
     const vm_address multiple_mem_model_chunk::bottom() const {
         return bottom_ << mmu_->page_size_bits_;
     }
@@ -94,8 +107,8 @@ namespace eka2l1::mem {
                     }
                 } else {
                     // Map those just mapped to the CPU. It will love this
-                    if (size_just_mapped != 0 && (!own_process_ || own_process_->addr_space_id_ == mmu_->current_addr_space())) {
-                        mmu_->map_to_cpu(off_start_just_mapped, size_just_mapped, host_start_just_mapped, permission_);
+                    if (size_just_mapped != 0 && should_map_to_cpu()) {
+                        mmu_->map_to_cpu(cpu_addr_space(), off_start_just_mapped, size_just_mapped, host_start_just_mapped, permission_);
                         off_start_just_mapped = 0;
                         size_just_mapped = 0;
                         host_start_just_mapped = nullptr;
@@ -104,9 +117,9 @@ namespace eka2l1::mem {
             }
 
             // Map the rest
-            if (size_just_mapped != 0 && (!own_process_ || own_process_->addr_space_id_ == mmu_->current_addr_space())) {
+            if (size_just_mapped != 0 && should_map_to_cpu()) {
                 //LOG_TRACE("Mapped to CPU: 0x{:X}, size 0x{:X}", off_start_just_mapped, size_just_mapped);
-                mmu_->map_to_cpu(off_start_just_mapped, size_just_mapped, host_start_just_mapped, permission_);
+                mmu_->map_to_cpu(cpu_addr_space(), off_start_just_mapped, size_just_mapped, host_start_just_mapped, permission_);
             }
 
             if (ptid == 0xFFFFFFFF) {
@@ -177,8 +190,8 @@ namespace eka2l1::mem {
                     }
                 } else {
                     // Map those just mapped to the CPU. It will love this
-                    if (size_just_unmapped != 0 && (!own_process_ || own_process_->addr_space_id_ == mmu_->current_addr_space())) {
-                        mmu_->unmap_from_cpu(off_start_just_unmapped, size_just_unmapped);
+                    if (size_just_unmapped != 0 && should_map_to_cpu()) {
+                        mmu_->unmap_from_cpu(cpu_addr_space(), off_start_just_unmapped, size_just_unmapped);
 
                         size_just_unmapped = 0;
                         off_start_just_unmapped = 0;
@@ -187,9 +200,9 @@ namespace eka2l1::mem {
             }
 
             // Unmap the rest
-            if (size_just_unmapped != 0 && (!own_process_ || own_process_->addr_space_id_ == mmu_->current_addr_space())) {
+            if (size_just_unmapped != 0 && should_map_to_cpu()) {
                 //LOG_TRACE("Unmapped from CPU: 0x{:X}, size 0x{:X}", off_start_just_unmapped, size_just_unmapped);
-                mmu_->unmap_from_cpu(off_start_just_unmapped, size_just_unmapped);
+                mmu_->unmap_from_cpu(cpu_addr_space(), off_start_just_unmapped, size_just_unmapped);
             }
             
             // Decommit the memory from the host
@@ -365,9 +378,9 @@ namespace eka2l1::mem {
         if (!page_bma_) {
             // Contigious types. Just unmap/map directly
             if (unmap) {
-                mmu_->unmap_from_cpu(base_ + (bottom_ << mmu_->page_size_bits_), (top_ - bottom_) << mmu_->page_size_bits_);
+                mmu_->unmap_from_cpu(cpu_addr_space(), base_ + (bottom_ << mmu_->page_size_bits_), (top_ - bottom_) << mmu_->page_size_bits_);
             } else {
-                mmu_->map_to_cpu(base_ + (bottom_ << mmu_->page_size_bits_), (top_ - bottom_) << mmu_->page_size_bits_,
+                mmu_->map_to_cpu(cpu_addr_space(), base_ + (bottom_ << mmu_->page_size_bits_), (top_ - bottom_) << mmu_->page_size_bits_,
                     reinterpret_cast<std::uint8_t*>(host_base_) + (bottom_ << mmu_->page_size_bits_), permission_);
             }
 
@@ -420,9 +433,9 @@ namespace eka2l1::mem {
                     // Map those just mapped to the CPU. It will love this
                     if (size_mani != 0) {
                         if (unmap) {
-                            mmu_->unmap_from_cpu(off_start_mani, size_mani);
+                            mmu_->unmap_from_cpu(cpu_addr_space(), off_start_mani, size_mani);
                         } else {
-                            mmu_->map_to_cpu(off_start_mani, size_mani, host_start_mani, permission_);
+                            mmu_->map_to_cpu(cpu_addr_space(), off_start_mani, size_mani, host_start_mani, permission_);
                         }
                     }
                 }
@@ -431,9 +444,9 @@ namespace eka2l1::mem {
             // Map those just mapped to the CPU. It will love this
             if (size_mani != 0) {
                 if (unmap) {
-                    mmu_->unmap_from_cpu(off_start_mani, size_mani);
+                    mmu_->unmap_from_cpu(cpu_addr_space(), off_start_mani, size_mani);
                 } else {
-                    mmu_->map_to_cpu(off_start_mani, size_mani, host_start_mani, permission_);
+                    mmu_->map_to_cpu(cpu_addr_space(), off_start_mani, size_mani, host_start_mani, permission_);
                 }
             }
             
@@ -448,4 +461,136 @@ namespace eka2l1::mem {
     void multiple_mem_model_chunk::map_to_cpu() {
         do_selection_cpu_memory_manipulation(false);
     }
+
+    std::vector<std::pair<vm_address, std::size_t>> multiple_mem_model_chunk::committed_runs() {
+        std::vector<std::pair<vm_address, std::size_t>> runs;
+
+        const std::size_t psize = mmu_->page_size();
+        const std::size_t page_per_tab = static_cast<std::size_t>(1) << mmu_->page_per_tab_shift_;
+
+        for (std::size_t ptidx = 0; ptidx < page_tabs_.size(); ptidx++) {
+            if (page_tabs_[ptidx] == 0xFFFFFFFF) {
+                continue;
+            }
+
+            page_table *pt = mmu_->get_page_table_by_id(page_tabs_[ptidx]);
+
+            for (std::size_t poff = 0; poff < page_per_tab; poff++) {
+                if (pt->pages_[poff].host_addr == nullptr) {
+                    continue;
+                }
+
+                const vm_address off = static_cast<vm_address>((ptidx << mmu_->chunk_shift_) + (poff << mmu_->page_size_bits_));
+
+                // Merge with the previous run if they are next to each other
+                if (!runs.empty() && (runs.back().first + runs.back().second == off)) {
+                    runs.back().second += psize;
+                } else {
+                    runs.emplace_back(off, psize);
+                }
+            }
+        }
+
+        return runs;
+    }
+
+    static void absorb_committed_runs(common::chunkyseri &seri, std::vector<std::pair<vm_address, std::size_t>> &runs) {
+        seri.absorb_container(runs, [](common::chunkyseri &seri, std::pair<vm_address, std::size_t> &run) {
+            std::uint64_t run_size = run.second;
+
+            seri.absorb(run.first);
+            seri.absorb(run_size);
+
+            run.second = static_cast<std::size_t>(run_size);
+        });
+    }
+
+    void multiple_mem_model_chunk::do_state(common::chunkyseri &seri) {
+        vm_address bottom = bottom_;
+        vm_address top = top_;
+
+        seri.absorb(bottom);
+        seri.absorb(top);
+
+        std::vector<std::pair<vm_address, std::size_t>> runs = committed_runs();
+        absorb_committed_runs(seri, runs);
+
+        if (is_external_host) {
+            // The content lives in memory that this chunk does not own, such as the ROM
+            return;
+        }
+
+        for (auto &run : runs) {
+            seri.absorb_impl(reinterpret_cast<std::uint8_t *>(host_base_) + run.first, run.second);
+        }
+    }
+
+    bool multiple_mem_model_chunk::read_state(common::chunkyseri &seri, chunk_save_data &data) {
+        seri.absorb(data.bottom);
+        seri.absorb(data.top);
+
+        absorb_committed_runs(seri, data.runs);
+
+        // Bottom and top are in pages
+        const std::size_t max_size = max_size_;
+
+        if ((data.bottom > data.top) || ((static_cast<std::size_t>(data.top) << mmu_->page_size_bits_) > max_size)) {
+            LOG_ERROR("Committed range of chunk in state is outside of the chunk");
+            return false;
+        }
+
+        vm_address run_end = 0;
+
+        for (auto &run : data.runs) {
+            // Runs are saved in order, page aligned, and never past the chunk's max size
+            if ((run.first < run_end) || (run.first & (mmu_->page_size() - 1)) || (run.second == 0)
+                || (run.second & (mmu_->page_size() - 1)) || (run.first > max_size) || (run.second > max_size - run.first)) {
+                LOG_ERROR("Committed run 0x{:X} (size 0x{:X}) in state doesn't fit the chunk", run.first, run.second);
+                return false;
+            }
+
+            run_end = static_cast<vm_address>(run.first + run.second);
+        }
+
+        data.run_data.clear();
+
+        if (is_external_host) {
+            return true;
+        }
+
+        for (auto &run : data.runs) {
+            std::uint8_t *content = seri.skip(run.second);
+
+            if (!content) {
+                LOG_ERROR("State is too short for the content of the chunk");
+                return false;
+            }
+
+            data.run_data.push_back(content);
+        }
+
+        return true;
+    }
+
+    void multiple_mem_model_chunk::apply_state(const chunk_save_data &data) {
+        for (auto &run : committed_runs()) {
+            decommit(run.first, run.second);
+        }
+
+        for (auto &run : data.runs) {
+            commit(run.first, run.second);
+        }
+
+        bottom_ = data.bottom;
+        top_ = data.top;
+
+        if (is_external_host) {
+            return;
+        }
+
+        for (std::size_t i = 0; i < data.runs.size(); i++) {
+            std::memcpy(reinterpret_cast<std::uint8_t *>(host_base_) + data.runs[i].first, data.run_data[i],
+                data.runs[i].second);
+        }
+    }
 }
@@ -17,7 +17,9 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <arm/arm_interface.h>
 #include <epoc/mem/model/multiple/mmu.h>
+
 #include <algorithm>
 
 namespace eka2l1::mem {
@@ -52,6 +54,24 @@ namespace eka2l1::mem {
         return static_cast<asid>(dirs_.size());
     }
 
+    void mmu_multiple::free_addr_space(const asid id) {
+        if ((id <= 0) || (dirs_.size() < id)) {
+            return;
+        }
+
+        page_directory *dir = dirs_[id - 1].get();
+
+        if (cur_dir_ == dir) {
+            cur_dir_ = &global_dir_;
+        }
+
+        // The next owner must not see tables left over from this one
+        std::fill(dir->page_tabs_.begin(), dir->page_tabs_.end(), nullptr);
+        dir->occupied(false);
+
+        cpu_->free_addr_space(id);
+    }
+
     bool mmu_multiple::set_current_addr_space(const asid id) {
         if (id == 0) {
             cur_dir_ = &global_dir_;
@@ -34,6 +34,12 @@ namespace eka2l1::mem {
         , user_local_sec_(local_data, shared_data, mmu->page_size()) {
     }
 
+    multiple_mem_model_process::~multiple_mem_model_process() {
+        if (addr_space_id_ > 0) {
+            mmu_->free_addr_space(addr_space_id_);
+        }
+    }
+
     static constexpr std::size_t MAX_CHUNK_ALLOW_PER_PROCESS = 512;
 
     multiple_mem_model_chunk *multiple_mem_model_process::allocate_chunk_struct_ptr() {
@@ -156,7 +162,7 @@ namespace eka2l1::mem {
     }
     
     void multiple_mem_model_process::unmap_locals_from_cpu() {
-        if (!mmu_->cpu_->should_clear_old_memory_map()) {
+        if (!mmu_->cpu_->should_clear_old_memory_map() || mmu_->cpu_has_addr_space_tables()) {
             return;
         }
 
@@ -169,6 +175,12 @@ namespace eka2l1::mem {
     }
     
     void multiple_mem_model_process::remap_locals_to_cpu() {
+        if (mmu_->cpu_has_addr_space_tables()) {
+            // Our page table is kept in sync on every commit and decommit, just make it current
+            mmu_->cpu_->set_current_addr_space(addr_space_id_);
+            return;
+        }
+
         for (auto &c: chunks_) {
             if (c && c->is_local) {
                 // Local
@@ -52,6 +52,8 @@ namespace eka2l1 {
             EAppListServGetAppCapability, "GetAppCapability");
         REGISTER_IPC(applist_server, get_app_icon_file_name,
             EAppListServAppIconFileName, "GetAppIconFilename");
+
+        run_on_worker();
     }
 
     bool applist_server::load_registry(eka2l1::io_system *io, const std::u16string &path, drive_number land_drive,
@@ -17,6 +17,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <common/algorithm.h>
 #include <common/buffer.h>
 #include <common/chunkyseri.h>
 #include <drivers/audio/audio.h>
@@ -29,8 +30,6 @@
 #include <epoc/kernel/process.h>
 #include <epoc/epoc.h>
 
-#include <cmath>
-
 namespace eka2l1 {
     // sf_mw_classicui document
     // Reference from GUID-1A9B515C-C20F-4EC7-B62A-223B219BBC4E, Belle devlib
@@ -40,13 +39,12 @@ namespace eka2l1 {
         drivers::audio_driver *aud_driver = svr->get_system()->get_audio_driver();
 
         if (aud_driver) {
-            aud_out_ = aud_driver->new_output_stream(aud_driver->native_sample_rate(),
+            state_.target_freq_ = aud_driver->native_sample_rate();
+            aud_out_ = aud_driver->new_output_stream(state_.target_freq_,
                 [this](std::int16_t *dest, std::size_t frames) {
                     return play_sounds(dest, frames);
                 });
         }
-
-        state_.target_freq_ = aud_driver->native_sample_rate();
     }
 
     keysound_session::parser_state::parser_state()
@@ -55,25 +53,25 @@ namespace eka2l1 {
         , frequency_(1)
         , ms_(0)
         , duration_unit_(0)
-        , parser_pos_(0) {
+        , parser_pos_(0)
+        , tone_played_(false) {
     }
 
     std::size_t keysound_session::play_sounds(std::int16_t *buffer, std::size_t frames) {
         auto parse_to_get_freq = [this]() -> bool {
             if (state_.sound_.type_ == epoc::keysound::sound_type::sound_type_tone) {
-                if (!state_.frames_) {
-                    state_.frequency_ = state_.sound_.freq_;
-                    state_.ms_ = state_.sound_.duration_;
+                state_.frames_ = 0;
 
-                    state_.frames_ = 0;
-                    state_.ms_ = 0;
+                if (!state_.tone_played_) {
+                    // Tone duration is in microseconds
+                    state_.frequency_ = state_.sound_.freq_;
+                    state_.ms_ = state_.sound_.duration_ / 1000;
+                    state_.tone_played_ = true;
 
                     return true;
                 }
 
-                state_.frames_ = 0;
                 state_.ms_ = 0;
-                
                 return false;
             }
 
@@ -123,26 +121,32 @@ namespace eka2l1 {
         };
 
 
-        const float amplitude = 0.8f;
+        // 0.8 of full scale
+        const std::int32_t amplitude = 26214;
+
+        std::size_t t = 0;
+
+        // Generate samples, a note at a time
+        while (t < frames) {
+            const std::uint64_t note_frames = static_cast<std::uint64_t>(state_.ms_) * state_.target_freq_ / 1000;
 
-        // Generate samples
-        for (std::size_t t = 0; t < frames; t++) {
-            if ((static_cast<double>(state_.frames_) / static_cast<double>(state_.target_freq_) * 1000.0) >=
-                static_cast<double>(state_.ms_)) {
+            if (state_.frames_ >= note_frames) {
                 if (!parse_to_get_freq()) {
                     aud_out_->stop();
                     return t;
                 }
+
+                state_.tone_.set_frequency(state_.frequency_, state_.target_freq_);
+                continue;
             }
 
-            const double sample = amplitude * std::sin(2 * 3.14 * (static_cast<double>(state_.frequency_) /
-                static_cast<double>(state_.target_freq_)) * (state_.frames_ + 1));
-            const std::int16_t sample_i16 = static_cast<std::int16_t>(sample * 0x7FFF);
+            const std::size_t to_generate = static_cast<std::size_t>(common::min<std::uint64_t>(frames - t,
+                note_frames - state_.frames_));
 
-            buffer[2 * t] = sample_i16;
-            buffer[2 * t + 1] = sample_i16;
+            state_.tone_.generate(buffer + t * 2, to_generate, amplitude);
 
-            state_.frames_++;
+            t += to_generate;
+            state_.frames_ += static_cast<std::uint32_t>(to_generate);
         }
 
         return frames;
@@ -208,6 +212,12 @@ namespace eka2l1 {
         }
 
         state_.sound_ = *info;
+        state_.frames_ = 0;
+        state_.ms_ = 0;
+        state_.parser_pos_ = 0;
+        state_.tone_played_ = false;
+        state_.tone_.reset();
+
         aud_out_->start();
 
         ctx->set_request_status(epoc::error_none);
@@ -1,13 +1,18 @@
 #include <common/algorithm.h>
 #include <common/chunkyseri.h>
 #include <common/cvt.h>
+#include <common/fileutils.h>
+#include <common/hash.h>
 #include <common/ini.h>
 #include <common/log.h>
+#include <common/path.h>
+#include <common/virtualmem.h>
 
 #include <epoc/epoc.h>
 #include <epoc/services/centralrepo/centralrepo.h>
 #include <epoc/services/centralrepo/cre.h>
 #include <epoc/vfs.h>
+#include <manager/config.h>
 #include <manager/manager.h>
 #include <manager/device_manager.h>
 
@@ -180,9 +185,176 @@ namespace eka2l1 {
         return true;
     }
 
+    enum {
+        CENTRAL_REPO_INI_CACHE_MAGIC = 0x43495243,      ///< CRIC
+        CENTRAL_REPO_INI_CACHE_VERSION = 1
+    };
+
+    static void do_state_for_compiled_ini(common::chunkyseri &seri, central_repo &repo) {
+        seri.absorb(repo.ver);
+        seri.absorb(repo.keyspace_type);
+        seri.absorb(repo.uid);
+        seri.absorb(repo.owner_uid);
+        seri.absorb(repo.default_meta);
+        seri.absorb(repo.time_stamp);
+
+        auto absorb_policy = [](common::chunkyseri &seri, central_repo_entry_access_policy &policy) {
+            seri.absorb(policy.low_key);
+            seri.absorb(policy.high_key);
+            seri.absorb(policy.key_mask);
+            seri.absorb_impl(reinterpret_cast<std::uint8_t *>(&policy.read_access), sizeof(epoc::security_policy));
+            seri.absorb_impl(reinterpret_cast<std::uint8_t *>(&policy.write_access), sizeof(epoc::security_policy));
+        };
+
+        absorb_policy(seri, repo.default_policy);
+        seri.absorb_container(repo.single_policies, absorb_policy);
+        seri.absorb_container(repo.policies_range, absorb_policy);
+
+        seri.absorb_container(repo.meta_range, [](common::chunkyseri &seri, central_repo_default_meta &meta) {
+            seri.absorb(meta.low_key);
+            seri.absorb(meta.high_key);
+            seri.absorb(meta.key_mask);
+            seri.absorb(meta.default_meta_data);
+        });
+
+        // Parsed entries are already sorted by key
+        seri.absorb_container(repo.entries, [](common::chunkyseri &seri, central_repo_entry &entry) {
+            seri.absorb(entry.key);
+            seri.absorb(entry.metadata_val);
+            seri.absorb(entry.data.etype);
+            seri.absorb(entry.data.intd);
+            seri.absorb_impl(reinterpret_cast<std::uint8_t *>(&entry.data.reald), sizeof(double));
+            seri.absorb(entry.data.strd);
+        });
+
+        seri.absorb_container(repo.deleted_settings);
+    }
+
+    static void absorb_compiled_ini_tag(common::chunkyseri &seri, std::uint32_t &version, std::uint64_t &source_size,
+        std::uint64_t &source_modified, std::string &source_path) {
+        std::uint32_t magic = CENTRAL_REPO_INI_CACHE_MAGIC;
+
+        seri.absorb(magic);
+        seri.absorb(version);
+        seri.absorb(source_size);
+        seri.absorb(source_modified);
+        seri.absorb(source_path);
+
+        if (magic != CENTRAL_REPO_INI_CACHE_MAGIC) {
+            version = 0;
+        }
+    }
+
+    static bool load_compiled_ini(const std::string &cache_path, const std::string &path, const std::uint64_t size,
+        const std::uint64_t modified, central_repo &repo) {
+        const std::int64_t cache_size = common::file_size(cache_path);
+
+        if (cache_size <= 0) {
+            return false;
+        }
+
+        std::uint8_t *cache_data = reinterpret_cast<std::uint8_t *>(common::map_file(cache_path, prot::read, 0));
+
+        if (!cache_data) {
+            return false;
+        }
+
+        common::chunkyseri seri(cache_data, static_cast<std::size_t>(cache_size), common::SERI_MODE_READ);
+
+        std::uint32_t version = 0;
+        std::uint64_t source_size = 0;
+        std::uint64_t source_modified = 0;
+        std::string source_path;
+
+        absorb_compiled_ini_tag(seri, version, source_size, source_modified, source_path);
+
+        bool fresh = (version == CENTRAL_REPO_INI_CACHE_VERSION) && (source_size == size)
+            && (source_modified == modified) && (source_path == path);
+
+        if (fresh) {
+            central_repo compiled;
+            do_state_for_compiled_ini(seri, compiled);
+
+            // The trailing magic catches a cache file cut short
+            std::uint32_t end_magic = 0;
+            seri.absorb(end_magic);
+
+            fresh = (end_magic == CENTRAL_REPO_INI_CACHE_MAGIC);
+
+            if (fresh) {
+                repo = std::move(compiled);
+            }
+        }
+
+        common::unmap_file(cache_data, static_cast<std::size_t>(cache_size));
+        return fresh;
+    }
+
+    static void write_compiled_ini(const std::string &cache_path, const std::string &path, const std::uint64_t size,
+        const std::uint64_t modified, central_repo &repo) {
+        std::uint32_t version = CENTRAL_REPO_INI_CACHE_VERSION;
+        std::uint64_t source_size = size;
+        std::uint64_t source_modified = modified;
+        std::string source_path = path;
+        std::uint32_t end_magic = CENTRAL_REPO_INI_CACHE_MAGIC;
+
+        std::vector<std::uint8_t> buf;
+
+        {
+            common::chunkyseri seri(nullptr, 0, common::SERI_MODE_MEASURE);
+            absorb_compiled_ini_tag(seri, version, source_size, source_modified, source_path);
+            do_state_for_compiled_ini(seri, repo);
+            seri.absorb(end_magic);
+
+            buf.resize(seri.size());
+        }
+
+        common::chunkyseri seri(&buf[0], buf.size(), common::SERI_MODE_WRITE);
+        absorb_compiled_ini_tag(seri, version, source_size, source_modified, source_path);
+        do_state_for_compiled_ini(seri, repo);
+        seri.absorb(end_magic);
+
+        std::ofstream cache_file(cache_path, std::ios::binary);
+
+        if (!cache_file) {
+            LOG_WARN("Can't write compiled repo cache to {}", cache_path);
+            return;
+        }
+
+        cache_file.write(reinterpret_cast<const char *>(&buf[0]), buf.size());
+    }
+
+    bool load_centrep_ini_cached(const std::string &path, const std::string &cache_folder, central_repo &repo) {
+        const std::int64_t size = common::file_size(path);
+        const std::uint64_t modified = common::get_last_modifiy_since_ad(common::utf8_to_ucs2(path));
+
+        if (size < 0) {
+            return false;
+        }
+
+        // Keyed by the source path. The full path is also in the tag, to catch hash collisions
+        const std::string cache_path = eka2l1::add_path(cache_folder,
+            common::to_string(common::hash(path), std::hex) + ".cri");
+
+        if (load_compiled_ini(cache_path, path, static_cast<std::uint64_t>(size), modified, repo)) {
+            return true;
+        }
+
+        if (!parse_new_centrep_ini(path, repo)) {
+            return false;
+        }
+
+        // Any repo may be the first one compiled, and the folder may be cleared while running
+        eka2l1::create_directories(cache_folder);
+        write_compiled_ini(cache_path, path, static_cast<std::uint64_t>(size), modified, repo);
+
+        return true;
+    }
+
     central_repo_server::central_repo_server(eka2l1::system *sys)
         : service::server(sys, "!CentralRepository", true)
-        , id_counter(0) {
+        , id_counter(0)
+        , compiled_ini_folder(eka2l1::add_path(sys->get_config()->storage, "cache/centralrepo/")) {
         REGISTER_IPC(central_repo_server, redirect_msg_to_session, cen_rep_init, "CenRep::Init");
         REGISTER_IPC(central_repo_server, redirect_msg_to_session, cen_rep_close, "CenRep::Close");
         REGISTER_IPC(central_repo_server, redirect_msg_to_session, cen_rep_reset, "CenRep::Reset");
@@ -383,7 +555,7 @@ namespace eka2l1 {
             }
 
             repo->uid = key;
-            if (parse_new_centrep_ini(common::ucs2_to_utf8(*path), *repo)) {
+            if (load_centrep_ini_cached(common::ucs2_to_utf8(*path), compiled_ini_folder, *repo)) {
                 repo->reside_place = avail_drives[0];
                 repo->access_count = 1;
                 return 0;
@@ -738,13 +910,14 @@ namespace eka2l1 {
         // Set found count to 0
         found_uid_result_array[0] = 0;
 
-        for (auto &entry: attach_repo->entries) {
-            // Try to match the key first
-            if ((entry.key & filter->id_mask) != (filter->partial_key & filter->id_mask)) {
-                // Mask doesn't match, abadon this entry
-                continue;
-            }
+        // Only entries whose key matches the filter are walked
+        std::vector<central_repo_entry *> key_matched_entries;
+        attach_repo->query_entries(filter->partial_key, filter->id_mask, key_matched_entries, central_repo_entry_type::none);
+
+        const std::optional<std::int32_t> int_to_compare = ctx->get_arg<std::int32_t>(1);
 
+        for (central_repo_entry *entry_ptr: key_matched_entries) {
+            central_repo_entry &entry = *entry_ptr;
             std::uint32_t key_found = 0;
             bool find_not_eq = false;
 
@@ -770,7 +943,7 @@ namespace eka2l1 {
 
                 // Index 1 argument contains the value we should look for
                 // TODO: Signed/unsigned is dangerous
-                if (static_cast<std::int32_t>(entry.data.intd) == *ctx->get_arg<std::int32_t>(1)) {
+                if (static_cast<std::int32_t>(entry.data.intd) == *int_to_compare) {
                     if (!find_not_eq) {
                         key_found = entry.key;
                     }
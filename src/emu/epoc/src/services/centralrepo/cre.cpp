@@ -285,6 +285,10 @@ namespace eka2l1 {
             }
         }
 
+        if (seri.get_seri_mode() == common::SERI_MODE_READ) {
+            repo.sort_entries();
+        }
+
         if (repo.ver >= 1) {
             std::uint32_t deleted_settings_count = static_cast<std::uint32_t>(repo.deleted_settings.size());
             seri.absorb(deleted_settings_count);
@@ -24,59 +24,74 @@ namespace eka2l1 {
         return default_meta;
     }
 
-    bool central_repo::add_new_entry(const std::uint32_t key, const central_repo_entry_variant &var) {
-        if (find_entry(key)) {
-            return false;
-        }
-
-        // Find default meta
-        central_repo_entry entry;
-        entry.metadata_val = get_default_meta_for_new_key(key);
-        entry.key = key;
-        entry.data = var;
-
-        entries.push_back(entry);
+    static std::vector<central_repo_entry>::iterator lower_bound_entry(std::vector<central_repo_entry> &entries,
+        const std::uint32_t key) {
+        return std::lower_bound(entries.begin(), entries.end(), key, [](const central_repo_entry &lhs, const std::uint32_t rhs) {
+            return lhs.key < rhs;
+        });
+    }
 
-        return true;
+    bool central_repo::add_new_entry(const std::uint32_t key, const central_repo_entry_variant &var) {
+        return add_new_entry(key, var, get_default_meta_for_new_key(key));
     }
 
     bool central_repo::add_new_entry(const std::uint32_t key, const central_repo_entry_variant &var,
         const std::uint32_t meta) {
-        if (find_entry(key)) {
+        auto ite = lower_bound_entry(entries, key);
+
+        if (ite != entries.end() && ite->key == key) {
             return false;
         }
 
-        // Find default meta
         central_repo_entry entry;
         entry.metadata_val = meta;
         entry.key = key;
         entry.data = var;
 
-        entries.push_back(entry);
+        entries.insert(ite, std::move(entry));
 
         return true;
     }
 
     central_repo_entry *central_repo::find_entry(const std::uint32_t key) {
-        auto ite = std::find_if(entries.begin(), entries.end(), [=](const central_repo_entry &e) {
-            return e.key == key;
-        });
+        auto ite = lower_bound_entry(entries, key);
 
-        if (ite == entries.end()) {
+        if (ite == entries.end() || ite->key != key) {
             return nullptr;
         }
 
         return &(*ite);
     }
+
+    void central_repo::sort_entries() {
+        auto key_less = [](const central_repo_entry &lhs, const central_repo_entry &rhs) {
+            return lhs.key < rhs.key;
+        };
+
+        if (!std::is_sorted(entries.begin(), entries.end(), key_less)) {
+            std::stable_sort(entries.begin(), entries.end(), key_less);
+        }
+    }
     
     void central_repo::query_entries(const std::uint32_t partial_key, const std::uint32_t mask,
         std::vector<central_repo_entry*> &matched_entries,
         const central_repo_entry_type etype) {
-        std::uint32_t required_mask = mask & partial_key;
-
-        for (auto &entry: entries) {
-            if ((entry.key & required_mask) && (entry.data.etype == etype)) {
-                matched_entries.push_back(&entry);
+        // Smear the highest unmasked bit down. Bits above it are fixed by the partial key, so all
+        // matching keys are in [lowest_key, highest_key]
+        std::uint32_t free_bits = ~mask;
+        free_bits |= free_bits >> 1;
+        free_bits |= free_bits >> 2;
+        free_bits |= free_bits >> 4;
+        free_bits |= free_bits >> 8;
+        free_bits |= free_bits >> 16;
+
+        const std::uint32_t lowest_key = partial_key & ~free_bits;
+        const std::uint32_t highest_key = lowest_key | free_bits;
+        const std::uint32_t required_bits = partial_key & mask;
+
+        for (auto ite = lower_bound_entry(entries, lowest_key); ite != entries.end() && ite->key <= highest_key; ite++) {
+            if (((ite->key & mask) == required_bits) && (etype == central_repo_entry_type::none || ite->data.etype == etype)) {
+                matched_entries.push_back(&(*ite));
             }
         }
     }
@@ -142,14 +157,7 @@ namespace eka2l1 {
         // If not in transaction, or if we are in transaction but read-mode
         // Directly get the repo data
         if (!active || mode == 0) {
-            auto result = std::find_if(attach_repo->entries.begin(), attach_repo->entries.end(),
-                [&](const central_repo_entry &entry) { return entry.key == key; });
-
-            if (result == attach_repo->entries.end()) {
-                return nullptr;
-            }
-
-            return &(*result);
+            return attach_repo->find_entry(key);
         }
 
         transactor.changes.emplace(key, central_repo_entry{});
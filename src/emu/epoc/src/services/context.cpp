@@ -134,13 +134,14 @@ namespace eka2l1 {
 
         void ipc_context::set_request_status(int res) {
             if (msg->request_sts) {
-                *(msg->request_sts.get(msg->own_thr->owning_process())) = res;
-
                 // Avoid signal twice to cause undefined behavior
-                if (!signaled) {
-                    signaled = true;
-                    msg->own_thr->signal_request();
+                if (requester_uid) {
+                    sys->get_kernel_system()->complete_request(requester_uid, msg->request_sts, res, !signaled);
+                } else {
+                    sys->get_kernel_system()->complete_request(msg->own_thr, msg->request_sts, res, !signaled);
                 }
+
+                signaled = true;
             }
         }
 
@@ -262,6 +263,31 @@ namespace eka2l1 {
             return descriptor->get_length();
         }
 
+        std::size_t ipc_context::get_arg_max_size(int idx) {
+            if (idx >= 4 || idx < 0) {
+                return static_cast<std::size_t>(-1);
+            }
+
+            const ipc_arg_type arg_type = msg->args.get_arg_type(idx);
+
+            if (!((int)arg_type & (int)ipc_arg_type::flag_des)) {
+                return static_cast<std::size_t>(-1);
+            }
+
+            kernel::process *own_pr = msg->own_thr->owning_process();
+            epoc::des8 *descriptor = ptr<epoc::des8>(msg->args.args[idx]).get(own_pr);
+
+            if (!descriptor) {
+                return static_cast<std::size_t>(-1);
+            }
+
+            if ((int)arg_type & (int)ipc_arg_type::flag_16b) {
+                return descriptor->get_max_length(own_pr) * 2;
+            }
+
+            return descriptor->get_max_length(own_pr);
+        }
+
         bool ipc_context::set_arg_des_len(const int idx, const std::uint32_t len) {
             ipc_arg_type arg_type = msg->args.get_arg_type(idx);
 
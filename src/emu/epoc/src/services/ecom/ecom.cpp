@@ -19,7 +19,6 @@
  */
 
 #include <cassert>
-#include <regex>
 
 #include <common/buffer.h>
 #include <common/chunkyseri.h>
@@ -37,51 +36,44 @@
 #include <epoc/services/ecom/common.h>
 #include <common/wildcard.h>
 #include <epoc/utils/err.h>
+#include <manager/config.h>
 
 namespace eka2l1 {
     bool ecom_server::register_implementation(const std::uint32_t interface_uid,
         ecom_implementation_info_ptr &impl) {
         auto &interface = interfaces[interface_uid];
+        interface.uid = interface_uid;
 
-        if (!std::binary_search(interface.implementations.begin(), interface.implementations.end(), impl,
-            [&](const ecom_implementation_info_ptr &impl1, const ecom_implementation_info_ptr &impl2) { return impl1->uid < impl2->uid; })) {
-            interface.implementations.push_back(impl);
-            implementations.push_back(impl);
-
-            // Sort
-            std::sort(interface.implementations.begin(), interface.implementations.end(),
-                [](const ecom_implementation_info_ptr &lhs, const ecom_implementation_info_ptr &rhs) {
-                    return lhs->uid < rhs->uid;
-                });
-            
-            std::sort(implementations.begin(), implementations.end(),
-                [](const ecom_implementation_info_ptr &lhs, const ecom_implementation_info_ptr &rhs) {
-                    return lhs->uid < rhs->uid;
-                });
+        auto compare_uid = [](const ecom_implementation_info_ptr &lhs, const ecom_implementation_info_ptr &rhs) {
+            return lhs->uid < rhs->uid;
+        };
 
-            return true;
+        // Both lists are kept sorted by UID, insert at the sorted position
+        auto interface_ite = std::lower_bound(interface.implementations.begin(), interface.implementations.end(),
+            impl, compare_uid);
+
+        if ((interface_ite != interface.implementations.end()) && ((*interface_ite)->uid == impl->uid)) {
+            return false;
         }
 
-        return false;
-    }
+        interface.implementations.insert(interface_ite, impl);
+        implementations.insert(std::upper_bound(implementations.begin(), implementations.end(), impl, compare_uid),
+            impl);
 
-    std::vector<std::string> ecom_server::get_ecom_plugin_archives(eka2l1::io_system *io) {
-        std::u16string pattern = u"";
+        return true;
+    }
 
-        // Get ROM drive first
-        for (drive_number drv = drive_z; drv >= drive_a; drv = static_cast<drive_number>(static_cast<int>(drv) - 1)) {
-            auto res = io->get_drive_entry(drv);
-            if (res && res->media_type == drive_media::rom) {
-                pattern += drive_to_char16(drv);
-            }
-        }
+    std::vector<std::string> ecom_server::get_ecom_plugin_archives(eka2l1::io_system *io, const drive_number drv) {
+        auto res = io->get_drive_entry(drv);
 
-        if (pattern.empty()) {
-            // For some reason, ROM hasn't been mounted yet, break!
+        if (!res || res->media_type != drive_media::rom) {
             return {};
         }
 
+        std::u16string pattern;
+        pattern += drive_to_char16(drv);
         pattern += u":\\Private\\10009d8f\\ecom-*-*.s*";
+
         auto ecom_private_dir = io->open_dir(pattern, io_attrib::none);
 
         if (!ecom_private_dir) {
@@ -99,8 +91,39 @@ namespace eka2l1 {
         return results;
     }
 
-    bool ecom_server::load_and_install_plugin_from_buffer(const std::u16string &name, std::uint8_t *buf, const std::size_t size,
-        const drive_number drv) {
+    std::vector<ecom_registry_source> ecom_server::get_registry_sources(eka2l1::io_system *io, const drive_number drv) {
+        std::vector<ecom_registry_source> sources;
+
+        if (!io->get_drive_entry(drv)) {
+            return sources;
+        }
+
+        for (const std::string &archive : get_ecom_plugin_archives(io, drv)) {
+            std::optional<entry_info> info = io->get_entry_info(common::utf8_to_ucs2(archive));
+
+            if (info) {
+                sources.push_back({ archive, info->size, info->last_write, true });
+            }
+        }
+
+        // Only the directory listing is needed to validate a registry, no resource is opened
+        std::u16string plugin_dir_path;
+        plugin_dir_path += drive_to_char16(drv);
+        plugin_dir_path += u":\\Resource\\Plugins\\*.r*";
+
+        auto plugin_dir = io->open_dir(plugin_dir_path, io_attrib::none);
+
+        if (plugin_dir) {
+            while (auto entry = plugin_dir->get_next_entry()) {
+                sources.push_back({ entry->full_path, entry->size, entry->last_write, false });
+            }
+        }
+
+        return sources;
+    }
+
+    bool ecom_server::parse_plugin_from_buffer(const std::u16string &name, std::uint8_t *buf, const std::size_t size,
+        const drive_number drv, const bool from_archive, std::vector<ecom_registry_entry> &entries) {
         common::ro_buf_stream stream(buf, size);
         loader::rsc_file rsc(reinterpret_cast<common::ro_stream*>(&stream));
 
@@ -113,144 +136,155 @@ namespace eka2l1 {
         }
 
         for (auto &pinterface : plugin.interfaces) {
-            // Get from the current interface on server
-            auto &interface_on_server = interfaces[pinterface.uid];
-            interface_on_server.uid = pinterface.uid;
-
             for (auto &impl : pinterface.implementations) {
                 impl->drv = drv;
                 impl->original_name = eka2l1::replace_extension(eka2l1::filename(name), u"");
 
-                if (impl->original_name.back() == u'\0') {
+                if (!impl->original_name.empty() && impl->original_name.back() == u'\0') {
                     impl->original_name.pop_back();
                 }
 
-                if (!register_implementation(pinterface.uid, impl)) {
-                    return false;
-                }
+                entries.push_back({ pinterface.uid, impl, from_archive });
             }
-
-            pinterface.implementations.clear();
         }
 
         return true;
     }
 
-    ecom_interface_info *ecom_server::get_interface(const epoc::uid interface_uid) {
-        if (!init) {
-            if (!load_plugins(sys->get_io_system())) {
-                LOG_ERROR("An error happens with initialization of ECom");
-            }
-
-            init = true;
-        }
+    void ecom_server::build_drive_registry(eka2l1::io_system *io, const drive_number drv, ecom_drive_registry &reg) {
+        reg.entries.clear();
 
-        // First, lookup the interface
-        auto interface_ite = interfaces.find(interface_uid);
+        for (const ecom_registry_source &source : reg.sources) {
+            const std::u16string source_path = common::utf8_to_ucs2(source.path);
+            symfile f = io->open_file(source_path, READ_MODE | BIN_MODE);
 
-        // We can't find the interface!!
-        if (interface_ite == interfaces.end()) {
-            return nullptr;
-        }
-
-        return &interface_ite->second;
-    }
-
-    bool ecom_server::load_archives(eka2l1::io_system *io) {
-        std::vector<std::string> archives = get_ecom_plugin_archives(io);
-
-        for (const std::string &archive : archives) {
-            const drive_number drv = char16_to_drive(archive[0]);
+            if (!f) {
+                LOG_ERROR("Can't open plugin source {}", source.path);
+                continue;
+            }
 
-            symfile f = io->open_file(common::utf8_to_ucs2(archive), READ_MODE | BIN_MODE);
             std::vector<std::uint8_t> buf;
             buf.resize(f->size());
 
-            f->read_file(&buf[0], static_cast<std::uint32_t>(buf.size()), 1);
+            if (!buf.empty()) {
+                f->read_file(&buf[0], static_cast<std::uint32_t>(buf.size()), 1);
+            }
+
             f->close();
 
+            if (!source.archive) {
+                if (buf.empty() || !parse_plugin_from_buffer(source_path, &buf[0], buf.size(), drv, false, reg.entries)) {
+                    LOG_ERROR("Can't load plugins description {}", source.path);
+                }
+
+                continue;
+            }
+
             common::chunkyseri seri(buf.data(), buf.size(), common::SERI_MODE_READ);
             loader::spi_file spi(0);
 
-            bool result = spi.do_state(seri);
-
-            if (!result) {
-                LOG_TRACE("SPI file {} corrupted!", archive);
-                return false;
+            if (!spi.do_state(seri)) {
+                LOG_TRACE("SPI file {} corrupted!", source.path);
+                continue;
             }
 
             for (auto &entry : spi.entries) {
-                result = load_and_install_plugin_from_buffer(
-                    common::utf8_to_ucs2(entry.name), &entry.file[0], entry.file.size(), drv);
-
-                if (!result) {
-                    LOG_WARN("Can't load and install plugin \"{}\"", entry.name);
+                if (!parse_plugin_from_buffer(common::utf8_to_ucs2(entry.name), &entry.file[0], entry.file.size(),
+                        drv, true, reg.entries)) {
+                    LOG_WARN("Can't load plugin \"{}\"", entry.name);
                 }
             }
         }
-
-        return true;
     }
 
-    bool ecom_server::load_plugins(eka2l1::io_system *io) {
-        // Load archives first
-        if (!load_archives(io)) {
+    bool ecom_server::load_drive_registry(eka2l1::io_system *io, const drive_number drv) {
+        ecom_drive_registry &reg = drive_registries[drv];
+        std::vector<ecom_registry_source> sources = get_registry_sources(io, drv);
+
+        // Something else on the drive was touched
+        if (init && (sources == reg.sources)) {
             return false;
         }
 
-        for (drive_number drv = drive_a; drv <= drive_z; drv = (drive_number)((int)drv + 1)) {
-            if (io->get_drive_entry(drv)) {
-                // Load and ignore invalid plugins
-                load_plugin_on_drive(io, drv);
-            }
+        reg = ecom_drive_registry{};
+
+        if (sources.empty()) {
+            return true;
         }
 
+        const std::string registry_path = eka2l1::add_path(registry_folder,
+            std::string(1, static_cast<char>(drive_to_char16(drv))) + ".ecr");
+
+        if (load_ecom_drive_registry(registry_path, reg) && (reg.sources == sources)) {
+            return true;
+        }
+
+        reg.sources = std::move(sources);
+        build_drive_registry(io, drv, reg);
+        save_ecom_drive_registry(registry_path, reg);
+
         return true;
     }
 
-    bool ecom_server::load_plugin_on_drive(eka2l1::io_system *io, const drive_number drv) {
-        // Opening directory
-        std::u16string plugin_dir_path;
-        plugin_dir_path += drive_to_char16(drv);
-        plugin_dir_path += u":\\Resource\\Plugins\\*.r*";
+    void ecom_server::install_drive_registries() {
+        interfaces.clear();
+        implementations.clear();
 
-        auto plugin_dir = io->open_dir(plugin_dir_path, io_attrib::none);
-        if (!plugin_dir) {
-            LOG_TRACE("Plugins directory for drive {} not found!",
-                static_cast<char>(plugin_dir_path[0]));
+        for (const bool archive_pass : { true, false }) {
+            for (ecom_drive_registry &reg : drive_registries) {
+                for (ecom_registry_entry &entry : reg.entries) {
+                    if (entry.from_archive == archive_pass) {
+                        register_implementation(entry.interface_uid, entry.impl);
+                    }
+                }
+            }
+        }
+    }
 
-            return false;
+    void ecom_server::sync_registry(eka2l1::io_system *io) {
+        if (!init) {
+            eka2l1::create_directories(registry_folder);
         }
 
-        while (auto entry = plugin_dir->get_next_entry()) {
-            symfile f = io->open_file(common::utf8_to_ucs2(entry->full_path), READ_MODE | BIN_MODE);
+        bool changed = false;
 
-            assert(f);
+        for (drive_number drv = drive_a; drv <= drive_z; drv = static_cast<drive_number>(static_cast<int>(drv) + 1)) {
+            const std::uint32_t generation = io->get_drive_generation(drv);
 
-            std::vector<std::uint8_t> dat;
-            dat.resize(f->size());
-            f->read_file(&dat[0], static_cast<std::uint32_t>(dat.size()), 1);
-            f->close();
+            if (init && (generation == drive_generations[drv])) {
+                continue;
+            }
 
-            if (!load_and_install_plugin_from_buffer(common::utf8_to_ucs2(entry->full_path), &dat[0], dat.size(), drv)) {
-                LOG_ERROR("Can't load and install plugins description {}", entry->name);
-                return false;
+            drive_generations[drv] = generation;
+
+            if (load_drive_registry(io, drv)) {
+                changed = true;
             }
         }
 
-        // TODO: Register a notification to the server side
+        if (changed) {
+            install_drive_registries();
+        }
 
-        return true;
+        init = true;
     }
 
-    void ecom_server::connect(service::ipc_context &ctx) {
-        if (!init) {
-            if (!load_plugins(ctx.sys->get_io_system())) {
-                LOG_ERROR("An error happens with initialization of ECom");
-            }
+    ecom_interface_info *ecom_server::get_interface(const epoc::uid interface_uid) {
+        sync_registry(sys->get_io_system());
+
+        // First, lookup the interface
+        auto interface_ite = interfaces.find(interface_uid);
+
+        // We can't find the interface!!
+        if (interface_ite == interfaces.end()) {
+            return nullptr;
         }
 
-        init = true;
+        return &interface_ite->second;
+    }
+
+    void ecom_server::connect(service::ipc_context &ctx) {
+        sync_registry(ctx.sys->get_io_system());
         ctx.set_request_status(epoc::error_none);
     }
 
@@ -385,12 +419,7 @@ namespace eka2l1 {
         // - All extended interfaces given are available in the implementation
         // - Match the wildcard (if wildcard not empty)
 
-        // May want to construct a regex for name comparing if we use generic match
-        std::regex wildcard_matcher;
-
-        if (list_impl_param.match_type && !match_str.empty()) {
-            wildcard_matcher = std::move(std::regex(common::wildcard_to_regex_string(match_str)));
-        }
+        const std::u16string match_str_16 = common::utf8_to_ucs2(match_str);
 
         // First, lookup the interface
         ecom_interface_info *interface = get_interface(uids.uid1);
@@ -416,9 +445,8 @@ namespace eka2l1 {
             bool sastify = true;
 
             for (std::uint32_t &given_extended_interface : given_extended_interfaces) {
-                if (std::lower_bound(implementation->extended_interfaces.begin(), implementation->extended_interfaces.end(),
-                        given_extended_interface)
-                    == implementation->extended_interfaces.end()) {
+                if (!std::binary_search(implementation->extended_interfaces.begin(), implementation->extended_interfaces.end(),
+                        given_extended_interface)) {
                     sastify = false;
                     break;
                 }
@@ -441,11 +469,11 @@ namespace eka2l1 {
             // We still need to see if the name is match
             // Generic match ? Wildcard check
             if (list_impl_param.match_type) {
-                if (std::regex_match(common::ucs2_to_utf8(implementation->display_name), wildcard_matcher)) {
+                if (common::match_wildcard(implementation->display_name, match_str_16, true)) {
                     sastify = true;
                 }
             } else {
-                if (match_str == common::ucs2_to_utf8(implementation->display_name)) {
+                if (match_str_16 == implementation->display_name) {
                     sastify = true;
                 }
             }
@@ -495,7 +523,10 @@ namespace eka2l1 {
     }
         
     ecom_server::ecom_server(eka2l1::system *sys)
-        : service::server(sys, "!ecomserver", true) {
+        : service::server(sys, "!ecomserver", true)
+        , registry_folder(eka2l1::add_path(sys->get_config()->storage, "cache/ecom/")) {
+        drive_generations.fill(0);
+
         REGISTER_IPC(ecom_server, list_implementations, ecom_list_implementations, "ECom::ListImpls");
         REGISTER_IPC(ecom_server, list_implementations, ecom_list_resolved_implementations, "ECom::ListResolvedImpls");
         REGISTER_IPC(ecom_server, list_implementations, ecom_list_custom_resolved_implementations, "ECom::ListCustomResolvedImpls");
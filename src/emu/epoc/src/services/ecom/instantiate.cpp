@@ -41,6 +41,8 @@ namespace eka2l1 {
         ecom_implementation_info_ptr impl_info = nullptr;
         
         if (interface_uid == 0) {
+            sync_registry(sys->get_io_system());
+
             // Find the implementation uid in the list
             auto result = std::lower_bound(implementations.begin(), implementations.end(), implementation_uid,
                 [=](const ecom_implementation_info_ptr &impl, const epoc::uid &rhs) { return impl->uid < rhs; });
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <common/chunkyseri.h>
+#include <common/fileutils.h>
+#include <common/log.h>
+#include <common/virtualmem.h>
+
+#include <epoc/services/ecom/registry.h>
+
+#include <fstream>
+
+namespace eka2l1 {
+    enum {
+        ECOM_REGISTRY_MAGIC = 0x49524345,       ///< ECRI
+        ECOM_REGISTRY_VERSION = 1
+    };
+
+    static void do_state_for_registry_impl(common::chunkyseri &seri, ecom_implementation_info &impl) {
+        seri.absorb(impl.original_name);
+        seri.absorb(impl.uid);
+        seri.absorb(impl.version);
+        seri.absorb(impl.format);
+        seri.absorb(impl.display_name);
+        seri.absorb(impl.default_data);
+        seri.absorb(impl.opaque_data);
+
+        // DLL info is resolved lazily on instantiation, so it is not stored
+        std::uint32_t flags = impl.flags & ~ecom_implementation_info::FLAG_IMPL_CREATE_INFO_CACHED;
+        seri.absorb(flags);
+
+        std::uint32_t drv32 = static_cast<std::uint32_t>(impl.drv);
+        seri.absorb(drv32);
+
+        if (seri.get_seri_mode() == common::SERI_MODE_READ) {
+            impl.flags = flags;
+            impl.drv = static_cast<drive_number>(drv32);
+        }
+
+        seri.absorb_container(impl.extended_interfaces);
+    }
+
+    static void do_state_for_registry(common::chunkyseri &seri, ecom_drive_registry &reg) {
+        seri.absorb_container(reg.sources, [](common::chunkyseri &seri, ecom_registry_source &source) {
+            seri.absorb(source.path);
+            seri.absorb(source.size);
+            seri.absorb(source.last_write);
+
+            std::uint8_t archive = source.archive ? 1 : 0;
+            seri.absorb(archive);
+            source.archive = (archive != 0);
+        });
+
+        seri.absorb_container(reg.entries, [](common::chunkyseri &seri, ecom_registry_entry &entry) {
+            seri.absorb(entry.interface_uid);
+
+            std::uint8_t from_archive = entry.from_archive ? 1 : 0;
+            seri.absorb(from_archive);
+            entry.from_archive = (from_archive != 0);
+
+            if (seri.get_seri_mode() == common::SERI_MODE_READ) {
+                entry.impl = std::make_shared<ecom_implementation_info>();
+            }
+
+            do_state_for_registry_impl(seri, *entry.impl);
+        });
+    }
+
+    static bool absorb_registry_header(common::chunkyseri &seri) {
+        std::uint32_t magic = ECOM_REGISTRY_MAGIC;
+        std::uint32_t version = ECOM_REGISTRY_VERSION;
+
+        seri.absorb(magic);
+        seri.absorb(version);
+
+        return (magic == ECOM_REGISTRY_MAGIC) && (version == ECOM_REGISTRY_VERSION);
+    }
+
+    bool load_ecom_drive_registry(const std::string &path, ecom_drive_registry &reg) {
+        const std::int64_t reg_size = common::file_size(path);
+
+        if (reg_size <= 0) {
+            return false;
+        }
+
+        std::uint8_t *reg_data = reinterpret_cast<std::uint8_t *>(common::map_file(path, prot::read, 0));
+
+        if (!reg_data) {
+            return false;
+        }
+
+        common::chunkyseri seri(reg_data, static_cast<std::size_t>(reg_size), common::SERI_MODE_READ);
+        bool result = absorb_registry_header(seri);
+
+        if (result) {
+            ecom_drive_registry loaded;
+            do_state_for_registry(seri, loaded);
+
+            // The trailing magic catches a registry file cut short
+            std::uint32_t end_magic = 0;
+            seri.absorb(end_magic);
+
+            result = (end_magic == ECOM_REGISTRY_MAGIC);
+
+            if (result) {
+                reg = std::move(loaded);
+            }
+        }
+
+        common::unmap_file(reg_data, static_cast<std::size_t>(reg_size));
+        return result;
+    }
+
+    bool save_ecom_drive_registry(const std::string &path, ecom_drive_registry &reg) {
+        std::uint32_t end_magic = ECOM_REGISTRY_MAGIC;
+        std::vector<std::uint8_t> buf;
+
+        {
+            common::chunkyseri seri(nullptr, 0, common::SERI_MODE_MEASURE);
+            absorb_registry_header(seri);
+            do_state_for_registry(seri, reg);
+            seri.absorb(end_magic);
+
+            buf.resize(seri.size());
+        }
+
+        common::chunkyseri seri(&buf[0], buf.size(), common::SERI_MODE_WRITE);
+        absorb_registry_header(seri);
+        do_state_for_registry(seri, reg);
+        seri.absorb(end_magic);
+
+        std::ofstream reg_file(path, std::ios::binary);
+
+        if (!reg_file) {
+            LOG_WARN("Can't write ECom registry to {}", path);
+            return false;
+        }
+
+        reg_file.write(reinterpret_cast<const char *>(&buf[0]), buf.size());
+        return static_cast<bool>(reg_file);
+    }
+}
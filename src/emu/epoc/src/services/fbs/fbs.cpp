@@ -39,7 +39,7 @@
 
 namespace eka2l1 {
     fbs_chunk_allocator::fbs_chunk_allocator(chunk_ptr de_chunk, std::uint8_t *dat_ptr)
-        : block_allocator(dat_ptr, de_chunk->committed())
+        : tlsf_allocator(dat_ptr, de_chunk->committed())
         , target_chunk(std::move(de_chunk)) {
     }
 
@@ -163,6 +163,10 @@ namespace eka2l1 {
         , large_chunk(nullptr) {
     }
 
+    enum {
+        FBS_GLYPH_CACHE_MAX_BYTES = 0x400000        ///< Rasterized glyph bitmaps kept around, in bytes.
+    };
+
     static void compressor_thread_func(compress_queue *queue) {
         common::set_thread_name("FBS Server compressor thread");
         queue->run();
@@ -216,6 +220,8 @@ namespace eka2l1 {
             large_chunk_allocator = std::make_unique<fbs_chunk_allocator>(large_chunk,
                 base_large_chunk);
 
+            glyphs = std::make_unique<epoc::glyph_cache>(large_chunk_allocator.get(), FBS_GLYPH_CACHE_MAX_BYTES);
+
             if (auto seg = sys->get_lib_manager()->load(u"fntstr.dll", nullptr)) {
                 // _ZTV11CBitmapFont @ 97 NONAME ; #<VT>#
                 // Skip the filler (vtable start address) and the typeinfo
@@ -297,6 +303,9 @@ namespace eka2l1 {
 
         clear_all_sessions();
 
+        // Glyphs live in the large chunk
+        glyphs.reset();
+
         // Destroy chunks.
         if (shared_chunk)
             kern->destroy(shared_chunk);
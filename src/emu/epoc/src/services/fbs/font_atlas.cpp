@@ -148,26 +148,30 @@ namespace eka2l1::epoc {
             drivers::blend_factor::frag_out_alpha, drivers::blend_factor::one_minus_frag_out_alpha,
             drivers::blend_factor::zero, drivers::blend_factor::one);
 
-        // Start to render these texts.
-        for (auto &chr: text) {
-            eka2l1::rect source_rect;
-            adapter::character_info &info = characters_[chr];
+        std::vector<eka2l1::rect> source_rects(text.size());
+        std::vector<eka2l1::rect> dest_rects(text.size());
+
+        // Start to render these texts. All glyphs come from the atlas, so they go in a single draw.
+        for (std::size_t i = 0; i < text.size(); i++) {
+            eka2l1::rect &source_rect = source_rects[i];
+            adapter::character_info &info = characters_[text[i]];
 
             source_rect.top = { info.x0, info.y0 };
             source_rect.size = eka2l1::object_size(info.x1 - info.x0, info.y1 - info.y0);
 
-            eka2l1::rect dest_rect;
+            eka2l1::rect &dest_rect = dest_rects[i];
             dest_rect.top.x = cur_pos.x + static_cast<int>(info.xoff);
             dest_rect.top.y = cur_pos.y + static_cast<int>(info.yoff);
             dest_rect.size.x = static_cast<int>(info.xoff2 - info.xoff);
             dest_rect.size.y = static_cast<int>(info.yoff2 - info.yoff);
 
-            builder->draw_bitmap(atlas_handle_, 0, dest_rect, source_rect, drivers::bitmap_draw_flag_use_brush);
-
             // TODO: Newline
             cur_pos.x += static_cast<int>(std::round(info.xadv));
         }
 
+        builder->draw_bitmaps(atlas_handle_, dest_rects.data(), source_rects.data(), static_cast<std::uint32_t>(text.size()),
+            drivers::bitmap_draw_flag_use_brush);
+
         builder->set_blend_mode(false);
 
         return true;
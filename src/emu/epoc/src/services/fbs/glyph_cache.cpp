@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <common/allocator.h>
+#include <common/hash.h>
+
+#include <epoc/services/fbs/glyph_cache.h>
+
+#include <cstring>
+
+namespace eka2l1::epoc {
+    std::size_t glyph_cache_key_hasher::operator()(const glyph_cache_key &key) const {
+        std::size_t seed = 0;
+
+        common::hash_combine(seed, key.face);
+        common::hash_combine(seed, key.face_idx);
+        common::hash_combine(seed, key.scale_x);
+        common::hash_combine(seed, key.scale_y);
+        common::hash_combine(seed, key.code);
+
+        return seed;
+    }
+
+    glyph_cache::glyph_cache(common::allocator *alloc, const std::size_t max_bytes)
+        : alloc_(alloc)
+        , max_bytes_(max_bytes)
+        , used_bytes_(0) {
+    }
+
+    glyph_cache::~glyph_cache() {
+        clear();
+    }
+
+    bool glyph_cache::evict_last() {
+        if (lru_.empty()) {
+            return false;
+        }
+
+        glyph_cache_entry &entry = lru_.back().second;
+
+        if (entry.bitmap) {
+            alloc_->free(entry.bitmap);
+        }
+
+        used_bytes_ -= static_cast<std::size_t>(entry.width * entry.height);
+
+        lookup_.erase(lru_.back().first);
+        lru_.pop_back();
+
+        return true;
+    }
+
+    const glyph_cache_entry *glyph_cache::get(const glyph_cache_key &key) {
+        auto result = lookup_.find(key);
+
+        if (result == lookup_.end()) {
+            return nullptr;
+        }
+
+        // Move to the front, iterators stay valid
+        lru_.splice(lru_.begin(), lru_, result->second);
+        return &result->second->second;
+    }
+
+    const glyph_cache_entry *glyph_cache::add(const glyph_cache_key &key, const std::uint8_t *bitmap, const int width,
+        const int height, const glyph_bitmap_type bitmap_type, const open_font_character_metric &metric) {
+        const std::size_t bitmap_size = static_cast<std::size_t>(width * height);
+
+        if (bitmap_size > max_bytes_) {
+            return nullptr;
+        }
+
+        auto existing = lookup_.find(key);
+
+        if (existing != lookup_.end()) {
+            // Rasterizing the same glyph twice gives the same bitmap
+            lru_.splice(lru_.begin(), lru_, existing->second);
+            return &existing->second->second;
+        }
+
+        while (used_bytes_ + bitmap_size > max_bytes_) {
+            evict_last();
+        }
+
+        std::uint8_t *copy = nullptr;
+
+        if (bitmap_size != 0) {
+            copy = reinterpret_cast<std::uint8_t *>(alloc_->allocate(bitmap_size));
+
+            // The arena may be fragmented or shared with other data, make space and retry
+            while (!copy && evict_last()) {
+                copy = reinterpret_cast<std::uint8_t *>(alloc_->allocate(bitmap_size));
+            }
+
+            if (!copy) {
+                return nullptr;
+            }
+
+            std::memcpy(copy, bitmap, bitmap_size);
+        }
+
+        glyph_cache_entry entry;
+        entry.bitmap = copy;
+        entry.width = width;
+        entry.height = height;
+        entry.bitmap_type = bitmap_type;
+        entry.metric = metric;
+
+        lru_.emplace_front(key, entry);
+        lookup_.emplace(key, lru_.begin());
+
+        used_bytes_ += bitmap_size;
+        return &lru_.front().second;
+    }
+
+    void glyph_cache::clear() {
+        while (evict_last()) {
+        }
+    }
+}
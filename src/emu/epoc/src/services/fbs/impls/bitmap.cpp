@@ -302,10 +302,19 @@ namespace eka2l1 {
 
     void fbscli::load_bitmap(service::ipc_context *ctx) {
         // Get the FS session
-        session_ptr fs_target_session = ctx->sys->get_kernel_system()->get<service::session>(*(ctx->get_arg<std::int32_t>(2)));
+        session_ptr fs_target_session = ctx->sys->get_kernel_system()->get<service::session>(
+            *(ctx->get_arg<std::int32_t>(2)), ctx->msg->own_thr);
         const std::uint32_t fs_file_handle = *(ctx->get_arg<std::uint32_t>(3));
 
+        if (!fs_target_session) {
+            ctx->set_request_status(epoc::error_bad_handle);
+            return;
+        }
+
         auto fs_server = reinterpret_cast<eka2l1::fs_server*>(server<fbs_server>()->fs_server);
+
+        // The file server may be running on its worker, keep it off the file while it's read
+        auto fs_work_guard = fs_server->acquire_work_lock();
         file *source_file = fs_server->get_file(fs_target_session->unique_id(), fs_file_handle);
 
         if (!source_file) {
@@ -529,20 +529,12 @@ namespace eka2l1 {
             LOG_DEBUG("Trying to rasterize character '{}' (code {})", static_cast<char>(codepoint), codepoint);
         }
 
-        int rasterized_width = 0;
-        int rasterized_height = 0;
-
         const epoc::open_font_info *info = &(font->of_info);
-        epoc::glyph_bitmap_type bitmap_type = epoc::glyph_bitmap_type::default_glyph_bitmap;
+        fbs_server *serv = server<fbs_server>();
 
-        // Get server font handle
-        // The returned bitmap is 8bpp single channel. Luckly Symbian likes this. (at least in v3 and upper).
-        std::uint8_t *bitmap_data = info->adapter->get_glyph_bitmap(info->idx, codepoint, info->scale_factor_x,
-            info->scale_factor_y, &rasterized_width, &rasterized_height, &bitmap_type);
+        const epoc::glyph_cache_entry *glyph = serv->rasterize_glyph_cached(*info, codepoint);
 
-        const std::size_t bitmap_data_size = rasterized_height * rasterized_width;
-    
-        if (!bitmap_data) {
+        if (!glyph) {
             // The glyph is not available. Let the client know. With code 0, we already use '?'
             // On S^3, it expect us to return false here.
             // On lower version, it expect us to return nullptr, so use 0 here is for the best.
@@ -550,8 +542,9 @@ namespace eka2l1 {
             return;
         }
 
+        const std::size_t bitmap_data_size = glyph->height * glyph->width;
+
         // Add it to session cache
-        fbs_server *serv = server<fbs_server>();
         kernel::process *pr = ctx->msg->own_thr->owning_process();
 
         #define MAKE_CACHE_ENTRY(entry_ver)                                                                                 \
@@ -562,11 +555,11 @@ namespace eka2l1 {
             cache_entry->codepoint = codepoint;                                                                             \
             cache_entry->glyph_index = codepoint % session_cache->offset_array.offset_array_count;                          \
             cache_entry->offset = sizeof(epoc::open_font_session_cache_entry_v##entry_ver) + 1;                             \
-            info->adapter->get_glyph_metric(info->idx, codepoint, cache_entry->metric,                                      \
-                bmp_font->algorithic_style.baseline_offsets_in_pixel, info->scale_factor_x, info->scale_factor_y);          \
-            cache_entry->metric.width = rasterized_width;                                                                   \
-            cache_entry->metric.height = rasterized_height;                                                                 \
-            cache_entry->metric.bitmap_type = bitmap_type;                                                                  \
+            cache_entry->metric = glyph->metric;                                                                            \
+            cache_entry->metric.horizontal_bearing_y -= bmp_font->algorithic_style.baseline_offsets_in_pixel;               \
+            cache_entry->metric.width = glyph->width;                                                                       \
+            cache_entry->metric.height = glyph->height;                                                                     \
+            cache_entry->metric.bitmap_type = glyph->bitmap_type;                                                           \
             const auto cache_entry_ptr = serv->host_ptr_to_guest_general_data(cache_entry).ptr_address();                   \
             if (epoc::does_client_use_pointer_instead_of_offset(this)) {                                                    \
                 cache_entry->font_offset = static_cast<std::int32_t>(bmp_font->openfont.ptr_address());                     \
@@ -574,9 +567,10 @@ namespace eka2l1 {
                 cache_entry->font_offset = static_cast<std::int32_t>(bmp_font->openfont.ptr_address() -                     \
                     cache_entry_ptr);                                                                                       \
             }                                                                                                               \
-            std::memcpy(reinterpret_cast<std::uint8_t*>(cache_entry) + cache_entry->offset, bitmap_data,                    \
-                bitmap_data_size);                                                                                          \
-            info->adapter->free_glyph_bitmap(bitmap_data);                                                                  \
+            if (bitmap_data_size != 0) {                                                                                    \
+                std::memcpy(reinterpret_cast<std::uint8_t*>(cache_entry) + cache_entry->offset, glyph->bitmap,              \
+                    bitmap_data_size);                                                                                      \
+            }                                                                                                               \
             if (epoc::does_client_use_pointer_instead_of_offset(this)) {                                                    \
                 cache_entry->offset += static_cast<std::int32_t>(cache_entry_ptr);                                          \
             }                                                                                                               \
@@ -634,6 +628,52 @@ namespace eka2l1 {
         epoc::ref_count_object::deref();
     }
 
+    const epoc::glyph_cache_entry *fbs_server::rasterize_glyph_cached(const epoc::open_font_info &info, const std::uint32_t code) {
+        const epoc::glyph_cache_key key { info.adapter, static_cast<std::uint32_t>(info.idx), info.scale_factor_x,
+            info.scale_factor_y, code };
+
+        if (const epoc::glyph_cache_entry *cached = glyphs->get(key)) {
+            return cached;
+        }
+
+        int rasterized_width = 0;
+        int rasterized_height = 0;
+
+        epoc::glyph_bitmap_type bitmap_type = epoc::glyph_bitmap_type::default_glyph_bitmap;
+
+        // The returned bitmap is 8bpp single channel. Luckly Symbian likes this. (at least in v3 and upper).
+        std::uint8_t *bitmap_data = info.adapter->get_glyph_bitmap(info.idx, code, info.scale_factor_x,
+            info.scale_factor_y, &rasterized_width, &rasterized_height, &bitmap_type);
+
+        if (!bitmap_data) {
+            return nullptr;
+        }
+
+        // Baseline offset differs between fonts made from the same face, it's applied on use
+        epoc::open_font_character_metric metric {};
+        info.adapter->get_glyph_metric(info.idx, code, metric, 0, info.scale_factor_x, info.scale_factor_y);
+
+        const epoc::glyph_cache_entry *entry = glyphs->add(key, bitmap_data, rasterized_width, rasterized_height,
+            bitmap_type, metric);
+
+        if (!entry) {
+            LOG_WARN("Can't cache glyph {} of size {}x{}, using it uncached", code, rasterized_width, rasterized_height);
+
+            uncached_glyph_bitmap.assign(bitmap_data, bitmap_data + rasterized_width * rasterized_height);
+
+            uncached_glyph.bitmap = uncached_glyph_bitmap.data();
+            uncached_glyph.width = rasterized_width;
+            uncached_glyph.height = rasterized_height;
+            uncached_glyph.bitmap_type = bitmap_type;
+            uncached_glyph.metric = metric;
+
+            entry = &uncached_glyph;
+        }
+
+        info.adapter->free_glyph_bitmap(bitmap_data);
+        return entry;
+    }
+
     fbsfont *fbs_server::get_font(const service::uid id) {
         return font_obj_container.get<fbsfont>(id);
     }
@@ -49,34 +49,37 @@ namespace eka2l1::service {
     }
 
     void typical_server::disconnect(service::ipc_context &ctx) {
-        sessions.erase(ctx.msg->msg_session->unique_id());
-        ctx.set_request_status(0);
-    }
+        typical_session_ptr closing;
 
-    void typical_server::process_accepted_msg() {
-        int res = receive(process_msg);
+        {
+            const std::lock_guard<std::mutex> guard(sessions_lock);
+            auto ss_ite = sessions.find(ctx.msg->msg_session->unique_id());
 
-        if (res == -1) {
-            return;
+            if (ss_ite != sessions.end()) {
+                closing = std::move(ss_ite->second);
+                sessions.erase(ss_ite);
+            }
         }
 
-        ipc_context context;
-        context.sys = sys;
-        context.msg = process_msg;
-        
-        auto func = ipc_funcs.find(process_msg->function);
+        // Destroy outside of the lock, the session may still look up its siblings
+        closing.reset();
+        ctx.set_request_status(0);
+    }
+
+    void typical_server::dispatch(service::ipc_context &context) {
+        auto func = ipc_funcs.find(context.msg->function);
 
         if (func != ipc_funcs.end()) {
             func->second.wrapper(context);
             return;
         }
 
-        auto ss_ite = sessions.find(process_msg->msg_session->unique_id());
+        typical_session *ss = session<typical_session>(context.msg->msg_session->unique_id());
 
-        if (ss_ite == sessions.end()) {
+        if (!ss) {
             return;
         }
 
-        ss_ite->second->fetch(&context);
+        ss->fetch(&context);
     }
 }
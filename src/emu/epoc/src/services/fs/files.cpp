@@ -335,9 +335,11 @@ namespace eka2l1 {
             return;
         }
 
-        std::optional<std::string> write_data = ctx->get_arg<std::string>(0);
+        // Write straight from the guest descriptor, no need to copy it out first
+        const std::uint8_t *write_data = ctx->get_arg_ptr(0);
+        const std::size_t write_data_size = ctx->get_arg_size(0);
 
-        if (!write_data) {
+        if (!write_data || (write_data_size == static_cast<std::size_t>(-1))) {
             ctx->set_request_status(epoc::error_argument);
             return;
         }
@@ -357,6 +359,7 @@ namespace eka2l1 {
         }
 
         std::int32_t write_len = *ctx->get_arg<std::int32_t>(1);
+        write_len = static_cast<std::int32_t>(common::min<std::size_t>(write_len, write_data_size));
         std::int32_t write_pos_provided = *ctx->get_arg<std::int32_t>(2);
 
         std::uint64_t write_pos = 0;
@@ -372,7 +375,7 @@ namespace eka2l1 {
 
         // If this write pos is beyond the current end of file, use last pos
         vfs_file->seek(write_pos > last_pos ? last_pos : write_pos, file_seek_mode::beg);
-        size_t wrote_size = vfs_file->write_file(&(*write_data)[0], 1, write_len);
+        size_t wrote_size = vfs_file->write_file(const_cast<std::uint8_t *>(write_data), 1, write_len);
 
         // LOG_TRACE("File {} wroted with size: {}",
         //    common::ucs2_to_utf8(vfs_file->file_name()), wrote_size);
@@ -402,6 +405,15 @@ namespace eka2l1 {
             return;
         }
 
+        // Read straight into the guest descriptor, no need for a host buffer
+        std::uint8_t *read_dest = ctx->get_arg_ptr(0);
+        const std::size_t read_dest_max_size = ctx->get_arg_max_size(0);
+
+        if (!read_dest || (read_dest_max_size == static_cast<std::size_t>(-1))) {
+            ctx->set_request_status(epoc::error_argument);
+            return;
+        }
+
         int read_len = *ctx->get_arg<std::int32_t>(1);
         int read_pos_provided = *ctx->get_arg<std::int32_t>(2);
 
@@ -420,16 +432,16 @@ namespace eka2l1 {
 
         uint64_t size = vfs_file->size();
 
-        if (size - read_pos < read_len) {
-            read_len = static_cast<int>(size - last_pos);
+        if (read_pos >= size) {
+            read_len = 0;
+        } else if (size - read_pos < read_len) {
+            read_len = static_cast<int>(size - read_pos);
         }
 
-        std::vector<char> read_data;
-        read_data.resize(read_len);
-
-        size_t read_finish_len = vfs_file->read_file(read_data.data(), 1, read_len);
+        read_len = static_cast<int>(common::min<std::size_t>(read_len, read_dest_max_size));
 
-        ctx->write_arg_pkg(0, reinterpret_cast<uint8_t *>(read_data.data()), read_len);
+        size_t read_finish_len = (read_len > 0) ? vfs_file->read_file(read_dest, 1, read_len) : 0;
+        ctx->set_arg_des_len(0, static_cast<std::uint32_t>(read_finish_len));
 
         // LOG_TRACE("Readed {} from {} to address 0x{:x}", read_finish_len, read_pos, ctx->msg->args.args[0]);
         ctx->set_request_status(epoc::error_none);
@@ -65,6 +65,9 @@ namespace eka2l1 {
 
         system_drive_prop->first = static_cast<int>(FS_UID);
         system_drive_prop->second = static_cast<int>(SYSTEM_DRIVE_KEY);
+
+        // Requests here mostly wait on the host file system
+        run_on_worker();
     }
 
     void fs_server_client::fetch(service::ipc_context *ctx) {
@@ -23,7 +23,9 @@
 #include <epoc/epoc.h>
 #include <epoc/kernel.h>
 #include <epoc/services/server.h>
+#include <epoc/services/worker.h>
 #include <epoc/timing.h>
+#include <epoc/utils/err.h>
 
 #include <manager/manager.h>
 #include <manager/config.h>
@@ -39,17 +41,12 @@ namespace eka2l1 {
         }
 
         bool server::is_msg_delivered(ipc_msg_ptr &msg) {
-            auto res = std::find_if(delivered_msgs.begin(), delivered_msgs.end(),
-                [&](const auto &svr_msg) { return svr_msg.real_msg->id == msg->id; });
-
-            if (res != delivered_msgs.end()) {
-                return true;
-            }
-
-            return false;
+            return delivered_msgs.contains(msg);
         }
 
         server::~server() {
+            delivered_msgs.clear();
+
             process_msg->unlock_free();
             kern->free_msg(process_msg);
         }
@@ -57,8 +54,11 @@ namespace eka2l1 {
         // Create a server with name
         server::server(system *sys, const std::string name, bool hle, bool unhandle_callback_enable)
             : sys(sys)
+            , total_delivered(0)
             , hle(hle)
             , unhandle_callback_enable(unhandle_callback_enable)
+            , workers(nullptr)
+            , worker_index(0)
             , kernel_obj(sys->get_kernel_system(), name, nullptr, kernel::access_type::global_access) {
             kernel_system *kern = sys->get_kernel_system();
             process_msg = kern->create_msg(kernel::owner_type::process);
@@ -71,15 +71,13 @@ namespace eka2l1 {
         }
 
         int server::receive(ipc_msg_ptr &msg) {
-            /* If there is pending message, pop the last one and accept it */
+            /* If there is pending message, pop the oldest one and accept it */
             if (!delivered_msgs.empty()) {
-                server_msg yet_pending = std::move(delivered_msgs.back());
-
+                server_msg yet_pending;
+                yet_pending.real_msg = delivered_msgs.pop_front();
                 yet_pending.dest_msg = msg;
 
                 accept(yet_pending);
-                delivered_msgs.pop_back();
-
                 return 0;
             }
 
@@ -113,6 +111,9 @@ namespace eka2l1 {
         }
 
         int server::deliver(server_msg msg) {
+            total_delivered++;
+            opcode_delivered[msg.real_msg->function]++;
+
             // Is ready
             if (ready()) {
                 msg.dest_msg = request_msg;
@@ -120,7 +121,7 @@ namespace eka2l1 {
 
                 finish_request_lle(msg.dest_msg, true);
             } else {
-                delivered_msgs.push_back(msg);
+                delivered_msgs.push_back(msg.real_msg);
             }
 
             return 0;
@@ -136,27 +137,22 @@ namespace eka2l1 {
             ipc_funcs.emplace(ordinal, func);
         }
 
-        // Processed asynchronously, use for HLE service where accepted function
-        // is fetched imm
-        void server::process_accepted_msg() {
-            int res = receive(process_msg);
+        void server::run_on_worker() {
+            workers = sys->get_kernel_system()->get_server_workers();
 
-            if (res == -1) {
-                return;
+            if (workers) {
+                worker_index = workers->assign();
             }
+        }
 
-            int func = process_msg->function;
+        void server::dispatch(service::ipc_context &context) {
+            int func = context.msg->function;
 
             auto func_ite = ipc_funcs.find(func);
 
             if (func_ite == ipc_funcs.end()) {
                 if (unhandle_callback_enable) {
-                    ipc_context context;
-                    context.sys = sys;
-                    context.msg = process_msg;
-
                     on_unhandled_opcode(context);
-
                     return;
                 }
 
@@ -169,9 +165,6 @@ namespace eka2l1 {
             }
 
             ipc_func ipf = func_ite->second;
-            ipc_context context;
-            context.sys = sys;
-            context.msg = process_msg;
 
             if (sys->get_config()->log_ipc) {
                 LOG_INFO("Calling IPC: {}, id: {}", ipf.name, func);
@@ -180,6 +173,85 @@ namespace eka2l1 {
             ipf.wrapper(context);
         }
 
+        void server::process_accepted_msg_on_worker() {
+            kernel_system *kern = sys->get_kernel_system();
+
+            // Each message in flight needs its own slot, the placeholder one is reused right away
+            ipc_msg_ptr msg = kern->create_msg(kernel::owner_type::process);
+
+            if (!msg) {
+                // Handling it here would race with the worker, fail it like the kernel does
+                if ((receive(process_msg) != -1) && process_msg->request_sts) {
+                    kern->complete_request(process_msg->own_thr, process_msg->request_sts, epoc::error_no_memory);
+                }
+
+                return;
+            }
+
+            if (receive(msg) == -1) {
+                kern->free_msg(msg);
+                return;
+            }
+
+            // Connect may create kernel objects, only the emulation thread can do that
+            if (msg->function == -1) {
+                const std::lock_guard<std::mutex> guard(work_lock);
+
+                ipc_context context(false);
+                context.sys = sys;
+                context.msg = msg;
+
+                dispatch(context);
+                kern->free_msg(msg);
+
+                return;
+            }
+
+            // The worker only completes the request by UID, the thread is looked up on the emulation thread.
+            // Handlers still read the client's memory through it, that is fine as threads are only freed when
+            // the kernel shuts down, after the workers are stopped.
+            const kernel::uid requester_uid = msg->own_thr->unique_id();
+
+            workers->post(worker_index, [this, kern, msg, requester_uid]() {
+                {
+                    const std::lock_guard<std::mutex> guard(work_lock);
+
+                    ipc_context context(false);
+                    context.sys = sys;
+                    context.msg = msg;
+                    context.requester_uid = requester_uid;
+
+                    dispatch(context);
+                }
+
+                // Queued after the completion, so the slot is not reused before the client is signaled
+                kern->call_on_emulation_thread([kern, msg]() {
+                    kern->free_msg(msg);
+                });
+            });
+        }
+
+        // Processed asynchronously, use for HLE service where accepted function
+        // is fetched imm
+        void server::process_accepted_msg() {
+            if (workers) {
+                process_accepted_msg_on_worker();
+                return;
+            }
+
+            int res = receive(process_msg);
+
+            if (res == -1) {
+                return;
+            }
+
+            ipc_context context;
+            context.sys = sys;
+            context.msg = process_msg;
+
+            dispatch(context);
+        }
+
         void server::destroy() {
             sys->get_kernel_system()->free_msg(process_msg);
         }
@@ -208,7 +280,6 @@ namespace eka2l1 {
         void server::receive_async_lle(eka2l1::ptr<epoc::request_status> msg_request_status,
             eka2l1::ptr<message2> data) {
             ipc_msg_ptr msg = sys->get_kernel_system()->create_msg(kernel::owner_type::process);
-            msg->free = false;
 
             int res = receive(msg);
 
@@ -30,6 +30,7 @@
 
 #include <algorithm>
 
+#include <common/algorithm.h>
 #include <common/buffer.h>
 #include <common/runlen.h>
 #include <common/time.h>
@@ -42,7 +43,10 @@ namespace eka2l1::epoc {
         : base_large_chunk(nullptr)
         , kern(kern_) {
         std::fill(driver_textures.begin(), driver_textures.end(), 0);
+        std::fill(bitmaps.begin(), bitmaps.end(), nullptr);
         std::fill(hashes.begin(), hashes.end(), 0);
+        std::fill(lru_prev.begin(), lru_prev.end(), -1);
+        std::fill(lru_next.begin(), lru_next.end(), -1);
     }
 
     bool is_palette_bitmap(epoc::bitwise_bitmap *bw_bmp) {
@@ -52,12 +56,13 @@ namespace eka2l1::epoc {
             || (dsp == epoc::display_mode::color16mu) || (dsp == epoc::display_mode::color256);
     }
 
-    static char *converted_palette_bitmap_to_twenty_four_bitmap(epoc::bitwise_bitmap *bw_bmp,
-        const std::uint8_t *original_ptr, std::vector<char> &converted_pool) {
-        std::uint32_t byte_width_converted = common::align(bw_bmp->header_.size_pixels.x * 3, 4);
-        converted_pool.resize(byte_width_converted * bw_bmp->header_.size_pixels.y);
+    static std::uint32_t get_converted_palette_bitmap_size(epoc::bitwise_bitmap *bw_bmp) {
+        return common::align(bw_bmp->header_.size_pixels.x * 3, 4) * bw_bmp->header_.size_pixels.y;
+    }
 
-        char *return_ptr = &converted_pool[0];
+    static void converted_palette_bitmap_to_twenty_four_bitmap(epoc::bitwise_bitmap *bw_bmp,
+        const std::uint8_t *original_ptr, char *return_ptr) {
+        std::uint32_t byte_width_converted = common::align(bw_bmp->header_.size_pixels.x * 3, 4);
         
         for (std::size_t y = 0; y < bw_bmp->header_.size_pixels.y; y++) {
             for (std::size_t x = 0; x < bw_bmp->header_.size_pixels.x; x++) {
@@ -77,8 +82,6 @@ namespace eka2l1::epoc {
                 }
             }
         }
-
-        return return_ptr;
     }
 
     std::uint64_t bitmap_cache::hash_bitwise_bitmap(epoc::bitwise_bitmap *bw_bmp) {
@@ -91,12 +94,10 @@ namespace eka2l1::epoc {
         // First, hash the single bitmap header
         XXH64_update(state, reinterpret_cast<const void *>(&bw_bmp->header_), sizeof(loader::sbm_header));
 
-        // Now, hash the byte width and UID, if it changes, we need to update
+        // Now, hash the byte width, UID and data location, if it changes, we need to recreate the texture
         XXH64_update(state, reinterpret_cast<const void *>(&bw_bmp->byte_width_), sizeof(bw_bmp->byte_width_));
         XXH64_update(state, reinterpret_cast<const void *>(&bw_bmp->uid_), sizeof(bw_bmp->uid_));
-
-        // Lastly, we needs to hash the data, to see if anything changed
-        XXH64_update(state, base_large_chunk + bw_bmp->data_offset_, bw_bmp->header_.bitmap_size - sizeof(bw_bmp->header_));
+        XXH64_update(state, reinterpret_cast<const void *>(&bw_bmp->data_offset_), sizeof(bw_bmp->data_offset_));
 
         hash = XXH64_digest(state);
         XXH64_freeState(state);
@@ -104,24 +105,167 @@ namespace eka2l1::epoc {
         return hash;
     }
 
-    std::int64_t bitmap_cache::get_suitable_bitmap_index() {
-        // First time, will scans through the bitmap array to find empty box
-        // Sometimes, app might purges a lot of bitmaps at same time
-        for (std::int64_t i = MAX_CACHE_SIZE - 1; i >= 0; i--) {
-            if (!bitmaps[i]) {
-                return i;
+    void bitmap_cache::find_dirty_rows(const std::int64_t idx, epoc::bitwise_bitmap *bw_bmp, std::int32_t &first_row,
+        std::int32_t &row_count) {
+        const std::uint8_t *data = base_large_chunk + bw_bmp->data_offset_;
+        const std::uint32_t data_size = bw_bmp->header_.bitmap_size - bw_bmp->header_.header_len;
+        const std::int32_t height = static_cast<std::int32_t>(bw_bmp->header_.size_pixels.y);
+
+        // Compressed and converted bitmaps can't be partially uploaded. Hash them as one band.
+        const bool whole = (bw_bmp->header_.compression != bitmap_file_no_compression) || is_palette_bitmap(bw_bmp);
+        const std::uint32_t band_size = whole ? data_size : static_cast<std::uint32_t>(bw_bmp->byte_width_ * DIRTY_BAND_ROWS);
+
+        std::vector<std::uint64_t> &bands = band_hashes[idx];
+        const std::size_t band_count = (band_size == 0) ? 0 : (data_size + band_size - 1) / band_size;
+
+        bands.resize(band_count, 0);
+
+        std::int64_t first_dirty = -1;
+        std::int64_t last_dirty = -1;
+
+        for (std::size_t i = 0; i < band_count; i++) {
+            const std::uint32_t offset = static_cast<std::uint32_t>(i * band_size);
+            const std::uint64_t hash = XXH64(data + offset, common::min(band_size, data_size - offset), 0xB1711A3F);
+
+            if (hash != bands[i]) {
+                bands[i] = hash;
+
+                if (first_dirty == -1) {
+                    first_dirty = i;
+                }
+
+                last_dirty = i;
             }
         }
 
-        // Next, we will compare the timestamp
-        std::uint64_t oldest_timestamp_idx = 0;
-        for (std::int64_t i = 1; i < MAX_CACHE_SIZE; i++) {
-            if (timestamps[i] < timestamps[oldest_timestamp_idx]) {
-                oldest_timestamp_idx = i;
+        if (first_dirty == -1) {
+            first_row = 0;
+            row_count = 0;
+            return;
+        }
+
+        if (whole) {
+            first_row = 0;
+            row_count = height;
+            return;
+        }
+
+        first_row = static_cast<std::int32_t>(first_dirty * DIRTY_BAND_ROWS);
+        row_count = common::min<std::int32_t>(static_cast<std::int32_t>((last_dirty + 1) * DIRTY_BAND_ROWS), height) - first_row;
+    }
+
+    void bitmap_cache::lru_unlink(const std::int64_t idx) {
+        if (lru_prev[idx] != -1) {
+            lru_next[lru_prev[idx]] = lru_next[idx];
+        } else if (lru_head == idx) {
+            lru_head = lru_next[idx];
+        }
+
+        if (lru_next[idx] != -1) {
+            lru_prev[lru_next[idx]] = lru_prev[idx];
+        } else if (lru_tail == idx) {
+            lru_tail = lru_prev[idx];
+        }
+
+        lru_prev[idx] = -1;
+        lru_next[idx] = -1;
+    }
+
+    void bitmap_cache::lru_push_front(const std::int64_t idx) {
+        lru_prev[idx] = -1;
+        lru_next[idx] = lru_head;
+
+        if (lru_head != -1) {
+            lru_prev[lru_head] = idx;
+        }
+
+        lru_head = idx;
+
+        if (lru_tail == -1) {
+            lru_tail = idx;
+        }
+    }
+
+    std::int64_t bitmap_cache::get_suitable_bitmap_index() {
+        // Removed slots are pushed to the back, so an empty slot is always picked first
+        return (lru_tail == -1) ? 0 : lru_tail;
+    }
+
+    void bitmap_cache::upload_bitmap(drivers::graphics_command_list_builder *builder, const std::int64_t idx,
+        epoc::bitwise_bitmap *bmp, const std::int32_t first_row, const std::int32_t row_count) {
+        char *data_pointer = reinterpret_cast<char*>(base_large_chunk + bmp->data_offset_);
+        const bool is_palette = is_palette_bitmap(bmp);
+
+        if ((bmp->header_.compression == bitmap_file_no_compression) && !is_palette) {
+            const std::uint32_t raw_size = bmp->header_.bitmap_size - bmp->header_.header_len;
+
+            // Upload the dirty rows only
+            const std::uint32_t row_offset = static_cast<std::uint32_t>(first_row * bmp->byte_width_);
+            const std::uint32_t rows_size = common::min(static_cast<std::uint32_t>(row_count * bmp->byte_width_),
+                raw_size - row_offset);
+
+            builder->update_bitmap(driver_textures[idx], bmp->header_.bit_per_pixels, data_pointer + row_offset, rows_size,
+                { 0, first_row }, { bmp->header_.size_pixels.x, row_count });
+
+            return;
+        }
+
+        // The rest are uploaded whole, and their data is produced straight into the command list.
+        std::vector<std::uint8_t> decompressed;
+
+        if (bmp->header_.compression != bitmap_file_no_compression) {
+            const std::uint32_t raw_size = bmp->byte_width_ * bmp->header_.size_pixels.y;
+            std::uint8_t *dest = nullptr;
+
+            if (is_palette) {
+                // Still need a conversion pass after this
+                decompressed.resize(raw_size);
+                dest = &decompressed[0];
+            } else {
+                dest = reinterpret_cast<std::uint8_t*>(builder->update_bitmap_buffer(driver_textures[idx],
+                    bmp->header_.bit_per_pixels, raw_size, { 0, 0 }, bmp->header_.size_pixels));
+            }
+
+            const std::uint32_t compressed_size = bmp->header_.bitmap_size - bmp->header_.header_len;
+
+            common::wo_buf_stream dest_stream(dest, raw_size);
+            common::ro_buf_stream source_stream(reinterpret_cast<std::uint8_t*>(data_pointer), compressed_size);
+
+            switch (bmp->header_.compression) {
+            case bitmap_file_byte_rle_compression:
+                eka2l1::decompress_rle<8>(&source_stream, &dest_stream);
+                break;
+
+            case bitmap_file_sixteen_bit_rle_compression:
+                eka2l1::decompress_rle<16>(&source_stream, &dest_stream);
+                break;
+
+            case bitmap_file_twenty_four_bit_rle_compression:
+                eka2l1::decompress_rle<24>(&source_stream, &dest_stream);
+                break;
+
+            default:
+                LOG_ERROR("Unsupported bitmap format to decode {}", bmp->header_.compression);
+                break;
+            }
+
+            if (!is_palette) {
+                return;
             }
+
+            data_pointer = reinterpret_cast<char*>(&decompressed[0]);
         }
 
-        return oldest_timestamp_idx;
+        // GPU don't support them. Convert them on CPU
+        const std::uint32_t converted_size = get_converted_palette_bitmap_size(bmp);
+        char *converted = reinterpret_cast<char*>(builder->update_bitmap_buffer(driver_textures[idx], 24,
+            converted_size, { 0, 0 }, bmp->header_.size_pixels));
+
+        // Unhandled display modes leave pixels untouched, don't upload garbage
+        std::memset(converted, 0, converted_size);
+
+        converted_palette_bitmap_to_twenty_four_bitmap(bmp, reinterpret_cast<const std::uint8_t*>(data_pointer),
+            converted);
     }
 
     drivers::handle bitmap_cache::add_or_get(drivers::graphics_driver *driver, drivers::graphics_command_list_builder *builder,
@@ -132,92 +276,63 @@ namespace eka2l1::epoc {
         }
 
         std::int64_t idx = 0;
-        std::uint64_t crr_timestamp = common::get_current_time_in_microseconds_since_1ad();
+        bool should_recreate = false;
 
-        std::uint64_t hash = 0;
+        auto slot_ite = bitmap_slots.find(bmp);
 
-        bool should_upload = true;
-
-        auto bitmap_ite = std::find(bitmaps.begin(), bitmaps.end(), bmp);
-        if (bitmap_ite == bitmaps.end()) {
+        if (slot_ite == bitmap_slots.end()) {
             // If the bitmap is not in the bitmap array
             if (last_free < MAX_CACHE_SIZE) {
                 // Use last free
                 idx = last_free++;
             } else {
                 idx = get_suitable_bitmap_index();
+                lru_unlink(idx);
+
+                if (bitmaps[idx]) {
+                    bitmap_slots.erase(bitmaps[idx]);
+                }
             }
 
             bitmaps[idx] = bmp;
-            driver_textures[idx] = 0;
-            hash = (hashes[idx] == 0) ? hash_bitwise_bitmap(bmp) : hashes[idx];
+            bitmap_slots.emplace(bmp, idx);
+
+            should_recreate = true;
         } else {
             // Else, get the index
-            idx = std::distance(bitmaps.begin(), bitmap_ite);
-
-            // Check if we should upload or not, by calcuting the hash
-            hash = hash_bitwise_bitmap(bmp);
-            should_upload = hash != (hashes[idx]);
+            idx = slot_ite->second;
+            lru_unlink(idx);
         }
 
-        if (should_upload) {
-            if (driver_textures[idx])
-                builder->destroy_bitmap(driver_textures[idx]);
-
-            driver_textures[idx] = drivers::create_bitmap(driver, bmp->header_.size_pixels);
-            char *data_pointer = reinterpret_cast<char*>(base_large_chunk + bmp->data_offset_);
-            
-            std::vector<std::uint8_t> decompressed;
-            std::uint32_t raw_size = 0;
-
-            if (bmp->header_.compression != bitmap_file_no_compression) {
-                raw_size = bmp->byte_width_ * bmp->header_.size_pixels.y;
-                decompressed.resize(raw_size);
+        lru_push_front(idx);
 
-                const std::uint32_t compressed_size = bmp->header_.bitmap_size - bmp->header_.header_len;
-
-                common::wo_buf_stream dest_stream(&decompressed[0], raw_size);
-                common::ro_buf_stream source_stream(reinterpret_cast<std::uint8_t*>(data_pointer), compressed_size);
-
-                switch (bmp->header_.compression) {
-                case bitmap_file_byte_rle_compression:
-                    eka2l1::decompress_rle<8>(&source_stream, &dest_stream);
-                    break;
+        // Size, format or data location changed, the whole texture has to be recreated
+        const std::uint64_t hash = hash_bitwise_bitmap(bmp);
 
-                case bitmap_file_sixteen_bit_rle_compression:
-                    eka2l1::decompress_rle<16>(&source_stream, &dest_stream);
-                    break;
-
-                case bitmap_file_twenty_four_bit_rle_compression:
-                    eka2l1::decompress_rle<24>(&source_stream, &dest_stream);
-                    break;
+        if (hash != hashes[idx]) {
+            should_recreate = true;
+            hashes[idx] = hash;
+        }
 
-                default:
-                    LOG_ERROR("Unsupported bitmap format to decode {}", bmp->header_.compression);
-                    break;
-                }
+        if (should_recreate) {
+            band_hashes[idx].clear();
+        }
 
-                data_pointer = reinterpret_cast<char*>(&decompressed[0]);
-            } else {
-                raw_size = bmp->header_.bitmap_size - bmp->header_.header_len;
-            }
+        std::int32_t first_dirty_row = 0;
+        std::int32_t dirty_row_count = 0;
 
-            std::vector<char> converted;
-            std::uint32_t bpp = bmp->header_.bit_per_pixels;
+        find_dirty_rows(idx, bmp, first_dirty_row, dirty_row_count);
 
-            // GPU don't support them. Convert them on CPU
-            if (is_palette_bitmap(bmp)) {
-                data_pointer = converted_palette_bitmap_to_twenty_four_bitmap(bmp, reinterpret_cast<const std::uint8_t*>(data_pointer),
-                    converted);
-                bpp = 24;
-                raw_size = static_cast<std::uint32_t>(converted.size());
-            }
+        if (should_recreate) {
+            if (driver_textures[idx])
+                builder->destroy_bitmap(driver_textures[idx]);
 
-            builder->update_bitmap(driver_textures[idx], bpp, data_pointer, raw_size, { 0, 0 }, bmp->header_.size_pixels);
-            hashes[idx] = hash;
+            driver_textures[idx] = drivers::create_bitmap(driver, bmp->header_.size_pixels);
+            upload_bitmap(builder, idx, bmp, 0, static_cast<std::int32_t>(bmp->header_.size_pixels.y));
+        } else if (dirty_row_count != 0) {
+            upload_bitmap(builder, idx, bmp, first_dirty_row, dirty_row_count);
         }
 
-        timestamps[idx] = crr_timestamp;
         return driver_textures[idx];
     }
 }
@@ -155,11 +155,8 @@ namespace eka2l1::epoc {
 
         // Unbind current bitmap
         cmd_builder->bind_bitmap(0);
+        // Submitting empties the list, so the graphic context can continue with the same builder
         driver->submit_command_list(*cmd_list);
-
-        // Renew this so that the graphic context can continue
-        cmd_list = driver->new_command_list();
-        cmd_builder = driver->new_command_builder(cmd_list.get());
     }
 
     void graphic_context::set_brush_color(service::ipc_context &context, ws_cmd &cmd) {
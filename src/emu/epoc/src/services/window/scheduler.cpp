@@ -36,7 +36,8 @@ namespace eka2l1::epoc {
     
     animation_scheduler::animation_scheduler(timing_system *timing, const int total_screen)
         : timing_(timing)
-        , callback_scheduled_(false) {
+        , callback_scheduled_(false)
+        , frames_(0) {
         anim_due_evt_ = timing_->register_event("anim_sched_anim_due_evt", on_anim_due);
         callback_evt_ = timing->register_event("anim_sched_callback_evt", on_scan_callback);
 
@@ -167,6 +168,7 @@ namespace eka2l1::epoc {
 
         // Do redraw, now!
         sched->scr->redraw(driver);
+        frames_.fetch_add(1, std::memory_order_relaxed);
         
         // Transtition the state to inactive.
         states_[screen_number].flags = screen_state::inactive;
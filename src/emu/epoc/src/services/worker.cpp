@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <epoc/services/worker.h>
+#include <epoc/timing.h>
+
+#include <common/cvt.h>
+#include <common/thread.h>
+
+namespace eka2l1::service {
+    enum {
+        SERVER_WORKER_MAX_PENDING_JOBS = 256
+    };
+
+    static void server_worker_loop(request_queue<std::function<void()>> *jobs, const std::size_t index) {
+        const std::string thread_name = "HLE server worker " + common::to_string(index);
+        common::set_thread_name(thread_name.c_str());
+
+        while (std::optional<std::function<void()>> func = jobs->pop()) {
+            (*func)();
+        }
+    }
+
+    server_worker_pool::server_worker_pool(const std::size_t worker_count)
+        : next_worker_(0) {
+        for (std::size_t i = 0; i < worker_count; i++) {
+            auto new_worker = std::make_unique<worker>();
+            new_worker->jobs.max_pending_count_ = SERVER_WORKER_MAX_PENDING_JOBS;
+            new_worker->thread = std::thread(server_worker_loop, &new_worker->jobs, i);
+
+            workers_.push_back(std::move(new_worker));
+        }
+    }
+
+    server_worker_pool::~server_worker_pool() {
+        for (auto &target : workers_) {
+            target->jobs.abort();
+        }
+
+        for (auto &target : workers_) {
+            target->thread.join();
+        }
+    }
+
+    std::size_t server_worker_pool::assign() {
+        return (next_worker_++) % workers_.size();
+    }
+
+    void server_worker_pool::post(const std::size_t worker_index, job func) {
+        workers_[worker_index]->jobs.push(func);
+    }
+
+    emulation_call_queue::emulation_call_queue()
+        : timing_(nullptr)
+        , call_evt_(-1) {
+    }
+
+    void emulation_call_queue::init(timing_system *timing, const std::string &event_name) {
+        timing_ = timing;
+        call_evt_ = timing_->register_event(event_name, [this](std::uint64_t userdata, int cycles_late) {
+            calls_.consume_all([](std::function<void()> &func) {
+                func();
+            });
+        });
+    }
+
+    void emulation_call_queue::post(std::function<void()> func) {
+        calls_.push(func);
+        timing_->schedule_event_thread_safe(0, call_evt_, 0);
+    }
+}
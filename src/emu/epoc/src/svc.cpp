@@ -526,11 +526,11 @@ namespace eka2l1::epoc {
 #ifdef ENABLE_SCRIPTING
         // Invoke hook
         sys->get_manager_system()->get_script_manager()->call_ipc_complete(msg->msg_session->get_server()->name(),
-            msg->function, msg.get());
+            msg->function, msg);
 #endif
 
         // Free the message
-        msg->free = true;
+        kern->free_msg(msg);
 
         return epoc::error_none;
     }
@@ -29,6 +29,129 @@
 #include <vector>
 
 namespace eka2l1 {
+    static bool is_event_earlier(const event &lhs, const event &rhs) {
+        if (lhs.event_time != rhs.event_time) {
+            return lhs.event_time < rhs.event_time;
+        }
+
+        return lhs.event_order < rhs.event_order;
+    }
+
+    void timing_system::place_event(const std::size_t pos, const event &evt) {
+        events[pos] = evt;
+        event_positions[evt.event_handle] = static_cast<std::uint32_t>(pos);
+    }
+
+    void timing_system::sift_event_up(std::size_t pos) {
+        const event evt = events[pos];
+
+        while (pos > 0) {
+            const std::size_t parent = (pos - 1) >> 1;
+
+            if (!is_event_earlier(evt, events[parent])) {
+                break;
+            }
+
+            place_event(pos, events[parent]);
+            pos = parent;
+        }
+
+        place_event(pos, evt);
+    }
+
+    void timing_system::sift_event_down(std::size_t pos) {
+        const event evt = events[pos];
+        const std::size_t total = events.size();
+
+        while (true) {
+            std::size_t child = (pos << 1) + 1;
+
+            if (child >= total) {
+                break;
+            }
+
+            if ((child + 1 < total) && is_event_earlier(events[child + 1], events[child])) {
+                child++;
+            }
+
+            if (!is_event_earlier(events[child], evt)) {
+                break;
+            }
+
+            place_event(pos, events[child]);
+            pos = child;
+        }
+
+        place_event(pos, evt);
+    }
+
+    void timing_system::push_event(event evt) {
+        if (free_event_handles.empty()) {
+            evt.event_handle = static_cast<std::uint32_t>(event_positions.size());
+            event_positions.push_back(0);
+        } else {
+            evt.event_handle = free_event_handles.back();
+            free_event_handles.pop_back();
+        }
+
+        evt.event_order = event_order_counter++;
+
+        event_lookup.emplace(event_key{ evt.event_type, evt.event_user_data }, evt.event_handle);
+        events.push_back(evt);
+
+        sift_event_up(events.size() - 1);
+    }
+
+    void timing_system::remove_event_lookup(const event &evt) {
+        auto range = event_lookup.equal_range(event_key{ evt.event_type, evt.event_user_data });
+
+        for (auto ite = range.first; ite != range.second; ite++) {
+            if (ite->second == evt.event_handle) {
+                event_lookup.erase(ite);
+                break;
+            }
+        }
+    }
+
+    void timing_system::remove_event_at(const std::size_t pos) {
+        remove_event_lookup(events[pos]);
+        free_event_handles.push_back(events[pos].event_handle);
+
+        const event last = events.back();
+        events.pop_back();
+
+        if (pos == events.size()) {
+            return;
+        }
+
+        place_event(pos, last);
+
+        if ((pos > 0) && is_event_earlier(last, events[(pos - 1) >> 1])) {
+            sift_event_up(pos);
+        } else {
+            sift_event_down(pos);
+        }
+    }
+
+    void timing_system::rebuild_event_heap() {
+        event_positions.resize(events.size());
+        free_event_handles.clear();
+        event_lookup.clear();
+
+        // Schedule orders are kept, heap positions say nothing about which event came first
+        for (std::size_t i = 0; i < events.size(); i++) {
+            events[i].event_handle = static_cast<std::uint32_t>(i);
+            event_positions[i] = static_cast<std::uint32_t>(i);
+
+            event_lookup.emplace(event_key{ events[i].event_type, events[i].event_user_data },
+                events[i].event_handle);
+        }
+
+        for (std::size_t i = events.size() / 2; i > 0; i--) {
+            sift_event_down(i - 1);
+        }
+    }
+
     void timing_system::fire_mhz_changes() {
         for (auto &mhz_change : internal_mhzcs) {
             mhz_change();
@@ -97,6 +220,7 @@ namespace eka2l1 {
         last_global_time_ticks = 0;
         last_global_time_us = 0;
         idle_ticks = 0;
+        event_order_counter = 0;
 
         CPU_HZ = 250000000;
     }
@@ -111,12 +235,15 @@ namespace eka2l1 {
     }
 
     void timing_system::swap_userdata_event(int event_type, std::uint64_t old_userdata, std::uint64_t new_userdata) {
-        auto e = std::find_if(events.begin(), events.end(), [=](const event &ei) {
-            return (ei.event_user_data == old_userdata) && (ei.event_type == event_type);
-        });
+        std::lock_guard<std::mutex> guard(mut);
+        auto e = event_lookup.find(event_key{ event_type, old_userdata });
+
+        if (e != event_lookup.end()) {
+            const std::uint32_t handle = e->second;
+            event_lookup.erase(e);
 
-        if (e != events.end()) {
-            e->event_user_data = new_userdata;
+            events[event_positions[handle]].event_user_data = new_userdata;
+            event_lookup.emplace(event_key{ event_type, new_userdata }, handle);
         }
     }
 
@@ -136,26 +263,31 @@ namespace eka2l1 {
         evt.event_type = event_type;
         evt.event_user_data = userdata;
 
-        events.push_back(evt);
-
-        std::stable_sort(events.begin(), events.end(),
-            [](const event &lhs, const event &rhs) {
-                return lhs.event_time > rhs.event_time;
-            });
+        push_event(evt);
     }
 
     void timing_system::schedule_event_imm(int event_type, uint64_t userdata) {
         schedule_event(0, event_type, userdata);
     }
 
+    void timing_system::schedule_event_thread_safe(int64_t cycles_into_future, int event_type, uint64_t userdata) {
+        event evt;
+
+        // Relative for now, the emulation thread makes it absolute when moving it
+        evt.event_time = static_cast<std::uint64_t>(cycles_into_future);
+        evt.event_type = event_type;
+        evt.event_user_data = userdata;
+
+        ts_events.push(evt);
+    }
+
     void timing_system::unschedule_event(int event_type, uint64_t usrdata) {
         std::lock_guard<std::mutex> guard(mut);
 
-        auto res = std::find_if(events.begin(), events.end(),
-            [&](auto evt) { return (evt.event_type == event_type) && (evt.event_user_data == usrdata); });
+        auto res = event_lookup.find(event_key{ event_type, usrdata });
 
-        if (res != events.end()) {
-            events.erase(res);
+        if (res != event_lookup.end()) {
+            remove_event_at(event_positions[res->second]);
         }
     }
 
@@ -163,10 +295,10 @@ namespace eka2l1 {
         std::lock_guard<std::mutex> guard(mut);
 
         auto res = std::find_if(events.begin(), events.end(),
-            [&](auto evt) { return (evt.event_type == event_type); });
+            [&](const event &evt) { return (evt.event_type == event_type); });
 
         if (res != events.end()) {
-            events.erase(res);
+            remove_event_at(std::distance(events.begin(), res));
         }
     }
 
@@ -197,7 +329,18 @@ namespace eka2l1 {
     }
 
     void timing_system::remove_all_events(int event_type) {
-        remove_event(event_type);
+        std::lock_guard<std::mutex> guard(mut);
+
+        // Removing in place would sift unvisited events into slots already walked past
+        auto first_removed = std::remove_if(events.begin(), events.end(),
+            [&](const event &evt) { return (evt.event_type == event_type); });
+
+        if (first_removed == events.end()) {
+            return;
+        }
+
+        events.erase(first_removed, events.end());
+        rebuild_event_heap();
     }
 
     void timing_system::advance() {
@@ -207,21 +350,27 @@ namespace eka2l1 {
         global_timer += cycles_executed;
         slice_len = INITIAL_SLICE_LENGTH;
 
-        while (!events.empty() && events.back().event_time <= global_timer) {
-            event evt = std::move(events.back());
-            events.pop_back();
+        while (true) {
+            event evt;
+
+            {
+                std::lock_guard<std::mutex> guard(mut);
+
+                if (events.empty() || events[0].event_time > global_timer) {
+                    break;
+                }
 
-            std::stable_sort(events.begin(), events.end(),
-                [](const event &lhs, const event &rhs) {
-                    return lhs.event_time > rhs.event_time;
-                });
+                evt = events[0];
+                remove_event_at(0);
+            }
 
+            // Callback may schedule new events, so it must run outside of the lock
             event_types[evt.event_type]
                 .callback(evt.event_user_data, static_cast<int>(global_timer - evt.event_time));
         }
 
         if (!events.empty()) {
-            slice_len = std::min(static_cast<std::int64_t>(events.back().event_time - global_timer),
+            slice_len = std::min(static_cast<std::int64_t>(events[0].event_time - global_timer),
                 static_cast<std::int64_t>(MAX_SLICE_LENGTH));
         }
 
@@ -229,18 +378,17 @@ namespace eka2l1 {
     }
 
     void timing_system::move_events() {
-        std::lock_guard<std::mutex> guard(mut);
-
-        for (uint32_t i = 0; i < ts_events.size(); i++) {
-            events.push_back(ts_events[i]);
+        if (ts_events.empty()) {
+            return;
+        }
 
-            std::stable_sort(events.begin(), events.end(),
-                [](const event &lhs, const event &rhs) {
-                    return lhs.event_time > rhs.event_time;
-                });
+        std::lock_guard<std::mutex> guard(mut);
+        const std::uint64_t now = get_ticks();
 
-            ts_events.erase(events.begin() + i);
-        }
+        ts_events.consume_all([&](event &evt) {
+            evt.event_time += now;
+            push_event(evt);
+        });
     }
 
     void timing_system::shutdown() {
@@ -251,6 +399,9 @@ namespace eka2l1 {
 
     void timing_system::clear_pending_events() {
         events.clear();
+        event_positions.clear();
+        free_event_handles.clear();
+        event_lookup.clear();
     }
 
     void timing_system::log_pending_events() {
@@ -272,40 +423,76 @@ namespace eka2l1 {
         slice_len = -1;
     }
 
-    static void anticrash_callback(std::uint64_t usdata, int cycles_late) {
-        LOG_ERROR("Snapshot broken: Unregister event called!");
-    }
+    static void absorb_timing_save_data(common::chunkyseri &seri, timing_save_data &data) {
+        seri.absorb(data.cpu_hz);
+        seri.absorb(data.ticks);
+        seri.absorb(data.idle_ticks);
 
-    static void event_do_state(common::chunkyseri &seri, event &evt) {
-        seri.absorb(evt.event_type);
-        seri.absorb(evt.event_time);
-        seri.absorb(evt.event_user_data);
+        seri.absorb(data.last_global_time_ticks);
+        seri.absorb(data.last_global_time_us);
     }
 
     void timing_system::do_state(common::chunkyseri &seri) {
+        if (seri.get_seri_mode() == common::SERI_MODE_READ) {
+            timing_save_data data;
+
+            if (read_state(seri, data)) {
+                apply_state(data);
+            }
+
+            return;
+        }
+
         std::lock_guard<std::mutex> guard(mut);
-        auto s = seri.section("CoreTiming", 1);
+        auto s = seri.section("CoreTiming", 3);
 
         if (!s) {
             return;
         }
 
-        seri.absorb(CPU_HZ);
-        seri.absorb(slice_len);
-        seri.absorb(global_timer);
-        seri.absorb(idle_ticks);
+        // Events are not saved. Their userdata is often a host pointer, that means nothing once loaded.
+        timing_save_data data { CPU_HZ, get_ticks(), idle_ticks, last_global_time_ticks, last_global_time_us };
+        absorb_timing_save_data(seri, data);
+    }
 
-        seri.absorb(last_global_time_ticks);
-        seri.absorb(last_global_time_us);
+    bool timing_system::read_state(common::chunkyseri &seri, timing_save_data &data) {
+        auto s = seri.section("CoreTiming", 3);
 
-        std::uint32_t total_event_type = static_cast<std::uint32_t>(event_types.size());
-        seri.absorb(total_event_type);
+        if (!s) {
+            return false;
+        }
 
-        event_types.resize(total_event_type, event_type{ anticrash_callback, "INVALID" });
+        absorb_timing_save_data(seri, data);
+        return true;
+    }
 
-        // Since many events using a native pointer, storing the old userdata
-        // Than the object will restore with new userdata, using swap_event_userdata.
-        seri.absorb_container(events, event_do_state);
+    void timing_system::apply_state(timing_save_data &data) {
+        {
+            std::lock_guard<std::mutex> guard(mut);
+
+            // The events still pending were armed by objects of this session. Move them along
+            // with the clock, so they fire as far in the future as they would have.
+            const std::uint64_t now = get_ticks();
+
+            for (event &evt : events) {
+                evt.event_time = evt.event_time - now + data.ticks;
+            }
+
+            CPU_HZ = data.cpu_hz;
+            global_timer = data.ticks;
+            idle_ticks = data.idle_ticks;
+            last_global_time_ticks = data.last_global_time_ticks;
+            last_global_time_us = data.last_global_time_us;
+
+            slice_len = INITIAL_SLICE_LENGTH;
+
+            if (!events.empty()) {
+                slice_len = std::min(static_cast<std::int64_t>(events[0].event_time - global_timer),
+                    static_cast<std::int64_t>(MAX_SLICE_LENGTH));
+            }
+
+            downcount = slice_len;
+        }
 
         fire_mhz_changes();
     }
@@ -21,6 +21,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <epoc/kernel.h>
 #include <epoc/kernel/process.h>
 #include <epoc/kernel/thread.h>
 #include <epoc/utils/reqsts.h>
@@ -38,10 +39,9 @@ namespace eka2l1::epoc {
             return;
         }
 
-        *sts.get(requester->owning_process()) = err_code;
+        // Completion can come from a host thread, let the kernel put it on the right one
+        requester->get_kernel_object_owner()->complete_request(requester, sts, err_code);
         sts = 0;
-
-        requester->signal_request();
     }
 
     void notify_info::do_state(common::chunkyseri &seri) {
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <common/chunkyseri.h>
+#include <common/fileutils.h>
+#include <common/log.h>
+#include <common/virtualmem.h>
+
+#include <epoc/utils/savestate.h>
+
+#include <miniz.h>
+
+#include <cstring>
+#include <fstream>
+
+namespace eka2l1 {
+    enum {
+        STATE_MAGIC = 0x53534B45,           ///< EKSS
+        STATE_VERSION = 1,
+        STATE_COMPRESS_LEVEL = 1            ///< Fastest level, the state is mostly guest memory.
+    };
+
+    struct state_file_header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t raw_size;
+        std::uint64_t compressed_size;
+    };
+
+    state_saver::state_saver() {
+        worker = std::thread([this]() { worker_loop(); });
+    }
+
+    state_saver::~state_saver() {
+        {
+            const std::lock_guard<std::mutex> guard(lock);
+            should_stop = true;
+        }
+
+        work_cond.notify_one();
+        worker.join();
+    }
+
+    static bool write_state_file(const std::string &path, const std::vector<std::uint8_t> &raw) {
+        mz_ulong compressed_size = mz_compressBound(static_cast<mz_ulong>(raw.size()));
+        std::vector<std::uint8_t> compressed(compressed_size);
+
+        if (mz_compress2(&compressed[0], &compressed_size, &raw[0], static_cast<mz_ulong>(raw.size()),
+                STATE_COMPRESS_LEVEL) != MZ_OK) {
+            LOG_ERROR("Failed to compress state for {}", path);
+            return false;
+        }
+
+        state_file_header header;
+        header.magic = STATE_MAGIC;
+        header.version = STATE_VERSION;
+        header.raw_size = raw.size();
+        header.compressed_size = compressed_size;
+
+        const std::uint32_t end_magic = STATE_MAGIC;
+        std::ofstream state_file(path, std::ios::binary);
+
+        if (!state_file) {
+            LOG_ERROR("Can't open {} to write state", path);
+            return false;
+        }
+
+        state_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        state_file.write(reinterpret_cast<const char *>(&compressed[0]), compressed_size);
+        state_file.write(reinterpret_cast<const char *>(&end_magic), sizeof(end_magic));
+
+        return static_cast<bool>(state_file);
+    }
+
+    void state_saver::worker_loop() {
+        while (true) {
+            pending_state state;
+
+            {
+                std::unique_lock<std::mutex> ulock(lock);
+                work_cond.wait(ulock, [this]() { return should_stop || !pendings.empty(); });
+
+                if (pendings.empty()) {
+                    // Stopping, and nothing is left
+                    return;
+                }
+
+                state = std::move(pendings.front());
+                pendings.erase(pendings.begin());
+            }
+
+            write_state_file(state.path, state.raw);
+
+            {
+                const std::lock_guard<std::mutex> guard(lock);
+
+                free_buffers.push_back(std::move(state.raw));
+                in_flight--;
+            }
+
+            done_cond.notify_all();
+        }
+    }
+
+    bool state_saver::save(const std::string &path, state_do_func func) {
+        std::uint32_t end_magic = STATE_MAGIC;
+        std::size_t raw_size = 0;
+
+        {
+            common::chunkyseri seri(nullptr, 0, common::SERI_MODE_MEASURE);
+
+            if (!func(seri)) {
+                LOG_ERROR("Can't measure state for {}", path);
+                return false;
+            }
+
+            seri.absorb(end_magic);
+
+            raw_size = seri.size();
+        }
+
+        std::vector<std::uint8_t> raw;
+
+        {
+            const std::lock_guard<std::mutex> guard(lock);
+
+            if (!free_buffers.empty()) {
+                raw = std::move(free_buffers.back());
+                free_buffers.pop_back();
+            }
+        }
+
+        // Reuse the capacity of a staging buffer that was already written out
+        raw.resize(raw_size);
+
+        common::chunkyseri seri(&raw[0], raw.size(), common::SERI_MODE_WRITE);
+        if (!func(seri)) {
+            LOG_ERROR("Can't write state for {}", path);
+            return false;
+        }
+
+        seri.absorb(end_magic);
+
+        if (seri.size() != raw_size) {
+            LOG_ERROR("State changed size while being saved ({} vs {} bytes)", seri.size(), raw_size);
+            return false;
+        }
+
+        {
+            const std::lock_guard<std::mutex> guard(lock);
+
+            pendings.push_back({ path, std::move(raw) });
+            in_flight++;
+        }
+
+        work_cond.notify_one();
+        return true;
+    }
+
+    void state_saver::wait() {
+        std::unique_lock<std::mutex> ulock(lock);
+        done_cond.wait(ulock, [this]() { return in_flight == 0; });
+    }
+
+    bool load_state(const std::string &path, state_do_func read, state_apply_func apply) {
+        const std::int64_t file_size = common::file_size(path);
+
+        if (file_size < static_cast<std::int64_t>(sizeof(state_file_header) + sizeof(std::uint32_t))) {
+            return false;
+        }
+
+        std::uint8_t *file_data = reinterpret_cast<std::uint8_t *>(common::map_file(path, prot::read, 0));
+
+        if (!file_data) {
+            return false;
+        }
+
+        state_file_header header;
+        std::memcpy(&header, file_data, sizeof(header));
+
+        std::uint32_t end_magic = 0;
+        std::memcpy(&end_magic, file_data + file_size - sizeof(end_magic), sizeof(end_magic));
+
+        std::vector<std::uint8_t> raw;
+        bool result = (header.magic == STATE_MAGIC) && (header.version == STATE_VERSION) && (end_magic == STATE_MAGIC)
+            && (header.compressed_size == file_size - sizeof(state_file_header) - sizeof(end_magic));
+
+        if (result) {
+            raw.resize(header.raw_size);
+            mz_ulong raw_size = static_cast<mz_ulong>(header.raw_size);
+
+            result = (mz_uncompress(&raw[0], &raw_size, file_data + sizeof(state_file_header),
+                          static_cast<mz_ulong>(header.compressed_size))
+                         == MZ_OK)
+                && (raw_size == header.raw_size);
+        }
+
+        common::unmap_file(file_data, static_cast<std::size_t>(file_size));
+
+        if (!result) {
+            LOG_ERROR("State file {} is corrupted or from an incompatible version", path);
+            return false;
+        }
+
+        common::chunkyseri seri(&raw[0], raw.size(), common::SERI_MODE_READ);
+        const bool read_ok = read(seri);
+
+        std::uint32_t raw_end_magic = 0;
+        seri.absorb(raw_end_magic);
+
+        // Nothing is applied unless every byte was understood
+        if (!read_ok || (raw_end_magic != STATE_MAGIC) || (seri.size() != raw.size())) {
+            LOG_ERROR("State in {} does not match what the emulator expects", path);
+            return false;
+        }
+
+        apply();
+        return true;
+    }
+}
@@ -31,12 +31,13 @@
 #include <epoc/ptr.h>
 #include <epoc/vfs.h>
 
+#include <algorithm>
 #include <array>
 #include <cwctype>
 #include <iostream>
 #include <map>
 #include <mutex>
-#include <regex>
+#include <string_view>
 #include <thread>
 
 #include <string.h>
@@ -72,7 +73,7 @@ namespace eka2l1 {
 
     // Class for some one want to access rom
     struct rom_file : public file {
-        loader::rom_entry file;
+        const loader::rom_entry *file;
         loader::rom *parent;
 
         uint64_t crr_pos;
@@ -82,7 +83,7 @@ namespace eka2l1 {
 
         std::uint8_t *file_ptr;
 
-        rom_file(memory_system *mem, loader::rom *supereme_mother, loader::rom_entry entry)
+        rom_file(memory_system *mem, loader::rom *supereme_mother, const loader::rom_entry *entry)
             : parent(supereme_mother)
             , file(entry)
             , mem(mem) {
@@ -90,20 +91,20 @@ namespace eka2l1 {
         }
 
         void init() {
-            file_ptr = ptr<std::uint8_t>(file.address_lin).get(mem);
+            file_ptr = ptr<std::uint8_t>(file->address_lin).get(mem);
             crr_pos = 0;
         }
 
         uint64_t size() const override {
-            return file.size;
+            return file->size;
         }
         
         bool valid() override {
-            return crr_pos < file.size;
+            return crr_pos < file->size;
         }
 
         size_t read_file(void *data, uint32_t size, uint32_t count) override {
-            auto will_read = std::min((uint64_t)count * size, file.size - crr_pos);
+            auto will_read = std::min((uint64_t)count * size, file->size - crr_pos);
             memcpy(data, &file_ptr[crr_pos], will_read);
 
             crr_pos += will_read;
@@ -145,7 +146,7 @@ namespace eka2l1 {
             }
 
             if (where == file_seek_mode::address) {
-                return file.address_lin + crr_pos;
+                return file->address_lin + crr_pos;
             }
 
             return crr_pos;
@@ -164,7 +165,7 @@ namespace eka2l1 {
         }
 
         address rom_address() const override {
-            return file.address_lin;
+            return file->address_lin;
         }
 
         uint64_t tell() override {
@@ -172,7 +173,7 @@ namespace eka2l1 {
         }
 
         std::u16string file_name() const override {
-            return file.name;
+            return file->name;
         }
 
         bool close() override {
@@ -405,8 +406,10 @@ namespace eka2l1 {
     };
 
     /* DIRECTORY VFS */
+    class physical_file_system;
+
     class physical_directory : public directory {
-        std::regex filter;
+        common::wildcard_matcher filter;
         std::string vir_path;
 
         common::dir_iterator iterator;
@@ -417,12 +420,12 @@ namespace eka2l1 {
 
         io_attrib attrib;
 
-        abstract_file_system *inst;
+        physical_file_system *inst;
 
     public:
-        physical_directory(abstract_file_system *inst, const std::string &phys_path,
+        physical_directory(physical_file_system *inst, const std::string &phys_path,
             const std::string &vir_path, const std::string &filter, const io_attrib attrib)
-            : filter(common::wildcard_to_regex_string(common::lowercase_string(filter)))
+            : filter(filter, false)
             , iterator(phys_path)
             , vir_path(vir_path)
             , attrib(attrib)
@@ -431,58 +434,7 @@ namespace eka2l1 {
             iterator.detail = true;
         }
 
-        std::optional<entry_info> get_next_entry() override {
-            if (peeking) {
-                peeking = false;
-                return peek_info;
-            }
-
-            while (true) {
-                if (!iterator.is_valid()) {
-                    return std::optional<entry_info>{};
-                }
-
-                std::string name = "";
-                int error_code = iterator.next_entry(entry);
-
-                if (error_code != 0) {
-                    return std::optional<entry_info>{};
-                }
-
-                name = entry.name;
-
-                if (!static_cast<int>(attrib & io_attrib::include_dir) && entry.type == common::FILE_DIRECTORY) {
-                    continue;
-                }
-
-                // Quick hack: Regex dumb with null-terminated string
-                if (name.back() == '\0') {
-                    name.erase(name.length() - 1);
-                }
-
-                // If it doesn't meet the filter, continue until find one or there is no one
-                if (!std::regex_match(name, filter)) {
-                    continue;
-                }
-
-                entry_info info = *(inst->get_entry_info(common::utf8_to_ucs2(
-                    eka2l1::add_path(vir_path, name))));
-
-                // Symbian usually sensitive about null terminator.
-                // It's best not include them.
-                if (info.name.back() == '\0') {
-                    info.name.erase(info.name.length() - 1);
-                }
-
-                if (info.full_path.back() == '\0') {
-                    info.full_path.erase(info.full_path.length() - 1);
-                }
-
-                return info;
-            }
-
-            return std::optional<entry_info>{};
-        }
+        std::optional<entry_info> get_next_entry() override;
 
         std::optional<entry_info> peek_next_entry() override {
             if (!peeking) {
@@ -495,6 +447,8 @@ namespace eka2l1 {
     };
 
     class physical_file_system : public abstract_file_system {
+        friend class physical_directory;
+
         std::mutex fs_mutex;
 
     protected:
@@ -512,6 +466,37 @@ namespace eka2l1 {
             return static_cast<drive_number>(c - 0x61);
         }
 
+        /**
+         * \brief Make an entry info from the details a directory iterator already has.
+         * 
+         * Unlike get_entry_info, this does not touch the host file again.
+         * 
+         * \param vir_path The virtual path of the entry.
+         * \param dentry   The entry, iterated with details.
+         */
+        virtual entry_info get_entry_info_from_dir_entry(const std::string &vir_path, const common::dir_entry &dentry) {
+            entry_info info;
+
+            if (dentry.type == common::FILE_DIRECTORY) {
+                info.type = io_component_type::dir;
+                info.size = 0;
+            } else {
+                info.type = io_component_type::file;
+                info.size = dentry.size;
+            }
+
+            info.last_write = dentry.last_write;
+            info.full_path = vir_path;
+            info.name = eka2l1::filename(vir_path);
+
+            const std::string root = eka2l1::root_name(vir_path);
+            drive &drv = mappings[ascii_to_drive_number(static_cast<char>(std::towlower(root[0])))].first;
+
+            info.attribute = drv.attribute;
+
+            return info;
+        }
+
         bool do_mount(const drive_number drv, const drive_media media, const io_attrib attrib,
             const std::u16string &physical_path) {
             const std::lock_guard<std::mutex> guard(fs_mutex);
@@ -745,10 +730,7 @@ namespace eka2l1 {
                 info.size = common::file_size(real_path_utf8);
             }
 
-            /* TODO: Recover this code with new EKA2L1's common code.
-            auto last_mod = fs::last_write_time(*real_path);
-            info.last_write = static_cast<uint64_t>(last_mod.time_since_epoch().count());
-            */
+            info.last_write = common::get_last_modifiy_since_ad(*real_path);
 
             std::string path_utf8 = common::ucs2_to_utf8(path);
 
@@ -780,53 +762,184 @@ namespace eka2l1 {
         }
     };
 
+    std::optional<entry_info> physical_directory::get_next_entry() {
+        if (peeking) {
+            peeking = false;
+            return peek_info;
+        }
+
+        while (true) {
+            if (!iterator.is_valid()) {
+                return std::optional<entry_info>{};
+            }
+
+            int error_code = iterator.next_entry(entry);
+
+            if (error_code != 0) {
+                return std::optional<entry_info>{};
+            }
+
+            if (!static_cast<int>(attrib & io_attrib::include_dir) && entry.type == common::FILE_DIRECTORY) {
+                continue;
+            }
+
+            if (!entry.name.empty() && entry.name.back() == '\0') {
+                entry.name.pop_back();
+            }
+
+            // If it doesn't meet the filter, continue until find one or there is no one
+            if (!filter.match(entry.name)) {
+                continue;
+            }
+
+            entry_info info = inst->get_entry_info_from_dir_entry(eka2l1::add_path(vir_path, entry.name), entry);
+
+            // Symbian usually sensitive about null terminator.
+            // It's best not include them.
+            if (!info.name.empty() && info.name.back() == '\0') {
+                info.name.pop_back();
+            }
+
+            if (!info.full_path.empty() && info.full_path.back() == '\0') {
+                info.full_path.pop_back();
+            }
+
+            return info;
+        }
+
+        return std::optional<entry_info>{};
+    }
+
     class rom_file_system : public physical_file_system {
         loader::rom *rom_cache;
         memory_system *mem;
 
-        std::optional<loader::rom_entry> burn_tree_find_entry(const std::string &vir_path) {
-            auto ite = path_iterator(vir_path);
+        /**
+         * \brief Flattened ROM path, case-folded and without the drive letter.
+         */
+        struct rom_path_index_entry {
+            std::u16string folded_path;
+            const loader::rom_entry *entry;
+        };
 
-            loader::rom_dir *last_dir_found = &(rom_cache->root.root_dirs[0].dir);
+        // Sorted by folded path, built once when the file system is created
+        std::vector<rom_path_index_entry> path_index;
 
+        static char16_t fold_path_char(const char16_t c) {
+            if (c == u'/') {
+                return u'\\';
+            }
+
+            return static_cast<char16_t>(std::towlower(c));
+        }
+
+        void index_rom_dir(const loader::rom_dir &dir, std::u16string &prefix) {
+            const std::size_t prefix_len = prefix.length();
+
+            for (const loader::rom_entry &entry : dir.entries) {
+                prefix += u'\\';
+
+                for (const char16_t c : entry.name) {
+                    prefix += fold_path_char(c);
+                }
+
+                if (entry.dir) {
+                    index_rom_dir(entry.dir.value(), prefix);
+                } else {
+                    path_index.push_back({ prefix, &entry });
+                }
+
+                prefix.resize(prefix_len);
+            }
+        }
+
+        void build_path_index() {
+            path_index.clear();
+
+            if (!rom_cache || rom_cache->root.root_dirs.empty()) {
+                return;
+            }
+
+            std::u16string prefix;
+            index_rom_dir(rom_cache->root.root_dirs[0].dir, prefix);
+
+            std::sort(path_index.begin(), path_index.end(), [](const rom_path_index_entry &lhs, const rom_path_index_entry &rhs) {
+                return lhs.folded_path < rhs.folded_path;
+            });
+        }
+
+        /**
+         * \brief Find a file entry in the ROM, given its virtual path.
+         * 
+         * The path is case-folded while being compared against the index, so the lookup
+         * does not allocate.
+         */
+        const loader::rom_entry *burn_tree_find_entry(const std::u16string &vir_path) {
             // Skip through the drive
-            ite++;
+            std::u16string_view path = vir_path;
 
-            std::vector<std::string> components;
+            if ((path.length() >= 2) && (path[1] == u':')) {
+                path.remove_prefix(2);
+            }
 
-            for (; ite; ite++) {
-                components.push_back(*ite);
+            if (path.empty() || (fold_path_char(path[0]) != u'\\')) {
+                return nullptr;
             }
 
-            if (components.size() == 0) {
-                return std::nullopt;
+            // Strip the trailing separator, same as the path iterator did
+            if (fold_path_char(path.back()) == u'\\') {
+                path.remove_suffix(1);
             }
 
-            for (std::size_t i = 0; i < components.size() - 1; i++) {
-                loader::rom_dir temp;
-                temp.name = common::utf8_to_ucs2(components[i]);
+            const auto compare_folded = [](const std::u16string &folded, std::u16string_view raw) -> int {
+                const std::size_t len = common::min(folded.length(), raw.length());
 
-                auto res1 = std::lower_bound(last_dir_found->subdirs.begin(), last_dir_found->subdirs.end(), temp,
-                    [](const loader::rom_dir &lhs, const loader::rom_dir &rhs) { return common::compare_ignore_case(lhs.name, rhs.name) == -1; });
+                for (std::size_t i = 0; i < len; i++) {
+                    const char16_t c = fold_path_char(raw[i]);
 
-                if (res1 != last_dir_found->subdirs.end() && (common::compare_ignore_case(res1->name, temp.name) == 0)) {
-                    last_dir_found = &(last_dir_found->subdirs[std::distance(last_dir_found->subdirs.begin(), res1)]);
-                } else {
-                    return std::optional<loader::rom_entry>{};
+                    if (folded[i] != c) {
+                        return (folded[i] < c) ? -1 : 1;
+                    }
+                }
+
+                if (folded.length() == raw.length()) {
+                    return 0;
                 }
+
+                return (folded.length() < raw.length()) ? -1 : 1;
+            };
+
+            auto res = std::lower_bound(path_index.begin(), path_index.end(), path,
+                [&](const rom_path_index_entry &lhs, std::u16string_view rhs) { return compare_folded(lhs.folded_path, rhs) < 0; });
+
+            if (res != path_index.end() && (compare_folded(res->folded_path, path) == 0)) {
+                return res->entry;
             }
 
-            loader::rom_entry temp_entry;
-            temp_entry.name = common::utf8_to_ucs2(components[components.size() - 1]);
+            return nullptr;
+        }
+
+        entry_info get_rom_entry_info(const loader::rom_entry *entry, const std::string &vir_path) {
+            entry_info info;
+            info.type = entry->attrib & 0x10 ? io_component_type::dir : io_component_type::drive;
+            info.has_raw_attribute = true;
+            info.raw_attribute = entry->attrib;
+            info.size = entry->size;
+            info.last_write = static_cast<std::uint64_t>(rom_cache->header.time);
+            info.name = common::ucs2_to_utf8(entry->name);
+            info.full_path = vir_path;
+
+            return info;
+        }
 
-            auto res2 = std::lower_bound(last_dir_found->entries.begin(), last_dir_found->entries.end(), temp_entry,
-                [](const loader::rom_entry &lhs, const loader::rom_entry &rhs) { return common::compare_ignore_case(lhs.name, rhs.name) == -1; });
+        entry_info get_entry_info_from_dir_entry(const std::string &vir_path, const common::dir_entry &dentry) override {
+            const loader::rom_entry *entry = burn_tree_find_entry(common::utf8_to_ucs2(vir_path));
 
-            if (res2 != last_dir_found->entries.end() && !res2->dir && (common::compare_ignore_case(temp_entry.name, res2->name) == 0)) {
-                return *res2;
+            if (!entry) {
+                return physical_file_system::get_entry_info_from_dir_entry(vir_path, dentry);
             }
 
-            return std::nullopt;
+            return get_rom_entry_info(entry, vir_path);
         }
 
     public:
@@ -834,6 +947,7 @@ namespace eka2l1 {
             : physical_file_system(ver, product_code)
             , rom_cache(cache)
             , mem(mem) {
+            build_path_index();
         }
 
         bool delete_entry(const std::u16string &path) override {
@@ -867,7 +981,7 @@ namespace eka2l1 {
                 return abstract_file_system_err_code::no;
             }
 
-            if (burn_tree_find_entry(common::ucs2_to_utf8(path))) {
+            if (burn_tree_find_entry(path)) {
                 return abstract_file_system_err_code::ok;
             }
 
@@ -895,13 +1009,13 @@ namespace eka2l1 {
                 }
             }
 
-            auto entry = burn_tree_find_entry(common::ucs2_to_utf8(new_path));
+            const loader::rom_entry *entry = burn_tree_find_entry(new_path);
 
             if (!entry) {
                 return physical_file_system::open_file(new_path, mode);
             }
 
-            return std::make_unique<rom_file>(mem, rom_cache, *entry);
+            return std::make_unique<rom_file>(mem, rom_cache, entry);
         }
 
         std::optional<entry_info> get_entry_info(const std::u16string &path) override {
@@ -910,21 +1024,13 @@ namespace eka2l1 {
                 return std::nullopt;
             }
 
-            auto entry = burn_tree_find_entry(common::ucs2_to_utf8(path));
+            const loader::rom_entry *entry = burn_tree_find_entry(path);
 
             if (!entry) {
                 return physical_file_system::get_entry_info(path);
             }
 
-            entry_info info;
-            info.type = entry->attrib & 0x10 ? io_component_type::dir : io_component_type::drive;
-            info.has_raw_attribute = true;
-            info.raw_attribute = entry->attrib;
-            info.size = entry->size;
-            info.name = common::ucs2_to_utf8(entry->name);
-            info.full_path = common::ucs2_to_utf8(path);
-
-            return info;
+            return get_rom_entry_info(entry, common::ucs2_to_utf8(path));
         }
     };
 
@@ -945,6 +1051,27 @@ namespace eka2l1 {
     void io_system::init() {
     }
 
+    void io_system::touch_entry(const std::u16string &path) {
+        static const std::u16string lib_dir = u"\\sys\\bin";
+
+        std::u16string lowered = common::lowercase_ucs2_string(path);
+        std::replace(lowered.begin(), lowered.end(), u'/', u'\\');
+
+        if (lowered.find(lib_dir) != std::u16string::npos) {
+            lib_dir_generation++;
+        }
+
+        if ((lowered.length() >= 2) && (lowered[1] == u':') && (lowered[0] >= u'a') && (lowered[0] <= u'z')) {
+            drive_generations[lowered[0] - u'a']++;
+        }
+    }
+
+    void io_system::touch_all_drives() {
+        for (auto &generation : drive_generations) {
+            generation++;
+        }
+    }
+
     void io_system::shutdown() {
         filesystems.clear();
     }
@@ -953,6 +1080,8 @@ namespace eka2l1 {
         const std::lock_guard<std::mutex> guard(access_lock);
 
         ++id_counter;
+        lib_dir_generation++;
+        touch_all_drives();
 
         filesystems.emplace(id_counter, inst);
         return id_counter;
@@ -968,12 +1097,17 @@ namespace eka2l1 {
         }
 
         filesystems.erase(id);
+        lib_dir_generation++;
+        touch_all_drives();
+
         return true;
     }
 
     bool io_system::mount_physical_path(const drive_number drv, const drive_media media, const io_attrib attrib,
         const std::u16string &real_path) {
         const std::lock_guard<std::mutex> guard(access_lock);
+        lib_dir_generation++;
+        drive_generations[drv]++;
 
         for (auto &[id, file_system] : filesystems) {
             if (file_system->mount_volume_from_path(drv, media, attrib, real_path)) {
@@ -986,6 +1120,8 @@ namespace eka2l1 {
 
     bool io_system::unmount(const drive_number drv) {
         const std::lock_guard<std::mutex> guard(access_lock);
+        lib_dir_generation++;
+        drive_generations[drv]++;
 
         for (auto &[id, file_system] : filesystems) {
             if (file_system->unmount(drv)) {
@@ -1011,6 +1147,10 @@ namespace eka2l1 {
     std::unique_ptr<file> io_system::open_file(utf16_str vir_path, int mode) {
         const std::lock_guard<std::mutex> guard(access_lock);
 
+        if (mode & WRITE_MODE) {
+            touch_entry(vir_path);
+        }
+
         for (auto &[id, fs] : filesystems) {
             if (auto f = fs->open_file(vir_path, mode)) {
                 return f;
@@ -1047,6 +1187,9 @@ namespace eka2l1 {
     bool io_system::rename(const std::u16string &old_path, const std::u16string &new_path) {
         const std::lock_guard<std::mutex> guard(access_lock);
 
+        touch_entry(old_path);
+        touch_entry(new_path);
+
         for (auto &[id, fs] : filesystems) {
             if (fs->replace(old_path, new_path)) {
                 return true;
@@ -1058,6 +1201,7 @@ namespace eka2l1 {
 
     bool io_system::delete_entry(const std::u16string &path) {
         const std::lock_guard<std::mutex> guard(access_lock);
+        touch_entry(path);
 
         for (auto &[id, fs] : filesystems) {
             if (fs->delete_entry(path)) {
@@ -1082,6 +1226,7 @@ namespace eka2l1 {
 
     bool io_system::create_directories(const std::u16string &path) {
         const std::lock_guard<std::mutex> guard(access_lock);
+        touch_entry(path);
 
         for (auto &[id, fs] : filesystems) {
             if (fs->create_directories(path)) {
@@ -1094,6 +1239,7 @@ namespace eka2l1 {
 
     bool io_system::create_directory(const std::u16string &path) {
         const std::lock_guard<std::mutex> guard(access_lock);
+        touch_entry(path);
 
         for (auto &[id, fs] : filesystems) {
             if (fs->create_directory(path)) {
@@ -32,6 +32,7 @@
 // Normally we can just calls method blindly with forward declaring, considering how template is done
 // But it keeps warnings about what we are doing, so include this. Full definition of system.
 #include <epoc/epoc.h>
+#include <epoc/kernel/libmanager.h>
 
 #include <cstdint>
 #include <functional>
@@ -39,8 +40,6 @@
 
 namespace eka2l1 {
     namespace hle {
-        using import_func = std::function<void(system *)>;
-
         /*! \brief Call a HLE function without return value. */
         template <typename ret, typename... args, size_t... indices>
         std::enable_if_t<!std::is_same_v<ret, void>, void> call(ret (*export_fn)(system *, args...), const args_layout<args...> &layout, std::index_sequence<indices...>, arm::jitter &cpu, system *symsys) {
@@ -55,15 +54,22 @@ namespace eka2l1 {
             (*export_fn)(symsys, read<args, indices, args...>(cpu, layout, symsys->get_memory_system())...);
         }
 
-        /*! \brief Bridge a HLE function to guest (ARM - Symbian). */
+        /*! \brief Read arguments from guest, call a HLE function and write back its result. */
         template <typename ret, typename... args>
-        import_func bridge(ret (*export_fn)(system *, args...)) {
+        void invoke(ret (*export_fn)(system *, args...), system *symsys) {
             constexpr args_layout<args...> layouts = lay_out<typename bridge_type<args>::arm_type...>();
+            using indices = std::index_sequence_for<args...>;
+
+            call(export_fn, layouts, indices(), symsys->get_cpu(), symsys);
+        }
 
-            return [export_fn, layouts](system *symsys) {
-                using indices = std::index_sequence_for<args...>;
-                call(export_fn, layouts, indices(), symsys->get_cpu(), symsys);
-            };
+        /*! \brief Bridge a HLE function to guest (ARM - Symbian).
+         *
+         * Each HLE function gets its own instantiation, so the bridge is a plain function pointer.
+         */
+        template <auto export_fn>
+        void bridge(system *symsys) {
+            invoke(export_fn, symsys);
         }
 
         /*! \brief Write function arguments to guest. */
@@ -143,7 +149,7 @@ namespace eka2l1 {
 
 #define BRIDGE_REGISTER(func_sid, func)                                               \
     {                                                                                 \
-        func_sid, eka2l1::hle::epoc_import_func { eka2l1::hle::bridge(&func), #func } \
+        func_sid, eka2l1::hle::epoc_import_func { &eka2l1::hle::bridge<&func>, #func } \
     }
 
 #define BRIDGE_FUNC(ret, name, ...) ret name(eka2l1::system *sys, ##__VA_ARGS__)
@@ -46,6 +46,7 @@ namespace eka2l1::manager {
         bool log_passed { false };
         bool log_exports { false };
         bool log_code { false };
+        bool profile_svc { false };
 
         bool enable_breakpoint_script { false };
 
@@ -78,6 +79,13 @@ namespace eka2l1::manager {
 
         bool fbs_enable_compression_queue { true };
 
+        int ui_fps_limit { 60 };            ///< Cap of the UI frame rate, zero for no cap. Guest execution is not affected.
+
+        std::string audio_backend { "cubeb" };
+        std::string audio_dump_path;        ///< WAV file the null audio backend dumps its output to.
+
+        int hle_server_workers { 0 };       ///< Host threads for I/O heavy HLE servers. Zero runs them on the emulation thread.
+
         void serialize();
         void deserialize();
 
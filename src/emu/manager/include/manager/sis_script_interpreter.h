@@ -21,10 +21,14 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include <manager/sis_common.h>
 #include <manager/sis_fields.h>
 
 namespace eka2l1 {
@@ -40,6 +44,36 @@ namespace eka2l1 {
     }
 
     namespace loader {
+        /**
+         * \brief A file of an install block waiting to be extracted.
+         */
+        struct sis_extract_job {
+            std::string path;                   ///< Host path the file is extracted to.
+            std::string install_path;           ///< Virtual path, as recorded in the package's file bucket.
+            std::uint32_t idx;
+            std::uint16_t blck_idx;
+
+            bool extracted { false };           ///< Set once the file data is fully written.
+        };
+
+        /**
+         * \brief Drop jobs that a later job with the same target path would overwrite.
+         * 
+         * Paths are compared case-insensitively. The jobs left keep their order.
+         */
+        void merge_sis_extract_jobs(std::vector<sis_extract_job> &jobs);
+
+        /**
+         * \brief Run extract jobs on a pool of workers, the calling thread taking part.
+         * 
+         * \param jobs    The jobs. No two of them may target the same path.
+         * \param extract Extracts one job. Called from several threads at once.
+         * 
+         * \returns Number of jobs that failed. Their extracted flag is left cleared.
+         */
+        std::size_t run_sis_extract_jobs(std::vector<sis_extract_job> &jobs,
+            const std::function<bool(const sis_extract_job &)> &extract);
+
         // An interpreter that runs SIS install script
         class ss_interpreter {
             sis_controller *main_controller;
@@ -57,6 +91,33 @@ namespace eka2l1 {
 
             bool skip_next_file { false };
 
+            std::vector<sis_extract_job> pending_extracts;
+            std::mutex data_stream_lock;                    ///< Workers share the package stream.
+
+            std::atomic<int> *progress_handle { nullptr };
+            std::atomic<std::uint64_t> processed_bytes { 0 };
+            std::uint64_t total_bytes { 0 };                ///< Compressed size of all file data in the package.
+
+            /**
+             * \brief Extract a file data to a physical file, streaming it chunk by chunk.
+             * 
+             * Safe to call from multiple threads at once, as long as the target directory exists.
+             * 
+             * \returns False if the file can't be written or the data is corrupted.
+             */
+            bool extract_file_data(const std::string &path, const uint32_t idx, uint16_t crr_blck_idx);
+
+            /**
+             * \brief Extract all pending files on a pool of workers, then finish installing them.
+             * 
+             * Each worker decompresses one file at a time through fixed-size buffers, so peak memory
+             * only depends on the number of workers, not on the package size. A file that fails to
+             * extract is removed, and not added to the package's file bucket.
+             * 
+             * \returns False if any file failed to extract.
+             */
+            bool flush_extracts(std::atomic<int> &progress);
+
             bool appprop(const sis_uid uid, sis_property prop);
             bool package(const sis_uid uid);
 
@@ -90,17 +151,6 @@ namespace eka2l1 {
              */
             std::vector<uint8_t> get_small_file_buf(uint32_t data_idx, uint16_t crr_blck_idx);
 
-            /**
-             * \brief Get the data in the index of a buffer block in the SIS, write it to a physical file.
-             * 
-             * Usually uses for extracting large app data.
-             * 
-             * \param path          UTF-8 path to the physical file.
-             * \param data_idx      The index of the source buffer in block buffer.
-             * \param crr_block_idx The block index..
-             */
-            void extract_file(const std::string &path, const uint32_t idx, uint16_t crr_blck_idx);
-
             explicit ss_interpreter();
             explicit ss_interpreter(common::ro_stream *stream,
                 io_system *io,
@@ -115,9 +165,7 @@ namespace eka2l1 {
 
             bool interpret(sis_controller *controller, const std::uint16_t base_data_idx, std::atomic<int> &progress);
             
-            bool interpret(std::atomic<int> &progress) {
-                return interpret(main_controller, 0, progress); 
-            }
+            bool interpret(std::atomic<int> &progress);
         };
     }
 }
@@ -65,6 +65,7 @@ namespace eka2l1::manager {
         config_file_emit_single(emitter, "log-passed", log_passed);
         config_file_emit_single(emitter, "log-exports", log_exports);
         config_file_emit_single(emitter, "log-code", log_code);
+        config_file_emit_single(emitter, "profile-svc", profile_svc);
         config_file_emit_single(emitter, "enable-breakpoint-script", enable_breakpoint_script);
         config_file_emit_vector(emitter, "force-load", force_load_modules);
         config_file_emit_single(emitter, "cpu", cpu_backend);
@@ -88,6 +89,10 @@ namespace eka2l1::manager {
         config_file_emit_single(emitter, "enable-srv-akn-skin", enable_srv_akn_skin);
         config_file_emit_single(emitter, "enable-srv-cdl", enable_srv_cdl);
         config_file_emit_single(emitter, "fbs-enable-compression-queue", fbs_enable_compression_queue);
+        config_file_emit_single(emitter, "ui-fps-limit", ui_fps_limit);
+        config_file_emit_single(emitter, "audio-backend", audio_backend);
+        config_file_emit_single(emitter, "audio-dump-path", audio_dump_path);
+        config_file_emit_single(emitter, "hle-server-workers", hle_server_workers);
 
         emitter << YAML::EndMap;
         
@@ -116,6 +121,7 @@ namespace eka2l1::manager {
         get_yaml_value(node, "log-passed", &log_passed, false);
         get_yaml_value(node, "log-exports", &log_exports, false);
         get_yaml_value(node, "log-code", &log_code, false);
+        get_yaml_value(node, "profile-svc", &profile_svc, false);
         get_yaml_value(node, "enable-breakpoint-script", &enable_breakpoint_script, false);
         get_yaml_value(node, "cpu", &cpu_backend, 0);
         get_yaml_value(node, "device", &device, 0);
@@ -138,6 +144,10 @@ namespace eka2l1::manager {
         get_yaml_value(node, "enable-srv-akn-skin", &enable_srv_akn_skin, true);
         get_yaml_value(node, "enable-srv-cdl", &enable_srv_cdl, true);
         get_yaml_value(node, "fbs-enable-compression-queue", &fbs_enable_compression_queue, false);
+        get_yaml_value(node, "ui-fps-limit", &ui_fps_limit, 60);
+        get_yaml_value(node, "audio-backend", &audio_backend, "cubeb");
+        get_yaml_value(node, "audio-dump-path", &audio_dump_path, "");
+        get_yaml_value(node, "hle-server-workers", &hle_server_workers, 0);
 
         try {
             YAML::Node force_loads_node = node["force-load"];
@@ -241,7 +241,14 @@ namespace eka2l1 {
                     interpreter.choose_lang = choose_lang;
                 }
                 
-                interpreter.interpret(progress);
+                if (!interpreter.interpret(progress)) {
+                    // Don't leave a package behind that is only partly on the drive
+                    delete_files_and_bucket(res.controller.info.uid.uid);
+                    LOG_ERROR("Installation of {} failed", common::ucs2_to_utf8(path));
+
+                    return false;
+                }
+
                 install_controller(&res.controller, drive);
             } else {
                 package_info de_info;
@@ -21,6 +21,7 @@
 #include <common/algorithm.h>
 #include <common/buffer.h>
 #include <common/cvt.h>
+#include <common/fileutils.h>
 #include <common/flate.h>
 #include <common/log.h>
 #include <common/path.h>
@@ -33,6 +34,10 @@
 
 #include <miniz.h>
 
+#include <algorithm>
+#include <thread>
+#include <unordered_set>
+
 namespace eka2l1 {
     namespace loader {
         std::string get_install_path(const std::u16string &pseudo_path, drive_number drv) {
@@ -85,8 +90,12 @@ namespace eka2l1 {
 
             compressed.compressed_data.resize(us);
 
-            data_stream->seek(compressed.offset, common::seek_where::beg);
-            data_stream->read(&compressed.compressed_data[0], us);
+            {
+                const std::lock_guard<std::mutex> guard(data_stream_lock);
+
+                data_stream->seek(compressed.offset, common::seek_where::beg);
+                data_stream->read(&compressed.compressed_data[0], us);
+            }
 
             if (compressed.algorithm == sis_compressed_algorithm::none) {
                 return compressed.compressed_data;
@@ -110,94 +119,221 @@ namespace eka2l1 {
             return compressed.uncompressed_data;
         }
 
-        // Assuming this file is small since it's stored in std::vector
-        // Directly write this
-        void extract_file_with_buf(const std::string &path, std::vector<uint8_t> &data) {
-            std::string rp = eka2l1::file_directory(path);
-            eka2l1::create_directories(rp);
+        enum {
+            EXTRACT_READ_CHUNK_SIZE = 0x10000,
+            EXTRACT_INFLATE_CHUNK_SIZE = 0x40000
+        };
 
-            LOG_INFO("Write to: {}", path);
-
-            FILE *temp = fopen(path.c_str(), "wb");
-            fwrite(data.data(), 1, data.size(), temp);
-
-            fclose(temp);
-        }
+        bool ss_interpreter::extract_file_data(const std::string &path, const uint32_t idx, uint16_t crr_blck_idx) {
+            sis_data_unit *data_unit = reinterpret_cast<sis_data_unit *>(install_data->data_units.fields[crr_blck_idx].get());
+            sis_file_data *data = reinterpret_cast<sis_file_data *>(data_unit->data_unit.fields[idx].get());
 
-        void ss_interpreter::extract_file(const std::string &path, const uint32_t idx, uint16_t crr_blck_idx) {
-            std::string rp = eka2l1::file_directory(path);
-            eka2l1::create_directories(rp);
+            const sis_compressed &compressed = data->raw_data;
+            const bool deflated = (compressed.algorithm == sis_compressed_algorithm::deflated);
 
             FILE *file = fopen(path.c_str(), "wb");
 
-            sis_data_unit *data_unit = reinterpret_cast<sis_data_unit *>(install_data->data_units.fields[crr_blck_idx].get());
-            sis_file_data *data = reinterpret_cast<sis_file_data *>(data_unit->data_unit.fields[idx].get());
-
-            sis_compressed compressed = data->raw_data;
+            if (!file) {
+                LOG_ERROR("Can't open {} for writing, skipping this file", path);
+                return false;
+            }
 
             std::uint64_t left = ((compressed.len_low) | (static_cast<std::uint64_t>(compressed.len_high) << 32)) - 12;
-            data_stream->seek(compressed.offset, common::seek_where::beg);
-
-            std::vector<unsigned char> temp_chunk;
-            temp_chunk.resize(CHUNK_SIZE);
+            std::uint64_t offset = compressed.offset;
 
+            std::vector<unsigned char> temp_chunk(EXTRACT_READ_CHUNK_SIZE);
             std::vector<unsigned char> temp_inflated_chunk;
-            temp_inflated_chunk.resize(CHUNK_MAX_INFLATED_SIZE);
 
-            mz_stream stream;
+            mz_stream stream{};
 
-            stream.zalloc = nullptr;
-            stream.zfree = nullptr;
+            if (deflated) {
+                temp_inflated_chunk.resize(EXTRACT_INFLATE_CHUNK_SIZE);
 
-            if (compressed.algorithm == sis_compressed_algorithm::deflated) {
                 if (inflateInit(&stream) != MZ_OK) {
                     LOG_ERROR("Can not intialize inflate stream");
+                    fclose(file);
+
+                    return false;
                 }
             }
 
-            std::uint32_t total_inflated_size = 0;
+            std::uint64_t total_inflated_size = 0;
+            bool result = true;
+            bool stream_end = false;
+
+            while (left > 0 && !stream_end) {
+                const std::uint32_t grab = static_cast<std::uint32_t>(left < EXTRACT_READ_CHUNK_SIZE ? left : EXTRACT_READ_CHUNK_SIZE);
+
+                {
+                    const std::lock_guard<std::mutex> guard(data_stream_lock);
 
-            while (left > 0) {
-                std::fill(temp_chunk.begin(), temp_chunk.end(), 0);
-                int grab = static_cast<int>(left < CHUNK_SIZE ? left : CHUNK_SIZE);
+                    data_stream->seek(offset, common::seek_where::beg);
+                    data_stream->read(&temp_chunk[0], grab);
 
-                data_stream->read(&temp_chunk[0], grab);
+                    if (!data_stream->valid()) {
+                        LOG_ERROR("Stream fail, skipping this file, should report to developers.");
+                        result = false;
 
-                if (!data_stream->valid()) {
-                    LOG_ERROR("Stream fail, skipping this file, should report to developers.");
-                    return;
+                        break;
+                    }
                 }
 
-                if (compressed.algorithm == sis_compressed_algorithm::deflated) {
-                    uint32_t inflated_size = 0;
+                if (deflated) {
+                    stream.next_in = temp_chunk.data();
+                    stream.avail_in = grab;
 
-                    auto res = flate::inflate_data(&stream, temp_chunk.data(), temp_inflated_chunk.data(), grab, &inflated_size);
+                    // A chunk may inflate to more than the output buffer holds, drain it until
+                    // the input is consumed
+                    do {
+                        stream.next_out = temp_inflated_chunk.data();
+                        stream.avail_out = static_cast<unsigned int>(temp_inflated_chunk.size());
 
-                    if (!res) {
-                        LOG_ERROR("Uncompress failed! Report to developers");
-                        return;
-                    }
+                        const int res = inflate(&stream, MZ_NO_FLUSH);
 
-                    fwrite(temp_inflated_chunk.data(), 1, inflated_size, file);
-                    total_inflated_size += inflated_size;
+                        if (res != MZ_OK && res != MZ_STREAM_END && res != MZ_BUF_ERROR) {
+                            LOG_ERROR("Uncompress failed ({})! Report to developers", mz_error(res));
+                            result = false;
+
+                            break;
+                        }
+
+                        const std::size_t inflated_size = temp_inflated_chunk.size() - stream.avail_out;
+                        fwrite(temp_inflated_chunk.data(), 1, inflated_size, file);
+
+                        total_inflated_size += inflated_size;
+                        stream_end = (res == MZ_STREAM_END);
+
+                        if (res == MZ_BUF_ERROR) {
+                            break;
+                        }
+                    } while (!stream_end && (stream.avail_in > 0 || stream.avail_out == 0));
+
+                    if (!result) {
+                        break;
+                    }
                 } else {
                     fwrite(temp_chunk.data(), 1, grab, file);
                 }
 
                 left -= grab;
+                offset += grab;
+
+                if (progress_handle && total_bytes) {
+                    const std::uint64_t processed = (processed_bytes += grab);
+                    *progress_handle = static_cast<int>(common::min<std::uint64_t>(processed * 100 / total_bytes, 99));
+                }
             }
 
-            if (compressed.algorithm == sis_compressed_algorithm::deflated) {
-                if (total_inflated_size != compressed.uncompressed_size) {
+            if (deflated) {
+                if (result && total_inflated_size != compressed.uncompressed_size) {
                     LOG_ERROR("Sanity check failed: Total inflated size not equal to specified uncompress size "
                               "in SISCompressed ({} vs {})!",
                         total_inflated_size, compressed.uncompressed_size);
+
+                    // A short or corrupted stream must not be installed as if it was whole
+                    result = false;
                 }
 
                 inflateEnd(&stream);
             }
 
             fclose(file);
+            return result;
+        }
+
+        void merge_sis_extract_jobs(std::vector<sis_extract_job> &jobs) {
+            std::unordered_set<std::string> seen_paths;
+            std::vector<sis_extract_job> merged;
+
+            // Walk from the back, the last job for a path is the one whose data would stay
+            for (auto ite = jobs.rbegin(); ite != jobs.rend(); ite++) {
+                if (seen_paths.insert(common::lowercase_string(ite->path)).second) {
+                    merged.push_back(std::move(*ite));
+                }
+            }
+
+            std::reverse(merged.begin(), merged.end());
+            jobs = std::move(merged);
+        }
+
+        std::size_t run_sis_extract_jobs(std::vector<sis_extract_job> &jobs,
+            const std::function<bool(const sis_extract_job &)> &extract) {
+            std::atomic<std::size_t> next_job{ 0 };
+            std::atomic<std::size_t> total_failed{ 0 };
+
+            auto worker_func = [&]() {
+                for (std::size_t i = next_job++; i < jobs.size(); i = next_job++) {
+                    // Each job is only touched by the worker that took it
+                    jobs[i].extracted = extract(jobs[i]);
+
+                    if (!jobs[i].extracted) {
+                        total_failed++;
+                    }
+                }
+            };
+
+            const std::size_t total_workers = common::min<std::size_t>(jobs.size(),
+                common::max<std::size_t>(std::thread::hardware_concurrency(), 1));
+
+            std::vector<std::thread> workers;
+
+            for (std::size_t i = 1; i < total_workers; i++) {
+                workers.emplace_back(worker_func);
+            }
+
+            // The calling thread takes part as well
+            worker_func();
+
+            for (std::thread &worker : workers) {
+                worker.join();
+            }
+
+            return total_failed;
+        }
+
+        bool ss_interpreter::flush_extracts(std::atomic<int> &progress) {
+            if (pending_extracts.empty()) {
+                return true;
+            }
+
+            std::vector<sis_extract_job> jobs = std::move(pending_extracts);
+            pending_extracts.clear();
+
+            // Two workers writing the same file at once would interleave their data
+            merge_sis_extract_jobs(jobs);
+
+            // Directories are made up front, so workers never race on creating the same one
+            for (const sis_extract_job &job : jobs) {
+                eka2l1::create_directories(eka2l1::file_directory(job.path));
+            }
+
+            const std::size_t total_failed = run_sis_extract_jobs(jobs, [this](const sis_extract_job &job) {
+                return extract_file_data(job.path, job.idx, job.blck_idx);
+            });
+
+            // Finish in script order
+            for (sis_extract_job &job : jobs) {
+                const std::string lowered_path = common::lowercase_string(job.path);
+
+                if (!job.extracted) {
+                    LOG_ERROR("Failed to extract {}, not installing it", lowered_path);
+                    common::remove(job.path);
+
+                    continue;
+                }
+
+                if (FOUND_STR(lowered_path.find(".sis")) || FOUND_STR(lowered_path.find(".sisx"))) {
+                    LOG_INFO("Detected an SmartInstaller SIS, path at: {}", lowered_path);
+                    mngr->install_package(common::utf8_to_ucs2(lowered_path), drive_c, progress);
+                }
+
+                LOG_INFO("EOpInstall: {}", lowered_path);
+
+                // Add to bucket
+                mngr->add_to_file_bucket(current_controller->info.uid.uid, job.install_path);
+            }
+
+            return (total_failed == 0);
         }
 
         static bool is_expression_integral_type(const ss_expr_op op) {
@@ -401,7 +537,34 @@ namespace eka2l1 {
             return interpret(controller->install_block, progress, base_data_idx + controller->idx.data_index);
         }
 
+        bool ss_interpreter::interpret(std::atomic<int> &progress) {
+            // Progress is the share of compressed file data that has been extracted
+            total_bytes = 0;
+            processed_bytes = 0;
+
+            for (auto &wrap_data_unit : install_data->data_units.fields) {
+                sis_data_unit *data_unit = reinterpret_cast<sis_data_unit *>(wrap_data_unit.get());
+
+                for (auto &wrap_file_data : data_unit->data_unit.fields) {
+                    const sis_compressed &compressed = reinterpret_cast<sis_file_data *>(wrap_file_data.get())->raw_data;
+                    total_bytes += ((compressed.len_low) | (static_cast<std::uint64_t>(compressed.len_high) << 32)) - 12;
+                }
+            }
+
+            progress_handle = &progress;
+            progress = 0;
+
+            const bool result = interpret(main_controller, 0, progress);
+
+            progress_handle = nullptr;
+            progress = 100;
+
+            return result;
+        }
+
         bool ss_interpreter::interpret(sis_install_block &install_block, std::atomic<int> &progress, uint16_t crr_blck_idx) {
+            bool result = true;
+
             // Process file
             auto install_file = [&](sis_install_block &inst_blck, uint16_t crr_blck_idx) {
                 for (auto &wrap_file : inst_blck.files.fields) {
@@ -416,6 +579,9 @@ namespace eka2l1 {
 
                     switch (file->op) {
                     case ss_op::EOpText: {
+                        // The text may abort the install and wipe the bucket, finish what came before first
+                        result = flush_extracts(progress) && result;
+
                         auto buf = get_small_file_buf(file->idx, crr_blck_idx);
                         buf.push_back(0);
 
@@ -459,19 +625,8 @@ namespace eka2l1 {
                     case ss_op::EOpInstall:
                     case ss_op::EOpNull: {
                         if (!skip_next_file) {
-                            extract_file(raw_path, file->idx, crr_blck_idx);
-
-                            raw_path = common::lowercase_string(raw_path);
-
-                            if (FOUND_STR(raw_path.find(".sis")) || FOUND_STR(raw_path.find(".sisx"))) {
-                                LOG_INFO("Detected an SmartInstaller SIS, path at: {}", raw_path);
-                                mngr->install_package(common::utf8_to_ucs2(raw_path), drive_c, progress);
-                            }
-
-                            LOG_INFO("EOpInstall: {}", raw_path);
-
-                            // Add to bucket
-                            mngr->add_to_file_bucket(current_controller->info.uid.uid, install_path);
+                            // Extracted together with the rest of the block in flush_extracts
+                            pending_extracts.push_back({ raw_path, install_path, file->idx, crr_blck_idx });
                         } else {
                             skip_next_file = false;
                         }
@@ -486,19 +641,20 @@ namespace eka2l1 {
             };
 
             install_file(install_block, crr_blck_idx);
+            result = flush_extracts(progress) && result;
 
             // Parse if blocks
             for (auto &wrap_if_statement : install_block.if_blocks.fields) {
                 sis_if *if_stmt = (sis_if *)(wrap_if_statement.get());
 
                 if (condition_passed(wrap_if_statement.get())) {
-                    interpret(if_stmt->install_block, progress, crr_blck_idx);
+                    result = interpret(if_stmt->install_block, progress, crr_blck_idx) && result;
                 } else {
                     for (auto &wrap_else_branch : if_stmt->else_if.fields) {
                         sis_else_if *if_stmt = (sis_else_if *)(wrap_else_branch.get());
 
                         if (condition_passed(wrap_else_branch.get())) {
-                            interpret(if_stmt->install_block, progress, crr_blck_idx);
+                            result = interpret(if_stmt->install_block, progress, crr_blck_idx) && result;
                         }
                     }
                 }
@@ -506,10 +662,10 @@ namespace eka2l1 {
 
             for (auto &wrap_mini_pkg : install_block.controllers.fields) {
                 sis_controller *ctrl = (sis_controller *)(wrap_mini_pkg.get());
-                interpret(ctrl, crr_blck_idx, progress);
+                result = interpret(ctrl, crr_blck_idx, progress) && result;
             }
 
-            return true;
+            return result;
         }
     }
 }
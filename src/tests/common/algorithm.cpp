@@ -74,3 +74,14 @@ TEST_CASE("detect_diff_comp_new_bigger", "detect_changes") {
     REQUIRE(removes == std::vector<int>({ 1, 7 }));
     REQUIRE(added == std::vector<int>({ 3, 9, 13, 20 }));
 }
+
+TEST_CASE("count_leading_zero_bounds", "bits") {
+    REQUIRE(common::count_leading_zero(0) == 32);
+    REQUIRE(common::count_leading_zero(1) == 31);
+    REQUIRE(common::count_leading_zero(0x80000000) == 0);
+
+    REQUIRE(common::find_most_significant_bit_one(0) == 0);
+    REQUIRE(common::find_most_significant_bit_one(1) == 1);
+    REQUIRE(common::find_most_significant_bit_one(0x10000) == 17);
+    REQUIRE(common::find_most_significant_bit_one(0xFFFFFFFF) == 32);
+}
@@ -19,9 +19,12 @@
 
 #include <catch2/catch.hpp>
 #include <common/allocator.h>
+#include <tests/bench.h>
 
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
+#include <vector>
 
 using namespace eka2l1;
 
@@ -80,3 +83,211 @@ TEST_CASE("bitmap_alloc_best_fit_multiple_fit", "bitmap_allocator") {
     // After allocate:      1000 0111 1001 0001 0101 0001 00[00 0]001
     REQUIRE(alloc.get_word(0) == 0b10000111100100010101000100000001);
 }
+
+// Space backed by host memory, which can grow up to its capacity
+template <typename T>
+struct growable_space_allocator : public T {
+    std::size_t capacity;
+
+    explicit growable_space_allocator(std::uint8_t *data, const std::size_t initial_size, const std::size_t cap)
+        : T(data, initial_size)
+        , capacity(cap) {
+    }
+
+    bool expand(std::size_t target) override {
+        return target <= capacity;
+    }
+};
+
+TEST_CASE("tlsf_alloc_coalesce_on_free", "tlsf_allocator") {
+    std::vector<std::uint8_t> space(1024);
+    common::tlsf_allocator alloc(space.data(), space.size());
+
+    std::uint8_t *a = reinterpret_cast<std::uint8_t *>(alloc.allocate(256));
+    std::uint8_t *b = reinterpret_cast<std::uint8_t *>(alloc.allocate(256));
+    std::uint8_t *c = reinterpret_cast<std::uint8_t *>(alloc.allocate(256));
+
+    REQUIRE(a == space.data());
+    REQUIRE(b == a + 256);
+    REQUIRE(c == b + 256);
+
+    REQUIRE(alloc.free(a));
+    REQUIRE(alloc.free(c));
+    REQUIRE_FALSE(alloc.free(c));
+
+    common::allocator_stats stats = alloc.get_stats();
+    REQUIRE(stats.used_blocks == 1);
+    REQUIRE(stats.free_blocks == 2);
+    REQUIRE(stats.largest_free_block == 512);
+    REQUIRE(stats.fragmentation() > 0.0);
+
+    // The middle block joins both of its neighbours
+    REQUIRE(alloc.free(b));
+
+    stats = alloc.get_stats();
+    REQUIRE(stats.free_blocks == 1);
+    REQUIRE(stats.free_bytes == 1024);
+    REQUIRE(stats.largest_free_block == 1024);
+    REQUIRE(stats.fragmentation() == 0.0);
+
+    REQUIRE(alloc.allocate(1024) == space.data());
+    REQUIRE(alloc.allocate(8) == nullptr);
+}
+
+TEST_CASE("tlsf_alloc_expand", "tlsf_allocator") {
+    std::vector<std::uint8_t> space(0x10000);
+    growable_space_allocator<common::tlsf_allocator> alloc(space.data(), 0, space.size());
+
+    std::uint8_t *a = reinterpret_cast<std::uint8_t *>(alloc.allocate(100));
+    REQUIRE(a == space.data());
+    REQUIRE(alloc.get_max_size() >= 104);
+
+    // Bigger than what is committed, but still fits in the capacity
+    std::uint8_t *b = reinterpret_cast<std::uint8_t *>(alloc.allocate(0x8000));
+    REQUIRE(b == a + 104);
+    REQUIRE(alloc.get_max_size() <= space.size());
+
+    REQUIRE(alloc.allocate(0x10000) == nullptr);
+}
+
+static std::uint32_t next_trace_random(std::uint32_t &seed) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) & 0xFFFFFF;
+}
+
+struct trace_op {
+    bool alloc;
+    std::size_t slot;
+    std::size_t size;
+};
+
+// Mimic the large chunk: a bunch of bitmaps that get loaded, resized and released
+static std::vector<trace_op> make_bitmap_trace(const std::size_t total_ops, const std::size_t total_slots) {
+    std::vector<trace_op> ops;
+    std::vector<bool> live(total_slots, false);
+    std::uint32_t seed = 0x1234;
+
+    for (std::size_t i = 0; i < total_ops; i++) {
+        const std::size_t slot = next_trace_random(seed) % total_slots;
+        const std::uint32_t kind = next_trace_random(seed) % 8;
+
+        std::size_t size = 0;
+
+        if (kind < 5) {
+            // Icons and glyphs
+            size = 16 + next_trace_random(seed) % 2048;
+        } else if (kind < 7) {
+            size = 4096 + next_trace_random(seed) % 32768;
+        } else {
+            // Full screen buffers
+            size = 65536 + next_trace_random(seed) % 196608;
+        }
+
+        ops.push_back({ !live[slot], slot, size });
+        live[slot] = !live[slot];
+    }
+
+    return ops;
+}
+
+template <typename T>
+static bool replay_trace(T &alloc, const std::vector<trace_op> &ops, const std::size_t total_slots) {
+    std::vector<void *> slots(total_slots, nullptr);
+
+    for (const trace_op &op : ops) {
+        if (op.alloc) {
+            slots[op.slot] = alloc.allocate(op.size);
+
+            if (!slots[op.slot]) {
+                return false;
+            }
+        } else {
+            if (!alloc.free(slots[op.slot])) {
+                return false;
+            }
+
+            slots[op.slot] = nullptr;
+        }
+    }
+
+    return true;
+}
+
+TEST_CASE("tlsf_alloc_no_overlap", "tlsf_allocator") {
+    constexpr std::size_t TOTAL_SLOTS = 64;
+    constexpr std::size_t SPACE_SIZE = 0x2000000;
+
+    std::vector<std::uint8_t> space(SPACE_SIZE);
+    growable_space_allocator<common::tlsf_allocator> alloc(space.data(), 0, space.size());
+
+    const std::vector<trace_op> ops = make_bitmap_trace(4000, TOTAL_SLOTS);
+    std::vector<std::uint8_t *> slots(TOTAL_SLOTS, nullptr);
+    std::vector<std::size_t> sizes(TOTAL_SLOTS, 0);
+
+    for (const trace_op &op : ops) {
+        if (op.alloc) {
+            slots[op.slot] = reinterpret_cast<std::uint8_t *>(alloc.allocate(op.size));
+            sizes[op.slot] = op.size;
+
+            REQUIRE(slots[op.slot]);
+            std::memset(slots[op.slot], static_cast<int>(op.slot), op.size);
+        } else {
+            // Nobody else scribbled over this block while it was alive
+            bool intact = true;
+
+            for (std::size_t i = 0; i < sizes[op.slot]; i++) {
+                intact = intact && (slots[op.slot][i] == static_cast<std::uint8_t>(op.slot));
+            }
+
+            REQUIRE(intact);
+
+            REQUIRE(alloc.free(slots[op.slot]));
+            slots[op.slot] = nullptr;
+        }
+    }
+
+    for (std::size_t i = 0; i < TOTAL_SLOTS; i++) {
+        if (slots[i]) {
+            REQUIRE(alloc.free(slots[i]));
+        }
+    }
+
+    const common::allocator_stats stats = alloc.get_stats();
+    REQUIRE(stats.used_blocks == 0);
+    REQUIRE(stats.free_blocks == 1);
+    REQUIRE(stats.free_bytes == alloc.get_max_size());
+}
+
+TEST_CASE("replay_bitmap_trace_200k", "[.benchmark]") {
+    constexpr std::size_t TOTAL_SLOTS = 256;
+    constexpr std::size_t TOTAL_OPS = 200000;
+    constexpr std::size_t SPACE_SIZE = 0x8000000;
+
+    const std::vector<trace_op> ops = make_bitmap_trace(TOTAL_OPS, TOTAL_SLOTS);
+    std::vector<std::uint8_t> space(SPACE_SIZE);
+
+    {
+        growable_space_allocator<common::tlsf_allocator> alloc(space.data(), 0, space.size());
+
+        const std::int64_t elapsed = test::measure_us([&]() {
+            REQUIRE(replay_trace(alloc, ops, TOTAL_SLOTS));
+        });
+
+        const common::allocator_stats stats = alloc.get_stats();
+
+        WARN("TLSF: replayed " << TOTAL_OPS << " ops in " << elapsed << " us, space used "
+                               << alloc.get_max_size() << " bytes, fragmentation " << stats.fragmentation());
+    }
+
+    {
+        growable_space_allocator<common::block_allocator> alloc(space.data(), 0, space.size());
+
+        bool done = false;
+        const std::int64_t elapsed = test::measure_us([&]() {
+            done = replay_trace(alloc, ops, TOTAL_SLOTS);
+        });
+
+        WARN("Block: " << (done ? "replayed " : "ran out of space after ") << TOTAL_OPS << " ops in "
+                       << elapsed << " us, space used " << alloc.get_max_size() << " bytes");
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <common/pacer.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace eka2l1;
+
+TEST_CASE("pacer_caps_rate", "pacer") {
+    common::frame_pacer pacer(100);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // The first frame starts the schedule, the next ten are due every 10 ms
+    for (int i = 0; i <= 10; i++) {
+        pacer.wait();
+    }
+
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(95));
+}
+
+TEST_CASE("pacer_uncapped", "pacer") {
+    common::frame_pacer pacer(0);
+
+    for (int i = 0; i < 1000; i++) {
+        REQUIRE(!pacer.wait());
+    }
+}
+
+TEST_CASE("pacer_late_frame_no_burst", "pacer") {
+    common::frame_pacer pacer(100);
+    pacer.wait();
+
+    // Miss several frames, the next ones should be paced again instead of rushed
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE(!pacer.wait());
+    REQUIRE(pacer.wait());
+}
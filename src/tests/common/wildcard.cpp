@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <common/wildcard.h>
+
+using namespace eka2l1;
+
+TEST_CASE("wildcard_matcher_fast_paths", "wildcard") {
+    const common::wildcard_matcher everything("*");
+    REQUIRE(everything.match(""));
+    REQUIRE(everything.match("Anything.rsc"));
+
+    const common::wildcard_matcher literal("Ecom.SPI");
+    REQUIRE(literal.match("ecom.spi"));
+    REQUIRE_FALSE(literal.match("ecom.spix"));
+
+    const common::wildcard_matcher prefix("ecom*");
+    REQUIRE(prefix.match("ECOM-1-0.s01"));
+    REQUIRE(prefix.match("ecom"));
+    REQUIRE_FALSE(prefix.match("eco"));
+
+    const common::wildcard_matcher suffix("*.RSC");
+    REQUIRE(suffix.match("plugin.rsc"));
+    REQUIRE(suffix.match(".rsc"));
+    REQUIRE_FALSE(suffix.match("plugin.r01"));
+}
+
+TEST_CASE("wildcard_matcher_generic", "wildcard") {
+    const common::wildcard_matcher archive("ecom-*-*.s*");
+    REQUIRE(archive.match("ecom-1-0.spi"));
+    REQUIRE(archive.match("ECOM-2-1.S01"));
+    REQUIRE_FALSE(archive.match("ecom-1.spi"));
+
+    const common::wildcard_matcher single("*.r??");
+    REQUIRE(single.match("sample.r01"));
+    REQUIRE_FALSE(single.match("sample.rsc1"));
+
+    // No regex meaning is given to any character
+    const common::wildcard_matcher plain("a+(b).[c]");
+    REQUIRE(plain.match("A+(B).[C]"));
+    REQUIRE_FALSE(plain.match("aa(b).c"));
+}
+
+TEST_CASE("wildcard_matcher_case_sensitive", "wildcard") {
+    const common::wildcard_matcher matcher("*.RSC", true);
+    REQUIRE(matcher.match("PLUGIN.RSC"));
+    REQUIRE_FALSE(matcher.match("plugin.rsc"));
+
+    const common::wildcard_matcher generic("P?ug*.RSC", true);
+    REQUIRE(generic.match("Plug01.RSC"));
+    REQUIRE_FALSE(generic.match("plug01.RSC"));
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <epoc/ipc.h>
+
+#include <array>
+
+using namespace eka2l1;
+
+TEST_CASE("msg_queue_fifo", "ipc_msg_queue") {
+    std::array<ipc_msg, 3> msgs;
+    ipc_msg_queue queue;
+
+    for (ipc_msg &msg : msgs) {
+        queue.push_back(&msg);
+        REQUIRE(queue.contains(&msg));
+    }
+
+    REQUIRE(queue.pop_front() == &msgs[0]);
+    REQUIRE_FALSE(queue.contains(&msgs[0]));
+
+    REQUIRE(queue.pop_front() == &msgs[1]);
+    REQUIRE(queue.pop_front() == &msgs[2]);
+
+    REQUIRE(queue.empty());
+    REQUIRE(queue.pop_front() == nullptr);
+}
+
+TEST_CASE("msg_queue_remove_and_cancel", "ipc_msg_queue") {
+    std::array<ipc_msg, 4> msgs;
+    ipc_msg_queue queue;
+    ipc_msg_queue other_queue;
+
+    for (ipc_msg &msg : msgs) {
+        queue.push_back(&msg);
+    }
+
+    // Take one out of the middle, the rest stay linked
+    queue.remove(&msgs[1]);
+    REQUIRE_FALSE(queue.contains(&msgs[1]));
+
+    other_queue.push_back(&msgs[1]);
+    REQUIRE(other_queue.contains(&msgs[1]));
+    REQUIRE_FALSE(queue.contains(&msgs[1]));
+
+    // Cancel drops the newest
+    REQUIRE(queue.pop_back() == &msgs[3]);
+
+    REQUIRE(queue.pop_front() == &msgs[0]);
+    REQUIRE(queue.pop_front() == &msgs[2]);
+    REQUIRE(queue.empty());
+
+    other_queue.clear();
+    REQUIRE(other_queue.empty());
+    REQUIRE(msgs[1].queued_in == nullptr);
+}
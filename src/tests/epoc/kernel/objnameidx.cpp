@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <common/wildcard.h>
+#include <epoc/kernel/object_name_index.h>
+#include <tests/bench.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace eka2l1;
+
+class test_kernel_obj : public kernel::kernel_obj {
+public:
+    explicit test_kernel_obj(const std::string &name, const kernel::uid id, const kernel::object_type type)
+        : kernel::kernel_obj(nullptr, nullptr) {
+        obj_name = name;
+        uid = id;
+        obj_type = type;
+    }
+};
+
+TEST_CASE("find_exact_case_and_type", "object_name_index") {
+    test_kernel_obj mut1("MyLock", 1, kernel::object_type::mutex);
+    test_kernel_obj mut2("mylock", 2, kernel::object_type::mutex);
+    test_kernel_obj sema("MyLock", 3, kernel::object_type::sema);
+
+    kernel::object_name_index index;
+    index.add(&mut1);
+    index.add(&mut2);
+    index.add(&sema);
+
+    REQUIRE(index.size() == 3);
+    REQUIRE(index.find("MyLock", kernel::object_type::mutex) == &mut1);
+    REQUIRE(index.find("mylock", kernel::object_type::mutex) == &mut2);
+    REQUIRE(index.find("MyLock", kernel::object_type::sema) == &sema);
+    REQUIRE(index.find("MYLOCK", kernel::object_type::mutex) == nullptr);
+
+    int folded_count = 0;
+    index.for_each_folded_match("MYLOCK", kernel::object_type::mutex, [&](kernel::kernel_obj *) {
+        folded_count++;
+    });
+
+    REQUIRE(folded_count == 2);
+
+    REQUIRE(index.remove(&mut1));
+    REQUIRE_FALSE(index.remove(&mut1));
+    REQUIRE(index.find("MyLock", kernel::object_type::mutex) == nullptr);
+    REQUIRE(index.size() == 2);
+}
+
+TEST_CASE("find_lowest_uid_on_duplicate", "object_name_index") {
+    test_kernel_obj late("Worker", 20, kernel::object_type::thread);
+    test_kernel_obj early("Worker", 10, kernel::object_type::thread);
+
+    kernel::object_name_index index;
+    index.add(&late);
+    index.add(&early);
+
+    REQUIRE(index.find("Worker", kernel::object_type::thread) == &early);
+}
+
+TEST_CASE("match_wildcard_symbian_style", "object_name_index") {
+    REQUIRE(common::match_wildcard(std::string("Process::Main"), std::string("*::main"), false));
+    REQUIRE(common::match_wildcard(std::string("Process::Main"), std::string("Proc?ss*"), false));
+    REQUIRE_FALSE(common::match_wildcard(std::string("Process::Main"), std::string("*::main"), true));
+    REQUIRE_FALSE(common::match_wildcard(std::string("Process"), std::string("Process?"), false));
+    REQUIRE(common::match_wildcard(std::string(""), std::string("*"), false));
+}
+
+TEST_CASE("lookup_50k_objects", "[.benchmark]") {
+    constexpr kernel::uid TOTAL_OBJECTS = 50000;
+
+    std::vector<std::unique_ptr<test_kernel_obj>> objects;
+    objects.reserve(TOTAL_OBJECTS);
+
+    kernel::object_name_index index;
+
+    const std::int64_t create_time = test::measure_us([&]() {
+        for (kernel::uid i = 0; i < TOTAL_OBJECTS; i++) {
+            objects.push_back(std::make_unique<test_kernel_obj>("Object" + std::to_string(i), i,
+                (i % 2) ? kernel::object_type::chunk : kernel::object_type::mutex));
+            index.add(objects.back().get());
+        }
+    });
+
+    const std::int64_t lookup_time = test::measure_us([&]() {
+        for (kernel::uid i = 0; i < TOTAL_OBJECTS; i++) {
+            const kernel::object_type type = (i % 2) ? kernel::object_type::chunk : kernel::object_type::mutex;
+            REQUIRE(index.find("Object" + std::to_string(i), type) == objects[i].get());
+        }
+    });
+
+    WARN("Indexed " << TOTAL_OBJECTS << " objects in " << create_time << " us, looked all of them up in "
+                    << lookup_time << " us");
+}
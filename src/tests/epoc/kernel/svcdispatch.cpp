@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <epoc/kernel/libmanager.h>
+
+using namespace eka2l1;
+
+static void svc_stub_first(eka2l1::system *) {
+}
+
+static void svc_stub_second(eka2l1::system *) {
+}
+
+TEST_CASE("svc_dispatch_index_range", "svc_dispatch") {
+    // Slow calls first, then fast calls
+    REQUIRE(hle::svc_dispatch_index(0x00) == 0);
+    REQUIRE(hle::svc_dispatch_index(0xFF) == 0xFF);
+    REQUIRE(hle::svc_dispatch_index(0x800000) == hle::SVC_DISPATCH_CLASS_SIZE);
+    REQUIRE(hle::svc_dispatch_index(0x8000FF) == hle::SVC_DISPATCH_TABLE_SIZE - 1);
+
+    REQUIRE(hle::svc_dispatch_index(0x100) == -1);
+    REQUIRE(hle::svc_dispatch_index(0x800100) == -1);
+    REQUIRE(hle::svc_dispatch_index(0x400000) == -1);
+    REQUIRE(hle::svc_dispatch_index(0xFFFFFFFF) == -1);
+}
+
+TEST_CASE("svc_register_and_unregistered_calls", "svc_dispatch") {
+    hle::lib_manager mngr;
+
+    hle::func_map funcs;
+    funcs.emplace(0x10, hle::epoc_import_func{ svc_stub_first, "First" });
+    funcs.emplace(0x800010, hle::epoc_import_func{ svc_stub_first, "FastFirst" });
+    funcs.emplace(0x100, hle::epoc_import_func{ svc_stub_first, "OutOfRange" });
+
+    mngr.register_svcs(funcs);
+
+    // Ordinals that can't be indexed are not registered at all
+    REQUIRE(mngr.svc_funcs.size() == 2);
+    REQUIRE(mngr.svc_funcs.find(0x100) == mngr.svc_funcs.end());
+
+    // Registering an ordinal again keeps the first function
+    hle::func_map again;
+    again.emplace(0x10, hle::epoc_import_func{ svc_stub_second, "Second" });
+    mngr.register_svcs(again);
+
+    REQUIRE(mngr.svc_funcs[0x10].func == svc_stub_first);
+    REQUIRE(mngr.svc_funcs[0x10].name == "First");
+
+    // Neither unregistered nor out of range ordinals are dispatched
+    REQUIRE_FALSE(mngr.call_svc(0x11));
+    REQUIRE_FALSE(mngr.call_svc(0x800011));
+    REQUIRE_FALSE(mngr.call_svc(0x100));
+    REQUIRE_FALSE(mngr.call_svc(0xFFFFFFFF));
+}
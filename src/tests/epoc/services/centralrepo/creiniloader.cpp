@@ -21,6 +21,9 @@
 #include <catch2/catch.hpp>
 #include <epoc/services/centralrepo/centralrepo.h>
 
+#include <common/fileutils.h>
+#include <common/path.h>
+
 #include <iostream>
 
 using namespace eka2l1;
@@ -60,4 +63,30 @@ TEST_CASE("ini_loader_meta_default_and_range", "centralrepo") {
 
     REQUIRE(e1->metadata_val == 10);
     REQUIRE(e2->metadata_val == 12);
-}
\ No newline at end of file
+}
+
+TEST_CASE("ini_loader_compiled_cache", "centralrepo") {
+    const std::string cache_folder = "centralrepocache/";
+    eka2l1::create_directories(cache_folder);
+
+    // First load parses and compiles, second one loads the compiled form
+    for (int i = 0; i < 2; i++) {
+        central_repo repo;
+        repo.uid = 0xEFFF0000;
+
+        REQUIRE(load_centrep_ini_cached("centralrepoassets/EFFF0000.ini", cache_folder, repo));
+        REQUIRE(repo.entries.size() == 3);
+        REQUIRE(repo.owner_uid == 0x20004C4D);
+
+        central_repo_entry *e2 = repo.find_entry(13);
+        central_repo_entry *e3 = repo.find_entry(78);
+
+        REQUIRE(e2);
+        REQUIRE(e3);
+
+        REQUIRE(e2->data.etype == central_repo_entry_type::real);
+        REQUIRE(e2->data.reald == 5.7);
+        REQUIRE(e3->data.strd == "pew");
+        REQUIRE(e3->metadata_val == 12);
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <epoc/services/centralrepo/cre.h>
+
+#include <common/chunkyseri.h>
+#include <tests/bench.h>
+
+#include <fstream>
+
+using namespace eka2l1;
+
+static central_repo_entry_variant make_int_variant(const std::uint64_t val) {
+    central_repo_entry_variant var;
+    var.etype = central_repo_entry_type::integer;
+    var.intd = val;
+
+    return var;
+}
+
+TEST_CASE("entries_stay_sorted", "centralrepo") {
+    central_repo repo;
+
+    REQUIRE(repo.add_new_entry(0x30, make_int_variant(3), 0));
+    REQUIRE(repo.add_new_entry(0x10, make_int_variant(1), 0));
+    REQUIRE(repo.add_new_entry(0x20, make_int_variant(2), 0));
+    REQUIRE_FALSE(repo.add_new_entry(0x20, make_int_variant(4), 0));
+
+    REQUIRE(repo.entries.size() == 3);
+    REQUIRE(repo.entries[0].key == 0x10);
+    REQUIRE(repo.entries[1].key == 0x20);
+    REQUIRE(repo.entries[2].key == 0x30);
+
+    REQUIRE(repo.find_entry(0x20)->data.intd == 2);
+    REQUIRE(repo.find_entry(0x25) == nullptr);
+}
+
+TEST_CASE("query_entries_by_mask", "centralrepo") {
+    central_repo repo;
+
+    // The example in query_entries documentation
+    repo.add_new_entry(0x02B30B11, make_int_variant(0), 0);
+    repo.add_new_entry(0x07B10B52, make_int_variant(0), 0);
+    repo.add_new_entry(0x07B10B53, make_int_variant(0), 0);
+
+    std::vector<central_repo_entry *> matched;
+    repo.query_entries(0x03B10000, 0xF0FF0000, matched, central_repo_entry_type::integer);
+
+    REQUIRE(matched.size() == 2);
+    REQUIRE(matched[0]->key == 0x07B10B52);
+    REQUIRE(matched[1]->key == 0x07B10B53);
+
+    matched.clear();
+    repo.query_entries(0x07B10B53, 0xFFFFFFFF, matched, central_repo_entry_type::integer);
+
+    REQUIRE(matched.size() == 1);
+    REQUIRE(matched[0]->key == 0x07B10B53);
+
+    matched.clear();
+    repo.query_entries(0, 0, matched, central_repo_entry_type::real);
+
+    REQUIRE(matched.empty());
+}
+
+TEST_CASE("lookup_test_repos", "[.benchmark]") {
+    central_repo repo;
+    std::ifstream fi("centralrepoassets/101f876f.cre", std::ios::binary | std::ios::ate);
+
+    std::vector<char> buf;
+    buf.resize(fi.tellg());
+
+    fi.seekg(0, std::ios::beg);
+    fi.read(&buf[0], buf.size());
+
+    common::chunkyseri seri(reinterpret_cast<std::uint8_t *>(&buf[0]), buf.size(), common::SERI_MODE_READ);
+    do_state_for_cre(seri, repo);
+
+    REQUIRE(repo.entries.size() == 19);
+
+    constexpr int TOTAL_ROUNDS = 100000;
+    std::vector<central_repo_entry *> matched;
+    std::size_t found = 0;
+
+    const std::int64_t elapsed = eka2l1::test::measure_us([&]() {
+        for (int i = 0; i < TOTAL_ROUNDS; i++) {
+            for (const auto &entry : repo.entries) {
+                found += (repo.find_entry(entry.key) != nullptr);
+            }
+
+            matched.clear();
+            repo.query_entries(repo.entries[i % repo.entries.size()].key, 0xFFFFFF00, matched, central_repo_entry_type::none);
+            found += matched.size();
+        }
+    });
+
+    REQUIRE(found >= TOTAL_ROUNDS * (repo.entries.size() + 1));
+    WARN("Did " << TOTAL_ROUNDS * repo.entries.size() << " lookups and " << TOTAL_ROUNDS << " masked queries in "
+                << elapsed << " us");
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <common/buffer.h>
+#include <common/chunkyseri.h>
+
+#include <epoc/loader/rsc.h>
+#include <epoc/loader/spi.h>
+#include <epoc/services/ecom/registry.h>
+#include <epoc/vfs.h>
+
+#include <cstdio>
+
+static void parse_spi_into_registry(const char *spi_name, eka2l1::ecom_drive_registry &reg) {
+    eka2l1::symfile f = eka2l1::physical_file_proxy(spi_name, READ_MODE | BIN_MODE);
+    REQUIRE(f);
+
+    std::vector<std::uint8_t> buf;
+    buf.resize(f->size());
+    f->read_file(reinterpret_cast<std::uint8_t *>(&buf[0]), 1, static_cast<std::uint32_t>(buf.size()));
+
+    reg.sources.push_back({ spi_name, buf.size(), 0x1234567890ULL, true });
+    f->close();
+
+    eka2l1::common::chunkyseri seri(&buf[0], buf.size(), eka2l1::common::SERI_MODE_READ);
+    eka2l1::loader::spi_file spi(0);
+
+    REQUIRE(spi.do_state(seri));
+
+    for (auto &entry : spi.entries) {
+        eka2l1::common::ro_buf_stream stream(&entry.file[0], entry.file.size());
+        eka2l1::loader::rsc_file rsc(reinterpret_cast<eka2l1::common::ro_stream *>(&stream));
+
+        eka2l1::ecom_plugin plugin;
+        REQUIRE(eka2l1::load_plugin(rsc, plugin));
+
+        for (auto &interface : plugin.interfaces) {
+            for (auto &impl : interface.implementations) {
+                impl->drv = drive_z;
+                impl->original_name = std::u16string(entry.name.begin(), entry.name.end());
+
+                reg.entries.push_back({ interface.uid, impl, true });
+            }
+        }
+    }
+}
+
+TEST_CASE("ecom_registry_save_and_load", "ecom") {
+    eka2l1::ecom_drive_registry reg;
+    parse_spi_into_registry("loaderassets//ecom-1-0.spi", reg);
+
+    REQUIRE(reg.entries.size() > 0);
+
+    // Should not be stored, the DLL info is resolved again on instantiation
+    reg.entries[0].impl->flags |= eka2l1::ecom_implementation_info::FLAG_IMPL_CREATE_INFO_CACHED;
+
+    const std::string registry_path = "ecomregistry.ecr";
+    REQUIRE(eka2l1::save_ecom_drive_registry(registry_path, reg));
+
+    eka2l1::ecom_drive_registry loaded;
+    REQUIRE(eka2l1::load_ecom_drive_registry(registry_path, loaded));
+
+    REQUIRE(loaded.sources == reg.sources);
+    REQUIRE(loaded.entries.size() == reg.entries.size());
+
+    for (std::size_t i = 0; i < reg.entries.size(); i++) {
+        const eka2l1::ecom_implementation_info &org = *reg.entries[i].impl;
+        const eka2l1::ecom_implementation_info &got = *loaded.entries[i].impl;
+
+        REQUIRE(loaded.entries[i].interface_uid == reg.entries[i].interface_uid);
+        REQUIRE(loaded.entries[i].from_archive);
+        REQUIRE(got.uid == org.uid);
+        REQUIRE(got.version == org.version);
+        REQUIRE(got.original_name == org.original_name);
+        REQUIRE(got.display_name == org.display_name);
+        REQUIRE(got.default_data == org.default_data);
+        REQUIRE(got.opaque_data == org.opaque_data);
+        REQUIRE(got.drv == drive_z);
+        REQUIRE(got.extended_interfaces == org.extended_interfaces);
+        REQUIRE(got.flags == (org.flags & ~eka2l1::ecom_implementation_info::FLAG_IMPL_CREATE_INFO_CACHED));
+        REQUIRE(!(got.flags & eka2l1::ecom_implementation_info::FLAG_IMPL_CREATE_INFO_CACHED));
+    }
+
+    std::remove(registry_path.c_str());
+}
+
+TEST_CASE("ecom_registry_reject_truncated", "ecom") {
+    eka2l1::ecom_drive_registry reg;
+    parse_spi_into_registry("loaderassets//ecom-1-0.spi", reg);
+
+    const std::string registry_path = "ecomregistrytrunc.ecr";
+    REQUIRE(eka2l1::save_ecom_drive_registry(registry_path, reg));
+
+    // Cut the trailing magic
+    {
+        std::FILE *f = std::fopen(registry_path.c_str(), "rb");
+        std::vector<char> data(4096);
+        const std::size_t total = std::fread(&data[0], 1, data.size(), f);
+        std::fclose(f);
+
+        f = std::fopen(registry_path.c_str(), "wb");
+        std::fwrite(&data[0], 1, total - 2, f);
+        std::fclose(f);
+    }
+
+    eka2l1::ecom_drive_registry loaded;
+    REQUIRE(!eka2l1::load_ecom_drive_registry(registry_path, loaded));
+    REQUIRE(loaded.entries.empty());
+
+    std::remove(registry_path.c_str());
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <common/allocator.h>
+#include <epoc/services/fbs/glyph_cache.h>
+
+#include <vector>
+
+static eka2l1::epoc::glyph_cache_key make_glyph_key(const std::uint32_t code, const float scale = 1.0f) {
+    static const int fake_face = 0;
+    return { &fake_face, 0, scale, scale, code };
+}
+
+static const eka2l1::epoc::glyph_cache_entry *add_fake_glyph(eka2l1::epoc::glyph_cache &cache, const std::uint32_t code,
+    const int size, const float scale = 1.0f) {
+    std::vector<std::uint8_t> bitmap(size * size, static_cast<std::uint8_t>(code));
+
+    eka2l1::epoc::open_font_character_metric metric {};
+    metric.horizontal_advance = static_cast<std::int16_t>(size);
+
+    return cache.add(make_glyph_key(code, scale), bitmap.data(), size, size,
+        eka2l1::epoc::antialised_glyph_bitmap, metric);
+}
+
+TEST_CASE("glyph_cache_hit_and_miss", "fbs") {
+    std::vector<std::uint8_t> arena(0x10000);
+    eka2l1::common::block_allocator alloc(arena.data(), arena.size());
+    eka2l1::epoc::glyph_cache cache(&alloc, 0x10000);
+
+    REQUIRE(!cache.get(make_glyph_key('A')));
+    REQUIRE(add_fake_glyph(cache, 'A', 10));
+
+    const eka2l1::epoc::glyph_cache_entry *entry = cache.get(make_glyph_key('A'));
+
+    REQUIRE(entry);
+    REQUIRE(entry->width == 10);
+    REQUIRE(entry->height == 10);
+    REQUIRE(entry->metric.horizontal_advance == 10);
+    REQUIRE(entry->bitmap >= arena.data());
+    REQUIRE(entry->bitmap < arena.data() + arena.size());
+    REQUIRE(entry->bitmap[99] == 'A');
+
+    // Same glyph at another size is another entry
+    REQUIRE(!cache.get(make_glyph_key('A', 2.0f)));
+    REQUIRE(cache.used_bytes() == 100);
+}
+
+TEST_CASE("glyph_cache_evict_least_recently_used", "fbs") {
+    std::vector<std::uint8_t> arena(0x10000);
+    eka2l1::common::block_allocator alloc(arena.data(), arena.size());
+
+    // Room for three 16x16 glyphs
+    eka2l1::epoc::glyph_cache cache(&alloc, 3 * 16 * 16);
+
+    REQUIRE(add_fake_glyph(cache, 'A', 16));
+    REQUIRE(add_fake_glyph(cache, 'B', 16));
+    REQUIRE(add_fake_glyph(cache, 'C', 16));
+
+    // Touch A, so B is now the least recently used
+    REQUIRE(cache.get(make_glyph_key('A')));
+    REQUIRE(add_fake_glyph(cache, 'D', 16));
+
+    REQUIRE(cache.count() == 3);
+    REQUIRE(cache.get(make_glyph_key('A')));
+    REQUIRE(!cache.get(make_glyph_key('B')));
+    REQUIRE(cache.get(make_glyph_key('C')));
+    REQUIRE(cache.get(make_glyph_key('D'))->bitmap[0] == 'D');
+
+    // Bigger than the whole budget
+    REQUIRE(!add_fake_glyph(cache, 'E', 64));
+
+    cache.clear();
+    REQUIRE(cache.count() == 0);
+    REQUIRE(cache.used_bytes() == 0);
+}
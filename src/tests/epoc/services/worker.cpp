@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <epoc/services/worker.h>
+#include <epoc/timing.h>
+
+#include <future>
+#include <vector>
+
+using namespace eka2l1;
+
+TEST_CASE("jobs_keep_order_on_worker", "server_worker_pool") {
+    service::server_worker_pool pool(2);
+    const std::size_t worker = pool.assign();
+
+    std::vector<int> handled;
+    std::promise<void> all_handled;
+
+    for (int i = 0; i < 1000; i++) {
+        // Only this worker touches the list until the last job is done
+        pool.post(worker, [&, i]() {
+            handled.push_back(i);
+
+            if (i == 999) {
+                all_handled.set_value();
+            }
+        });
+    }
+
+    all_handled.get_future().wait();
+    REQUIRE(handled.size() == 1000);
+
+    bool in_order = true;
+
+    for (int i = 0; i < 1000; i++) {
+        in_order = in_order && (handled[i] == i);
+    }
+
+    REQUIRE(in_order);
+}
+
+TEST_CASE("workers_assigned_in_turn", "server_worker_pool") {
+    service::server_worker_pool pool(3);
+
+    REQUIRE(pool.assign() == 0);
+    REQUIRE(pool.assign() == 1);
+    REQUIRE(pool.assign() == 2);
+    REQUIRE(pool.assign() == 0);
+}
+
+TEST_CASE("completions_from_worker_run_on_emulation_thread", "server_worker_pool") {
+    timing_system timing;
+    timing.init();
+
+    service::emulation_call_queue calls;
+    calls.init(&timing, "testHostCalls");
+
+    std::vector<int> completed;
+    std::promise<void> all_posted;
+
+    {
+        service::server_worker_pool pool(1);
+        const std::size_t worker = pool.assign();
+
+        for (int i = 0; i < 3; i++) {
+            // Same as a request completed by a server on its worker
+            pool.post(worker, [&, i]() {
+                calls.post([&completed, i]() {
+                    completed.push_back(i);
+                });
+
+                if (i == 2) {
+                    all_posted.set_value();
+                }
+            });
+        }
+
+        all_posted.get_future().wait();
+    }
+
+    // Nothing is completed until the emulation thread advances time
+    REQUIRE(completed.empty());
+
+    timing.add_ticks(static_cast<std::uint32_t>(timing.get_downcount()));
+    timing.advance();
+
+    REQUIRE(completed == std::vector<int>{ 0, 1, 2 });
+    timing.shutdown();
+}
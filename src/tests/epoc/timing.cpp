@@ -1,18 +1,14 @@
+#include <common/chunkyseri.h>
 #include <epoc/timing.h>
 
 #include <catch2/catch.hpp>
+#include <tests/bench.h>
+
 #include <cstdint>
+#include <vector>
 
 using namespace eka2l1;
 
-void timed_io_callback(uint64_t time_delay) {
-    FILE *f = fopen("test_register.txt", "w");
-    const char *fo = "ur mom nice";
-
-    fwrite(fo, 1, 12, f);
-    fclose(f);
-}
-
 void timed_nop_callback(uint64_t time_delay) {
     // NOP
 }
@@ -41,15 +37,151 @@ TEST_CASE("basic_scheduling", "timing_test") {
     eka2l1::timing_system timing;
     scope_guard guard(timing);
 
-    auto ioevt = timing.register_event("testIOEvent", std::bind(timed_io_callback, std::placeholders::_1));
+    auto ioevt = timing.register_event("testIOEvent", std::bind(timed_nop_callback, std::placeholders::_1));
     auto nopevt = timing.register_event("testNonEvent", std::bind(timed_nop_callback, std::placeholders::_1));
 
     // Schedule: make sure those are executed correctly
-    // No order, because the core timing of EKA2L1 doesn't use
-    // a priority queue
     timing.schedule_event(25000, ioevt);
     timing.schedule_event(300, nopevt);
 
     advance_and_check(timing, 5000);
     advance_and_check(timing, 20000);
-}
\ No newline at end of file
+}
+
+TEST_CASE("ordered_dispatch_and_cancel", "timing_test") {
+    eka2l1::timing_system timing;
+    scope_guard guard(timing);
+
+    std::vector<std::uint64_t> fired;
+    auto evt = timing.register_event("testOrderEvent", [&](std::uint64_t userdata, int) {
+        fired.push_back(userdata);
+    });
+
+    timing.schedule_event(3000, evt, 3);
+    timing.schedule_event(1000, evt, 1);
+    timing.schedule_event(2000, evt, 2);
+    timing.schedule_event(2000, evt, 4);
+    timing.schedule_event(1500, evt, 5);
+
+    timing.unschedule_event(evt, 5);
+    timing.schedule_event_thread_safe(0, evt, 6);
+
+    timing.add_ticks(static_cast<std::uint32_t>(timing.get_downcount()));
+    timing.advance();
+
+    // Same due time keeps the schedule order
+    REQUIRE(fired == std::vector<std::uint64_t>{ 1, 2, 4, 3, 6 });
+}
+
+TEST_CASE("remove_all_events_of_type", "timing_test") {
+    eka2l1::timing_system timing;
+    scope_guard guard(timing);
+
+    std::vector<std::uint64_t> fired;
+    auto record = [&](std::uint64_t userdata, int) {
+        fired.push_back(userdata);
+    };
+
+    auto kept_evt = timing.register_event("testKeptEvent", record);
+    auto removed_evt = timing.register_event("testRemovedEvent", record);
+
+    // Heap is [1, 10, 2, 11, 12, 3]. Removing from the back sifts 3 up and pushes the
+    // unvisited 10 down into a slot that was already walked past.
+    timing.schedule_event(1, kept_evt, 1);
+    timing.schedule_event(10, removed_evt, 10);
+    timing.schedule_event(2, kept_evt, 2);
+    timing.schedule_event(11, removed_evt, 11);
+    timing.schedule_event(12, kept_evt, 12);
+    timing.schedule_event(3, kept_evt, 3);
+
+    timing.remove_all_events(removed_evt);
+
+    timing.add_ticks(static_cast<std::uint32_t>(timing.get_downcount()));
+    timing.advance();
+
+    REQUIRE(fired == std::vector<std::uint64_t>{ 1, 2, 3, 12 });
+}
+
+TEST_CASE("state_keeps_pending_events_in_future", "timing_test") {
+    std::vector<std::uint64_t> fired;
+    std::vector<std::uint8_t> state;
+
+    auto record = [&](std::uint64_t userdata, int) {
+        fired.push_back(userdata);
+    };
+
+    {
+        eka2l1::timing_system timing;
+        scope_guard guard(timing);
+
+        auto evt = timing.register_event("testStateEvent", record);
+
+        // Saved events are not restored, this one should never fire
+        timing.schedule_event(50000, evt, 100);
+
+        timing.add_ticks(static_cast<std::uint32_t>(timing.get_downcount()));
+        timing.advance();
+        timing.add_ticks(static_cast<std::uint32_t>(timing.get_downcount()));
+        timing.advance();
+
+        common::chunkyseri measurer(nullptr, 0, common::SERI_MODE_MEASURE);
+        timing.do_state(measurer);
+
+        state.resize(measurer.size());
+
+        common::chunkyseri writer(&state[0], state.size(), common::SERI_MODE_WRITE);
+        timing.do_state(writer);
+    }
+
+    eka2l1::timing_system timing;
+    scope_guard guard(timing);
+
+    auto evt = timing.register_event("testStateEvent", record);
+    timing.schedule_event(1000, evt, 1);
+    timing.schedule_event(2000, evt, 2);
+
+    common::chunkyseri reader(&state[0], state.size(), common::SERI_MODE_READ);
+    timing.do_state(reader);
+
+    REQUIRE(timing.get_ticks() == 40000);
+    REQUIRE(timing.get_downcount() == 1000);
+
+    timing.add_ticks(999);
+    timing.advance();
+
+    REQUIRE(fired.empty());
+
+    timing.add_ticks(static_cast<std::uint32_t>(timing.get_downcount()));
+    timing.advance();
+
+    REQUIRE(fired == std::vector<std::uint64_t>{ 1 });
+
+    timing.add_ticks(static_cast<std::uint32_t>(timing.get_downcount()));
+    timing.advance();
+
+    REQUIRE(fired == std::vector<std::uint64_t>{ 1, 2 });
+}
+
+TEST_CASE("schedule_cancel_100k", "[.benchmark]") {
+    eka2l1::timing_system timing;
+    scope_guard guard(timing);
+
+    constexpr std::uint64_t TOTAL_EVENTS = 100000;
+    auto evt = timing.register_event("testBenchEvent", [](std::uint64_t, int) {});
+
+    const std::int64_t elapsed = eka2l1::test::measure_us([&]() {
+        for (std::uint64_t i = 0; i < TOTAL_EVENTS; i++) {
+            timing.schedule_event(static_cast<std::int64_t>((i * 7919) % 100000) + 1000, evt, i);
+        }
+
+        for (std::uint64_t i = 0; i < TOTAL_EVENTS; i++) {
+            timing.unschedule_event(evt, i);
+        }
+    });
+
+    WARN("Scheduled and cancelled " << TOTAL_EVENTS << " events in " << elapsed << " us");
+    timing.add_ticks(static_cast<std::uint32_t>(timing.get_downcount()));
+    timing.advance();
+
+    REQUIRE(timing.get_downcount() == MAX_SLICE_LENGTH);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project 
+ * (see bentokun.github.com/EKA2L1).
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <common/chunkyseri.h>
+#include <epoc/utils/savestate.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct fake_state {
+    std::string name;
+    std::vector<std::uint32_t> memory;
+
+    bool do_state(eka2l1::common::chunkyseri &seri) {
+        seri.absorb(name);
+        seri.absorb_container(memory);
+
+        return true;
+    }
+};
+
+// Read into a staging copy, and only copy it over when the load succeeds
+static bool load_fake_state(const std::string &path, fake_state &target) {
+    fake_state staged;
+
+    return eka2l1::load_state(path, [&](eka2l1::common::chunkyseri &seri) { return staged.do_state(seri); },
+        [&]() { target = staged; });
+}
+
+TEST_CASE("savestate_save_and_load", "savestate") {
+    fake_state org;
+    org.name = "Snapshot";
+    org.memory.resize(0x40000);
+
+    for (std::size_t i = 0; i < org.memory.size(); i++) {
+        org.memory[i] = static_cast<std::uint32_t>(i * 2654435761U);
+    }
+
+    const std::string first_path = "savestate1.ekss";
+    const std::string second_path = "savestate2.ekss";
+
+    {
+        eka2l1::state_saver saver;
+        REQUIRE(saver.save(first_path, [&](eka2l1::common::chunkyseri &seri) { return org.do_state(seri); }));
+
+        // Changes after save returns must not leak into the queued state
+        org.memory[0] = 0xDEADBEEF;
+        REQUIRE(saver.save(second_path, [&](eka2l1::common::chunkyseri &seri) { return org.do_state(seri); }));
+
+        saver.wait();
+    }
+
+    fake_state loaded;
+    REQUIRE(load_fake_state(first_path, loaded));
+    REQUIRE(loaded.name == org.name);
+    REQUIRE(loaded.memory.size() == org.memory.size());
+    REQUIRE(loaded.memory[0] == 0);
+    REQUIRE(std::equal(loaded.memory.begin() + 1, loaded.memory.end(), org.memory.begin() + 1));
+
+    REQUIRE(load_fake_state(second_path, loaded));
+    REQUIRE(loaded.memory == org.memory);
+
+    std::remove(first_path.c_str());
+    std::remove(second_path.c_str());
+}
+
+TEST_CASE("savestate_reject_truncated", "savestate") {
+    fake_state org;
+    org.name = "Truncated";
+    org.memory.resize(0x100, 0x12345678);
+
+    const std::string path = "savestatetrunc.ekss";
+
+    {
+        eka2l1::state_saver saver;
+        REQUIRE(saver.save(path, [&](eka2l1::common::chunkyseri &seri) { return org.do_state(seri); }));
+    }
+
+    // Cut the trailing magic
+    {
+        std::FILE *f = std::fopen(path.c_str(), "rb");
+        std::vector<char> data(4096);
+        const std::size_t total = std::fread(&data[0], 1, data.size(), f);
+        std::fclose(f);
+
+        f = std::fopen(path.c_str(), "wb");
+        std::fwrite(&data[0], 1, total - 2, f);
+        std::fclose(f);
+    }
+
+    bool called = false;
+    REQUIRE(!eka2l1::load_state(path, [&](eka2l1::common::chunkyseri &seri) { return called = true; },
+        [&]() { called = true; }));
+    REQUIRE(!called);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("savestate_not_applied_on_mismatch", "savestate") {
+    fake_state org;
+    org.name = "Mismatch";
+    org.memory.resize(0x100, 0x12345678);
+
+    const std::string path = "savestatemismatch.ekss";
+
+    {
+        eka2l1::state_saver saver;
+        REQUIRE(saver.save(path, [&](eka2l1::common::chunkyseri &seri) { return org.do_state(seri); }));
+    }
+
+    bool applied = false;
+
+    // A reader that stops early, or that rejects what it reads, must not get its state applied
+    REQUIRE(!eka2l1::load_state(path, [&](eka2l1::common::chunkyseri &seri) {
+        std::string name;
+        seri.absorb(name);
+
+        return true;
+    }, [&]() { applied = true; }));
+
+    REQUIRE(!eka2l1::load_state(path, [&](eka2l1::common::chunkyseri &seri) { return false; },
+        [&]() { applied = true; }));
+
+    REQUIRE(!applied);
+
+    std::remove(path.c_str());
+}
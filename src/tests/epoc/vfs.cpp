@@ -1,8 +1,16 @@
 #include <catch2/catch.hpp>
 #include <common/algorithm.h>
+#include <common/cvt.h>
 #include <common/path.h>
 #include <common/types.h>
 #include <epoc/vfs.h>
+#include <tests/bench.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
 
 struct io_scope_guard {
     eka2l1::io_system *io;
@@ -42,3 +50,99 @@ TEST_CASE("get_physical", "vfs") {
     REQUIRE(eka2l1::common::compare_ignore_case(*actual_path_b, std::u16string(u"drive_b") + static_cast<char16_t>(eka2l1::get_separator()) 
         + u"despacito3leak") == 0);
 }
+
+static std::vector<std::string> create_dir_with_files(const std::string &dir, const std::vector<std::string> &names) {
+    eka2l1::create_directories(dir);
+    std::vector<std::string> created;
+
+    for (const std::string &name : names) {
+        const std::string path = eka2l1::add_path(dir, name);
+        std::ofstream f(path, std::ios::binary);
+        f << name;
+
+        created.push_back(path);
+    }
+
+    return created;
+}
+
+TEST_CASE("dir_iterate_wildcard_filter", "vfs") {
+    eka2l1::io_system io;
+    io_scope_guard guard(io);
+
+    const std::vector<std::string> files = create_dir_with_files("drive_d_iterate/plugins",
+        { "first.rsc", "second.rsc", "third.r01", "fourth.txt" });
+
+    io.mount_physical_path(drive_number::drive_d, drive_media::physical, io_attrib::internal,
+        u"drive_d_iterate");
+
+    auto dir = io.open_dir(u"D:\\Plugins\\*.R*", io_attrib::none);
+    REQUIRE(dir);
+
+    std::vector<std::string> found;
+
+    while (auto entry = dir->get_next_entry()) {
+        // Metadata comes from the iterator, and must match what a separate lookup gives
+        const auto info = io.get_entry_info(eka2l1::common::utf8_to_ucs2(entry->full_path));
+
+        REQUIRE(info);
+        REQUIRE(entry->size == entry->name.length());
+        REQUIRE(entry->size == info->size);
+        REQUIRE(entry->last_write == info->last_write);
+
+        found.push_back(entry->name);
+    }
+
+    std::sort(found.begin(), found.end());
+    REQUIRE(found == std::vector<std::string>{ "first.rsc", "second.rsc", "third.r01" });
+
+    for (const std::string &file : files) {
+        std::remove(file.c_str());
+    }
+}
+
+TEST_CASE("dir_iterate_100k_entries", "[.benchmark]") {
+    constexpr int TOTAL_FILES = 100000;
+
+    std::vector<std::string> names;
+    names.reserve(TOTAL_FILES);
+
+    for (int i = 0; i < TOTAL_FILES; i++) {
+        names.push_back("entry" + std::to_string(i) + ((i % 4) ? ".dat" : ".rsc"));
+    }
+
+    eka2l1::io_system io;
+    io_scope_guard guard(io);
+
+    const std::vector<std::string> files = create_dir_with_files("drive_e_bench/import", names);
+
+    io.mount_physical_path(drive_number::drive_e, drive_media::physical, io_attrib::internal,
+        u"drive_e_bench");
+
+    const auto iterate = [&](const std::u16string &pattern) {
+        auto dir = io.open_dir(pattern, io_attrib::none);
+        REQUIRE(dir);
+
+        int total = 0;
+
+        while (auto entry = dir->get_next_entry()) {
+            total++;
+        }
+
+        return total;
+    };
+
+    const std::int64_t all_time = eka2l1::test::measure_us([&]() {
+        REQUIRE(iterate(u"E:\\import\\*") == TOTAL_FILES);
+    });
+
+    const std::int64_t filtered_time = eka2l1::test::measure_us([&]() {
+        REQUIRE(iterate(u"E:\\import\\Entry*.R?C") == TOTAL_FILES / 4);
+    });
+
+    WARN("Iterated " << TOTAL_FILES << " entries in " << all_time << " us, filtered them in " << filtered_time << " us");
+
+    for (const std::string &file : files) {
+        std::remove(file.c_str());
+    }
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace eka2l1::test {
+    /**
+     * \brief Time one step of a benchmark.
+     * 
+     * Benchmarks are tagged "[.benchmark]", so they only run when asked for.
+     * 
+     * \param func The step to time.
+     * \returns Microseconds the step took, on the steady clock.
+     */
+    template <typename F>
+    std::int64_t measure_us(F func) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+
+        return static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <manager/sis_script_interpreter.h>
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace eka2l1;
+
+static loader::sis_extract_job make_extract_job(const std::string &path, const std::uint32_t idx) {
+    loader::sis_extract_job job;
+    job.path = path;
+    job.install_path = path;
+    job.idx = idx;
+    job.blck_idx = 0;
+
+    return job;
+}
+
+TEST_CASE("extract_jobs_merged_by_path", "sis_extract") {
+    std::vector<loader::sis_extract_job> jobs = {
+        make_extract_job("drive/sys/bin/app.exe", 0),
+        make_extract_job("drive/resource/app.rsc", 1),
+        make_extract_job("drive/sys/bin/APP.exe", 2),
+        make_extract_job("drive/resource/app.mif", 3)
+    };
+
+    loader::merge_sis_extract_jobs(jobs);
+
+    // The last job for a path wins, the rest keep their order
+    REQUIRE(jobs.size() == 3);
+    REQUIRE(jobs[0].idx == 1);
+    REQUIRE(jobs[1].idx == 2);
+    REQUIRE(jobs[2].idx == 3);
+}
+
+TEST_CASE("extract_jobs_report_failures", "sis_extract") {
+    std::vector<loader::sis_extract_job> jobs;
+
+    for (std::uint32_t i = 0; i < 64; i++) {
+        jobs.push_back(make_extract_job("drive/file" + std::to_string(i), i));
+    }
+
+    std::mutex ran_lock;
+    std::set<std::uint32_t> ran;
+
+    const std::size_t total_failed = loader::run_sis_extract_jobs(jobs, [&](const loader::sis_extract_job &job) {
+        {
+            const std::lock_guard<std::mutex> guard(ran_lock);
+            ran.insert(job.idx);
+        }
+
+        return (job.idx % 8) != 0;
+    });
+
+    REQUIRE(ran.size() == jobs.size());
+    REQUIRE(total_failed == 8);
+
+    bool flags_match = true;
+
+    for (const loader::sis_extract_job &job : jobs) {
+        flags_match = flags_match && (job.extracted == ((job.idx % 8) != 0));
+    }
+
+    REQUIRE(flags_match);
+}